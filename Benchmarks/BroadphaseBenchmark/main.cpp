@@ -0,0 +1,247 @@
+// How the physics scales from 100 to 50k bodies. Moving spheres at a constant density (so every
+// body has about the same number of neighbours whatever the count) go through, per frame:
+//   tree       refitting the DynamicAABBTree and querying it for every body, the broadphase
+//   all pairs  testing every pair of bounds, what the old registry scan did, skipped above
+//              --all-pairs-limit bodies as it grows with the square of the count
+//   step       a whole BuiltinPhysicsBackend step without gravity
+//
+// BroadphaseBenchmark [--counts 100,1000,...] [--frames N] [--all-pairs-limit N] [--threads N]
+
+#include "../../Engine/core/job_system.h"
+#include "../../Engine/data/components.h"
+#include "../../Engine/physics/builtin_physics_backend.h"
+#include "../../Engine/physics/dynamic_aabb_tree.h"
+#include "../../Engine/physics/shapes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+    struct Options {
+        std::vector<u32> body_counts = {100, 500, 1000, 5000, 10000, 50000};
+        u32 frame_count = 30;
+        u32 all_pairs_limit = 10000;
+        u32 thread_count = 0; // 0 uses every hardware thread
+    };
+
+    std::vector<u32> parse_counts(const std::string &list) {
+        std::vector<u32> counts;
+        usize begin = 0;
+        while (begin < list.size()) {
+            usize end = list.find(',', begin);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+            const u32 count = static_cast<u32>(std::strtoul(list.substr(begin, end - begin).c_str(), nullptr, 10));
+            if (count > 0) {
+                counts.push_back(count);
+            }
+            begin = end + 1;
+        }
+        return counts;
+    }
+
+    Options parse_options(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (argument == "--counts" && has_value) {
+                options.body_counts = parse_counts(argv[++i]);
+            } else if (argument == "--frames" && has_value) {
+                options.frame_count = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else if (argument == "--all-pairs-limit" && has_value) {
+                options.all_pairs_limit = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--threads" && has_value) {
+                options.thread_count = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            } else {
+                throw std::runtime_error("usage: BroadphaseBenchmark [--counts 100,1000,...] [--frames N] [--all-pairs-limit N] [--threads N]");
+            }
+        }
+
+        if (options.body_counts.empty()) {
+            throw std::runtime_error("no body counts given");
+        }
+        return options;
+    }
+
+    f64 median(std::vector<f64> times) {
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    // the same values every run, between -1 and 1
+    f32 pseudo_random(u32 i, u32 axis) {
+        u32 x = i * 747796405u + axis * 2891336453u;
+        x ^= x >> 16;
+        x *= 0x45d9f3bu;
+        x ^= x >> 16;
+        return static_cast<f32>(x & 0xffffu) / 32767.5f - 1.0f;
+    }
+
+    constexpr f32 radius = 0.5f;
+    constexpr f32 delta_time = 1.0f / 60.0f;
+    constexpr f32 volume_per_body = 8.0f; // a 2 unit cube for every sphere of radius 0.5
+
+    struct Bodies {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> velocities;
+
+        explicit Bodies(u32 count) : positions(count), velocities(count) {
+            const f32 half_extent = 0.5f * std::cbrt(volume_per_body * static_cast<f32>(count));
+            for (u32 i = 0; i < count; i++) {
+                positions[i] = glm::vec3{pseudo_random(i, 0), pseudo_random(i, 1), pseudo_random(i, 2)} * half_extent;
+                velocities[i] = glm::vec3{pseudo_random(i, 3), pseudo_random(i, 4), pseudo_random(i, 5)} * 3.0f;
+            }
+        }
+
+        void move() {
+            for (usize i = 0; i < positions.size(); i++) {
+                positions[i] += velocities[i] * delta_time;
+            }
+        }
+
+        AABB get_bounds(usize i) const { return {positions[i] - glm::vec3{radius}, positions[i] + glm::vec3{radius}}; }
+    };
+
+    // ms per frame and the pairs of the last frame
+    std::pair<f64, u64> run_tree(u32 count, u32 frame_count) {
+        Bodies bodies{count};
+        DynamicAABBTree tree;
+        std::vector<i32> proxies(count);
+        for (u32 i = 0; i < count; i++) {
+            proxies[i] = tree.create_proxy(bodies.get_bounds(i), static_cast<entt::entity>(i));
+        }
+
+        std::vector<f64> times;
+        u64 pair_count = 0;
+        for (u32 frame = 0; frame < frame_count; frame++) {
+            bodies.move();
+
+            auto start = std::chrono::steady_clock::now();
+            for (u32 i = 0; i < count; i++) {
+                tree.move_proxy(proxies[i], bodies.get_bounds(i), bodies.velocities[i] * delta_time);
+            }
+
+            pair_count = 0;
+            for (u32 i = 0; i < count; i++) {
+                tree.query(tree.get_fat_aabb(proxies[i]), [&](i32 proxy) {
+                    // every pair once
+                    if (proxy > proxies[i]) {
+                        pair_count++;
+                    }
+                    return true;
+                });
+            }
+            auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+        return {median(std::move(times)), pair_count};
+    }
+
+    std::pair<f64, u64> run_all_pairs(u32 count, u32 frame_count) {
+        Bodies bodies{count};
+
+        std::vector<f64> times;
+        u64 pair_count = 0;
+        for (u32 frame = 0; frame < frame_count; frame++) {
+            bodies.move();
+
+            auto start = std::chrono::steady_clock::now();
+            pair_count = 0;
+            for (u32 i = 0; i < count; i++) {
+                const AABB bounds = bodies.get_bounds(i);
+                for (u32 j = i + 1; j < count; j++) {
+                    if (bounds.overlaps(bodies.get_bounds(j))) {
+                        pair_count++;
+                    }
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+        return {median(std::move(times)), pair_count};
+    }
+
+    f64 run_step(u32 count, u32 frame_count) {
+        Bodies bodies{count};
+        // the backend keeps pointers to the shapes, the components have to outlive it
+        std::vector<PhysicsComponent> components(count);
+        BuiltinPhysicsBackend backend;
+
+        for (u32 i = 0; i < count; i++) {
+            const auto entity = static_cast<entt::entity>(i);
+            TransformComponent tn;
+            tn.translation = bodies.positions[i];
+            PhysicsComponent &ph = components[i];
+            ph.shape = std::make_unique<Sphere>(radius);
+            ph.inverse_mass = 1.0f;
+            ph.elasticity = 0.5f;
+            ph.linear_velocity = bodies.velocities[i];
+
+            backend.add_body(entity);
+            backend.sync_body(entity, tn, ph, true);
+        }
+
+        std::vector<f64> times;
+        for (u32 frame = 0; frame < frame_count; frame++) {
+            auto start = std::chrono::steady_clock::now();
+            backend.step(delta_time, glm::vec3{0.0f});
+            auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+        return median(std::move(times));
+    }
+
+    int run(const Options &options) {
+        std::printf("median ms per frame, %u frames, %u threads\n", options.frame_count, JobSystem::get_thread_count());
+        std::printf("%8s %10s %10s %12s %10s\n", "bodies", "pairs", "tree", "all pairs", "step");
+
+        for (u32 count : options.body_counts) {
+            auto [tree_time, pair_count] = run_tree(count, options.frame_count);
+            const f64 step_time = run_step(count, options.frame_count);
+
+            if (count <= options.all_pairs_limit) {
+                auto [all_pairs_time, all_pairs_count] = run_all_pairs(count, options.frame_count);
+                // the tree pairs come from the fat bounds, there can only be more of them
+                if (all_pairs_count > pair_count) {
+                    throw std::runtime_error("the tree missed pairs at " + std::to_string(count) + " bodies");
+                }
+                std::printf("%8u %10llu %10.3f %12.3f %10.3f\n", count, static_cast<unsigned long long>(pair_count), tree_time, all_pairs_time, step_time);
+            } else {
+                std::printf("%8u %10llu %10.3f %12s %10.3f\n", count, static_cast<unsigned long long>(pair_count), tree_time, "-", step_time);
+            }
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    int result = 0;
+
+    try {
+        Options options = parse_options(argc, argv);
+        // the calling thread takes part, a single thread needs no workers at all
+        if (options.thread_count != 1) {
+            JobSystem::init(options.thread_count > 1 ? options.thread_count - 1 : 0);
+        }
+        result = run(options);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        result = -1;
+    }
+
+    JobSystem::shutdown();
+    return result;
+}
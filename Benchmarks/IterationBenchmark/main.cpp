@@ -0,0 +1,138 @@
+// Compares walking every entity and probing its components through Entity, like the systems used
+// to, with the typed views and the owning groups Scene sets up. Every pass gathers the lights the
+// way update_lights_ubo does, on a scene where only a few entities have a light.
+//
+// IterationBenchmark [--entities N] [--lights N] [--repeat N]
+
+#include "../../Engine/data/components.h"
+#include "../../Engine/data/entity.h"
+#include "../../Engine/data/scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+    struct Options {
+        u32 entity_count = 100000;
+        u32 light_count = 2000;
+        u32 repeat = 100;
+    };
+
+    Options parse_options(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (argument == "--entities" && has_value) {
+                options.entity_count = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else if (argument == "--lights" && has_value) {
+                options.light_count = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--repeat" && has_value) {
+                options.repeat = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else {
+                throw std::runtime_error("usage: IterationBenchmark [--entities N] [--lights N] [--repeat N]");
+            }
+        }
+
+        options.light_count = std::min(options.light_count, options.entity_count);
+        return options;
+    }
+
+    // microseconds of the fastest and the median pass
+    void print_timings(const char *name, std::vector<f64> times) {
+        std::sort(times.begin(), times.end());
+        std::printf("%-7s min %9.1f us  median %9.1f us\n", name, times.front(), times[times.size() / 2]);
+    }
+
+    // the result is printed, so the compiler can't drop the passes
+    struct Result {
+        glm::vec3 sum{0.0f};
+        u32 count = 0;
+
+        void add(const TransformComponent &tc, const PointLightComponent &light) {
+            sum += tc.translation * light.intensity;
+            count++;
+        }
+    };
+
+    template<typename Pass>
+    std::vector<f64> measure(u32 repeat, Result &result, Pass &&pass) {
+        std::vector<f64> times;
+        for (u32 i = 0; i < repeat; i++) {
+            result = {};
+            auto start = std::chrono::steady_clock::now();
+            pass(result);
+            auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<f64, std::micro>(end - start).count());
+        }
+        return times;
+    }
+
+    int run(const Options &options) {
+        Scene scene;
+
+        // spread out, the lights don't sit next to each other in the entity list
+        const u32 light_every = options.light_count > 0 ? options.entity_count / options.light_count : options.entity_count + 1;
+        for (u32 i = 0; i < options.entity_count; i++) {
+            Entity entity = scene.create_entity();
+            entity.get_component<TransformComponent>().translation = {static_cast<f32>(i), 0.0f, 0.0f};
+            if (i % light_every == 0 && scene.view<PointLightComponent>().size() < options.light_count) {
+                entity.add_component<PointLightComponent>();
+            }
+        }
+
+        // every entity has an IDComponent, walking its storage visits them all like registry.each did
+        Result probe_result;
+        auto probe_times = measure(options.repeat, probe_result, [&](Result &result) {
+            scene.view<IDComponent>().each([&](auto entity_id, IDComponent &) {
+                Entity entity = {entity_id, &scene};
+                if (entity.has_component<PointLightComponent>()) {
+                    result.add(entity.get_component<TransformComponent>(), entity.get_component<PointLightComponent>());
+                }
+            });
+        });
+
+        Result view_result;
+        auto view_times = measure(options.repeat, view_result, [&](Result &result) {
+            scene.view<PointLightComponent, TransformComponent>().each([&](PointLightComponent &light, TransformComponent &tc) {
+                result.add(tc, light);
+            });
+        });
+
+        Result group_result;
+        auto group_times = measure(options.repeat, group_result, [&](Result &result) {
+            scene.group<PointLightComponent>(entt::get<TransformComponent>).each([&](PointLightComponent &light, TransformComponent &tc) {
+                result.add(tc, light);
+            });
+        });
+
+        if (probe_result.count != view_result.count || probe_result.count != group_result.count) {
+            throw std::runtime_error("the iteration styles visited different entities");
+        }
+
+        std::printf("%u entities, %u lights, checksum %.1f\n", options.entity_count, group_result.count,
+                    static_cast<f64>(probe_result.sum.x + view_result.sum.x + group_result.sum.x));
+        print_timings("probe", probe_times);
+        print_timings("view", view_times);
+        print_timings("group", group_times);
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        return run(parse_options(argc, argv));
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+}
@@ -0,0 +1,169 @@
+// How the JobSystem scales from 1 to N threads. For every thread count it times:
+//   parallel_for  a compute heavy loop over --elements elements with the automatic grain
+//   tiny jobs     --jobs empty jobs on one counter, what scheduling a job costs
+//   nested        a binary tree of jobs where every job runs its two children and waits on them,
+//                 so the threads only get work by stealing it
+// The speedup is against the single thread run, which runs everything inline.
+//
+// JobSystemBenchmark [--max-threads N] [--elements N] [--jobs N] [--depth N] [--repeat N]
+
+#include "../../Engine/core/job_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+    struct Options {
+        u32 max_thread_count = 0; // 0 goes up to every hardware thread
+        u32 element_count = 1 << 20;
+        u32 job_count = 100000;
+        u32 depth = 14;
+        u32 repeat = 10;
+    };
+
+    Options parse_options(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (argument == "--max-threads" && has_value) {
+                options.max_thread_count = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--elements" && has_value) {
+                options.element_count = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else if (argument == "--jobs" && has_value) {
+                options.job_count = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else if (argument == "--depth" && has_value) {
+                options.depth = std::min(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 20u);
+            } else if (argument == "--repeat" && has_value) {
+                options.repeat = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else {
+                throw std::runtime_error("usage: JobSystemBenchmark [--max-threads N] [--elements N] [--jobs N] [--depth N] [--repeat N]");
+            }
+        }
+
+        if (options.max_thread_count == 0) {
+            options.max_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        return options;
+    }
+
+    // the median run in milliseconds
+    template<typename Pass>
+    f64 measure(u32 repeat, Pass &&pass) {
+        std::vector<f64> times;
+        for (u32 i = 0; i < repeat; i++) {
+            auto start = std::chrono::steady_clock::now();
+            pass();
+            auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    // a few hundred flops per element, enough that the loop isn't bound by memory
+    f32 compute(u32 i) {
+        f32 x = static_cast<f32>(i) * 0.001f;
+        for (u32 k = 0; k < 64; k++) {
+            x = std::sin(x) * 0.5f + std::cos(x * 1.5f);
+        }
+        return x;
+    }
+
+    void run_tree(u32 depth) {
+        if (depth == 0) {
+            return;
+        }
+
+        JobCounter children;
+        JobSystem::run(children, [depth](u32) { run_tree(depth - 1); });
+        JobSystem::run(children, [depth](u32) { run_tree(depth - 1); });
+        JobSystem::wait(children);
+    }
+
+    std::vector<u32> get_thread_counts(u32 max_thread_count) {
+        // powers of two and the maximum itself
+        std::vector<u32> thread_counts;
+        for (u32 thread_count = 1; thread_count < max_thread_count; thread_count *= 2) {
+            thread_counts.push_back(thread_count);
+        }
+        thread_counts.push_back(max_thread_count);
+        return thread_counts;
+    }
+
+    int run(const Options &options) {
+        std::vector<f32> results(options.element_count);
+        f64 parallel_for_base = 0.0;
+        f64 nested_base = 0.0;
+
+        std::printf("median ms, %u elements, %u jobs, %u nested jobs\n", options.element_count, options.job_count, (2u << options.depth) - 2);
+        std::printf("%7s %13s %8s %13s %13s %8s\n", "threads", "parallel_for", "speedup", "tiny jobs", "nested", "speedup");
+
+        for (u32 thread_count : get_thread_counts(options.max_thread_count)) {
+            // the calling thread takes part, a single thread needs no workers at all
+            if (thread_count > 1) {
+                JobSystem::init(thread_count - 1);
+            }
+
+            const f64 parallel_for_time = measure(options.repeat, [&]() {
+                JobSystem::parallel_for(options.element_count, 0, [&](u32 begin, u32 end, u32) {
+                    for (u32 i = begin; i < end; i++) {
+                        results[i] = compute(i);
+                    }
+                });
+            });
+
+            const f64 tiny_jobs_time = measure(options.repeat, [&]() {
+                JobCounter counter;
+                for (u32 i = 0; i < options.job_count; i++) {
+                    JobSystem::run(counter, [](u32) {});
+                }
+                JobSystem::wait(counter);
+            });
+
+            const f64 nested_time = measure(options.repeat, [&]() {
+                run_tree(options.depth);
+            });
+
+            JobSystem::shutdown();
+
+            if (thread_count == 1) {
+                parallel_for_base = parallel_for_time;
+                nested_base = nested_time;
+            }
+
+            std::printf("%7u %13.3f %7.2fx %10.1f ns %13.3f %7.2fx\n", thread_count, parallel_for_time, parallel_for_base / parallel_for_time,
+                        tiny_jobs_time * 1e6 / static_cast<f64>(options.job_count), nested_time, nested_base / nested_time);
+        }
+
+        // keeps the loop from being optimized away
+        f64 checksum = 0.0;
+        for (f32 result : results) {
+            checksum += static_cast<f64>(result);
+        }
+        std::printf("checksum %.3f\n", checksum);
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        return run(parse_options(argc, argv));
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        JobSystem::shutdown();
+        return -1;
+    }
+}
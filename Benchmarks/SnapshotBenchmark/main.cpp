@@ -0,0 +1,112 @@
+// Times SceneSerializer::snapshot, the part of a background save that runs on the main thread,
+// next to writing the snapshot out on a synthetic scene. The scene is made of small hierarchies
+// (a root with children), every entity has a tag, every other one a model path and every tenth a
+// point light, roughly what an editor scene looks like.
+//
+// SnapshotBenchmark [--entities N] [--repeat N]
+
+#include "../../Engine/data/components.h"
+#include "../../Engine/data/entity.h"
+#include "../../Engine/data/scene.h"
+#include "../../Engine/data/scene_serializer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+    struct Options {
+        u32 entity_count = 100000;
+        u32 repeat = 20;
+    };
+
+    Options parse_options(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (argument == "--entities" && has_value) {
+                options.entity_count = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else if (argument == "--repeat" && has_value) {
+                options.repeat = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else {
+                throw std::runtime_error("usage: SnapshotBenchmark [--entities N] [--repeat N]");
+            }
+        }
+        return options;
+    }
+
+    // milliseconds of the fastest and the median run
+    void print_timings(const char *name, std::vector<f64> times) {
+        std::sort(times.begin(), times.end());
+        std::printf("%-9s min %.3f ms  median %.3f ms\n", name, times.front(), times[times.size() / 2]);
+    }
+
+    void build_scene(Scene &scene, u32 entity_count) {
+        constexpr u32 children_per_root = 7;
+
+        Entity root;
+        for (u32 i = 0; i < entity_count; i++) {
+            Entity entity = scene.create_entity("entity " + std::to_string(i));
+            entity.get_component<TransformComponent>().set_translation({static_cast<f32>(i), 0.0f, 0.0f});
+
+            if (i % (children_per_root + 1) == 0) {
+                root = entity;
+            } else {
+                scene.set_parent(entity, root);
+            }
+
+            if (i % 2 == 0) {
+                entity.add_component<ModelComponent>().path = "assets/models/model_" + std::to_string(i % 64) + ".gltf";
+            }
+            if (i % 10 == 0) {
+                entity.add_component<PointLightComponent>();
+            }
+        }
+    }
+
+    int run(const Options &options) {
+        auto scene = std::make_shared<Scene>();
+        build_scene(*scene, options.entity_count);
+
+        SceneSerializer serializer{scene};
+        std::vector<f64> snapshot_times;
+        std::vector<f64> write_times;
+        const std::string path = "snapshot_benchmark.sscene";
+        for (u32 i = 0; i < options.repeat; i++) {
+            auto start = std::chrono::steady_clock::now();
+            BinarySceneWriter snapshot = serializer.snapshot();
+            auto end = std::chrono::steady_clock::now();
+            snapshot_times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+
+            start = std::chrono::steady_clock::now();
+            snapshot.write(path);
+            end = std::chrono::steady_clock::now();
+            write_times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+        std::remove(path.c_str());
+
+        std::printf("%u entities\n", options.entity_count);
+        print_timings("snapshot", snapshot_times);
+        print_timings("write", write_times);
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        return run(parse_options(argc, argv));
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+}
@@ -0,0 +1,169 @@
+// Transforms per second of composing and decomposing TRS matrices one at a time (calculate_matrix,
+// Math::decompose_transform) and through the TransformKernels batches, and of a whole
+// Scene::update_transforms with every entity dirty. Builds with STELLAR_ENABLE_AVX2 run the 8 wide
+// kernels, other x86-64 builds the 4 wide ones.
+//
+// TransformBenchmark [--transforms N] [--repeat N] [--threads N]
+
+#include "../../Engine/core/job_system.h"
+#include "../../Engine/data/components.h"
+#include "../../Engine/data/entity.h"
+#include "../../Engine/data/scene.h"
+#include "../../Engine/math/math.h"
+#include "../../Engine/math/transform_kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+    struct Options {
+        u32 transform_count = 100000;
+        u32 repeat = 20;
+        u32 thread_count = 0; // 0 uses every hardware thread
+    };
+
+    Options parse_options(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (argument == "--transforms" && has_value) {
+                options.transform_count = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else if (argument == "--repeat" && has_value) {
+                options.repeat = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else if (argument == "--threads" && has_value) {
+                options.thread_count = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            } else {
+                throw std::runtime_error("usage: TransformBenchmark [--transforms N] [--repeat N] [--threads N]");
+            }
+        }
+        return options;
+    }
+
+    // the median run, as millions of transforms per second
+    void print_rate(const char *name, std::vector<f64> times, u32 transform_count) {
+        std::sort(times.begin(), times.end());
+        const f64 median = times[times.size() / 2];
+        std::printf("%-18s median %8.3f ms  %8.2f M transforms/s\n", name, median, static_cast<f64>(transform_count) / (median * 1000.0));
+    }
+
+    template<typename Pass>
+    std::vector<f64> measure(u32 repeat, Pass &&pass) {
+        std::vector<f64> times;
+        for (u32 i = 0; i < repeat; i++) {
+            auto start = std::chrono::steady_clock::now();
+            pass();
+            auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+        return times;
+    }
+
+    // the same values every run, spread between low and high
+    f32 pseudo_random(u32 i, u32 axis, f32 low, f32 high) {
+        u32 x = i * 747796405u + axis * 2891336453u;
+        x ^= x >> 16;
+        x *= 0x45d9f3bu;
+        x ^= x >> 16;
+        const f32 t = static_cast<f32>(x & 0xffffu) / 65535.0f;
+        return low + (high - low) * t;
+    }
+
+    int run(const Options &options) {
+        const u32 count = options.transform_count;
+
+        std::vector<TransformComponent> components(count);
+        std::vector<f32> values[9];
+        for (auto &array : values) {
+            array.resize(count);
+        }
+        for (u32 i = 0; i < count; i++) {
+            for (u32 axis = 0; axis < 3; axis++) {
+                values[axis][i] = pseudo_random(i, axis, -200.0f, 200.0f);
+                values[3 + axis][i] = pseudo_random(i, 3 + axis, -3.0f, 3.0f);
+                values[6 + axis][i] = pseudo_random(i, 6 + axis, 0.5f, 2.0f);
+                components[i].translation[axis] = values[axis][i];
+                components[i].rotation[axis] = values[3 + axis][i];
+                components[i].scale[axis] = values[6 + axis][i];
+            }
+        }
+
+        const TransformKernels::TransformArrays arrays = {
+            {values[0].data(), values[1].data(), values[2].data()},
+            {values[3].data(), values[4].data(), values[5].data()},
+            {values[6].data(), values[7].data(), values[8].data()},
+        };
+        std::vector<glm::mat4> matrices(count);
+
+        auto scalar_compose = measure(options.repeat, [&]() {
+            for (u32 i = 0; i < count; i++) {
+                matrices[i] = components[i].calculate_matrix();
+            }
+        });
+        auto batch_compose = measure(options.repeat, [&]() {
+            TransformKernels::compose(arrays, count, matrices.data());
+        });
+
+        auto scalar_decompose = measure(options.repeat, [&]() {
+            for (u32 i = 0; i < count; i++) {
+                Math::decompose_transform(matrices[i], components[i].translation, components[i].rotation, components[i].scale);
+            }
+        });
+        auto batch_decompose = measure(options.repeat, [&]() {
+            TransformKernels::decompose(matrices.data(), count, arrays);
+        });
+
+        // roots only, the hierarchy composes in batches and writes the world matrices back
+        Scene scene;
+        std::vector<Entity> entities;
+        entities.reserve(count);
+        for (u32 i = 0; i < count; i++) {
+            entities.push_back(scene.create_entity());
+            entities.back().get_component<TransformComponent>().set_translation(components[i].translation);
+        }
+        scene.update_transforms();
+
+        auto scene_update = measure(options.repeat, [&]() {
+            for (Entity &entity : entities) {
+                entity.get_component<TransformComponent>().is_dirty = true;
+            }
+            scene.update_transforms();
+        });
+
+        std::printf("%u transforms, %u threads, checksum %.3f\n", count, JobSystem::get_thread_count(), static_cast<f64>(matrices[count / 2][3][0] + components[count / 2].scale.x));
+        print_rate("compose scalar", std::move(scalar_compose), count);
+        print_rate("compose batch", std::move(batch_compose), count);
+        print_rate("decompose scalar", std::move(scalar_decompose), count);
+        print_rate("decompose batch", std::move(batch_decompose), count);
+        print_rate("update_transforms", std::move(scene_update), count);
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    int result = 0;
+
+    try {
+        Options options = parse_options(argc, argv);
+        // the calling thread takes part, a single thread needs no workers at all
+        if (options.thread_count != 1) {
+            JobSystem::init(options.thread_count > 1 ? options.thread_count - 1 : 0);
+        }
+        result = run(options);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        result = -1;
+    }
+
+    JobSystem::shutdown();
+    return result;
+}
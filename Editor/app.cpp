@@ -16,7 +16,9 @@ namespace Engine {
         window = std::make_shared<Window>(WIDTH, HEIGHT, "Stellar Engine");
         device = std::make_shared<Device>(window.get());
         Core::init(device);
+        AssetManager::init(device);
         InputManager::init(window->get_GLFWwindow());
+        JobSystem::init();
 
         renderer = std::make_unique<Renderer>(window, device);
         editor_scene = std::make_shared<Scene>();
@@ -39,10 +41,9 @@ namespace Engine {
 
         preferences_panel = std::make_unique<PreferencesPanel>();
 
-        physics_system = std::make_shared<PhysicsSystem>(editor_scene);
-
-        auto helmet = std::make_shared<Model>(device, "assets/models/SciFiHelmet/glTF/SciFiHelmet.gltf");
-        auto damaged_helmet = std::make_shared<Model>(device, "assets/models/DamagedHelmet/glTF/DamagedHelmet.gltf");
+        auto models = AssetManager::get_models({"assets/models/SciFiHelmet/glTF/SciFiHelmet.gltf", "assets/models/DamagedHelmet/glTF/DamagedHelmet.gltf"});
+        auto helmet = models[0];
+        auto damaged_helmet = models[1];
 
         auto entity = editor_scene->create_entity("HELP");
         auto script = std::make_shared<HelmetScript>(entity.get_handle(), editor_scene);
@@ -61,36 +62,54 @@ namespace Engine {
         sphere_1.add_component<ModelComponent>(helmet);
         sphere_1.get_component<PhysicsComponent>().inverse_mass = 1.0f;
         sphere_1.get_component<PhysicsComponent>().elasticity = 0.5f;
-        sphere_1.get_component<PhysicsComponent>().shape = std::make_unique<Sphere>(1.0f);
+        sphere_1.get_component<PhysicsComponent>().shape = std::make_shared<Sphere>(1.0f);
 
         auto sphere_2 = editor_scene->create_entity("sphere_2");
         sphere_2.get_component<TransformComponent>().translation = { 0 , -1010, 0 };
         sphere_2.add_component<PhysicsComponent>();
         sphere_2.get_component<PhysicsComponent>().inverse_mass = 0.0f;
         sphere_2.get_component<PhysicsComponent>().elasticity = 1.0f;
-        sphere_2.get_component<PhysicsComponent>().shape = std::make_unique<Sphere>(1000.0f);
+        sphere_2.get_component<PhysicsComponent>().shape = std::make_shared<Sphere>(1000.0f);
 
 
         auto test1 = editor_scene->create_entity("Test 1");
-        test1.get_component<RelationshipComponent>().parent = test;
+        editor_scene->set_parent(test1, test);
         test1.get_component<TransformComponent>().set_translation(glm::vec3{5.0f, 3.0f, 0.0f});
         test1.add_component<ModelComponent>(helmet);
 
         auto test2 = editor_scene->create_entity("Test 2");
-        test2.get_component<RelationshipComponent>().parent = test;
+        editor_scene->set_parent(test2, test);
         test2.get_component<TransformComponent>().set_translation(glm::vec3{-5.0f, 3.0f, 0.0f});
         test2.add_component<ModelComponent>(helmet);
 
-        test.get_component<RelationshipComponent>().children.push_back(test1);
-        test.get_component<RelationshipComponent>().children.push_back(test2);
-
         SceneSerializer serializer(editor_scene);
         serializer.deserialize(device, "assets/Example.scene");
 
-        scene_hierarchy_panel->set_context(editor_scene);
+        active_scene = editor_scene;
+        scene_hierarchy_panel->set_context(active_scene);
+
+        scene_saver.set_autosave("./assets/Example.autosave.sscene", SceneSaver::Format::BINARY, 60.0f);
+    }
+
+    App::~App() {
+        scene_saver.wait();
+        physics_system.reset();
+        AssetManager::shutdown();
+        JobSystem::shutdown();
+    }
+
+    void App::start_playing() {
+        active_scene = editor_scene->copy();
+        physics_system = std::make_shared<PhysicsSystem>(active_scene);
+        scene_hierarchy_panel->set_context(active_scene);
     }
 
-    App::~App() {}
+    void App::stop_playing() {
+        // the physics system hooks into the scene it runs on, it has to go first
+        physics_system.reset();
+        active_scene = editor_scene;
+        scene_hierarchy_panel->set_context(active_scene);
+    }
 
     void App::run() {
         std::vector<std::unique_ptr<Buffer>> ubo_buffers(SwapChain::MAX_FRAMES_IN_FLIGHT);
@@ -99,9 +118,12 @@ namespace Engine {
             uboBuffer->map();
         }
 
+        TransformBuffer transform_buffer{device};
+
         std::vector<VkDescriptorSet> vk_global_descriptor_sets(SwapChain::MAX_FRAMES_IN_FLIGHT);
         for (u32 i = 0; i < vk_global_descriptor_sets.size(); i++) {
             auto buffer_info = ubo_buffers[i]->get_descriptor_info();
+            auto transform_buffer_info = transform_buffer.get_descriptor_info(i);
 
             VkDescriptorImageInfo irradiance_image_info = {};
             irradiance_image_info.sampler = pbr_system->get_sampler();
@@ -129,6 +151,7 @@ namespace Engine {
                     .write_image(2, &BRDFLUT_image_info)
                     .write_image(3, &prefilteredMap_image_info)
                     .write_image(4, &env_map_image_info)
+                    .write_buffer(TransformBuffer::binding, &transform_buffer_info)
                     .build(device, vk_global_descriptor_sets[i]);
         }
 
@@ -138,6 +161,8 @@ namespace Engine {
 
         while (!window->should_close()) {
             glfwPollEvents();
+            // window and device calls queued from jobs
+            JobSystem::run_main_thread_jobs();
 
             if (viewport_panel->resized()) {
                 //offscreen_system->resize(viewport_panel->get_viewport_size().x, viewport_panel->get_viewport_size().y);
@@ -165,18 +190,28 @@ namespace Engine {
                 ubo.screen_width = static_cast<float>(viewport_panel->get_viewport_size().x);
                 ubo.screen_height = static_cast<float>(viewport_panel->get_viewport_size().y);
 
-                physics_system->update(frame_time);
-                editor_scene->update_lights_ubo(ubo);
-                editor_scene->update(frame_time);
-                editor_scene->update_transforms();
+                if (physics_system) {
+                    physics_system->update(frame_time);
+                    active_scene->update(frame_time);
+                }
+                scene_saver.update(editor_scene, frame_time);
+                active_scene->update_lights_ubo(ubo);
+                active_scene->update_transforms();
+
+                if (transform_buffer.update(frame_index, *active_scene)) {
+                    auto transform_buffer_info = transform_buffer.get_descriptor_info(frame_index);
+                    DescriptorWriter(*Core::global_descriptor_set_layout, *Core::global_descriptor_pool)
+                            .write_buffer(TransformBuffer::binding, &transform_buffer_info)
+                            .overwrite(device, vk_global_descriptor_sets[frame_index]);
+                }
 
                 ubo_buffers[frame_index]->write_to_buffer(&ubo);
                 ubo_buffers[frame_index]->flush();
 
                 FrameInfo frameInfo{frame_index, frame_time, command_buffer, vk_global_descriptor_sets[frame_index], ubo};
 
-                //shadow_system->render(frameInfo, editor_scene);
-                deferred_rendering_system->start(frameInfo, editor_scene);
+                //shadow_system->render(frameInfo, active_scene);
+                deferred_rendering_system->start(frameInfo, active_scene);
                 pbr_system->render_skybox(frameInfo);
                 deferred_rendering_system->end(frameInfo);
 
@@ -195,12 +230,30 @@ namespace Engine {
                 }
 
                 ImGui::Begin("Window");
+                if (!physics_system && ImGui::Button("play")) {
+                    start_playing();
+                } else if (physics_system && ImGui::Button("stop")) {
+                    stop_playing();
+                }
+
                 if (ImGui::Button("save scene")) {
-                    SceneSerializer serializer(editor_scene);
-                    serializer.serialize("./assets/Example.scene");
+                    scene_saver.save(editor_scene, "./assets/Example.scene", SceneSaver::Format::YAML);
+                }
+                if (scene_saver.is_busy()) {
+                    ImGui::SameLine();
+                    ImGui::Text("saving...");
+                }
+                if (auto error = scene_saver.get_last_error(); !error.empty()) {
+                    ImGui::TextColored({1.0f, 0.3f, 0.3f, 1.0f}, "%s", error.c_str());
                 }
 
                 ImGui::Checkbox("Grid", &is_grid_enabled);
+
+                auto asset_statistics = AssetManager::get_statistics();
+                ImGui::Text("models: %u loaded, %llu hits, %llu misses", asset_statistics.loaded_models,
+                            static_cast<unsigned long long>(asset_statistics.model_hits), static_cast<unsigned long long>(asset_statistics.model_misses));
+                ImGui::Text("textures: %u loaded, %llu hits, %llu misses", asset_statistics.loaded_textures,
+                            static_cast<unsigned long long>(asset_statistics.texture_hits), static_cast<unsigned long long>(asset_statistics.texture_misses));
                 ImGui::End();
 
                 imgui_layer->render(command_buffer);
@@ -27,7 +27,12 @@ namespace Engine {
         void run();
 
     private:
+        // play runs physics and scripts on a copy of the editor scene, stop throws the copy away
+        void start_playing();
+        void stop_playing();
+
         std::shared_ptr<Scene> editor_scene;
+        std::shared_ptr<Scene> active_scene; // editor_scene unless playing
 
         std::shared_ptr<Window> window;
         std::shared_ptr<Device> device;
@@ -52,7 +57,8 @@ namespace Engine {
         std::unique_ptr<DockSpacePanel> dock_space_panel;
         std::shared_ptr<SceneHierarchyPanel> scene_hierarchy_panel;
         std::shared_ptr<ViewportPanel> viewport_panel;
-        std::shared_ptr<PhysicsSystem> physics_system;
+        std::shared_ptr<PhysicsSystem> physics_system; // only while playing
+        SceneSaver scene_saver; // saves and autosaves editor_scene in the background
 
         //VkDescriptorSet vk_post_processing_descriptor_set;
     };
@@ -18,5 +18,13 @@ namespace Engine {
     void HelmetScript::on_event() {
 
     }
+
+    std::shared_ptr<NativeScript> HelmetScript::clone(entt::entity entity, Scene &scene) const {
+        return std::make_shared<HelmetScript>(entity, scene);
+    }
+
+    void HelmetScript::declare_access(ScriptAccess &access) const {
+        access.write<TransformComponent>();
+    }
 }
 
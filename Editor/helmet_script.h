@@ -5,13 +5,15 @@
 namespace Engine {
     class HelmetScript : public NativeScript {
     public:
-        HelmetScript(entt::entity entity, std::shared_ptr<Scene> scene) : NativeScript(entity, scene) {}
+        using NativeScript::NativeScript;
         virtual ~HelmetScript() {}
 
         virtual void start() override;
         virtual void stop() override;
         virtual void update(const float &deltaTime) override;
         virtual void on_event() override;
+        virtual void declare_access(ScriptAccess &access) const override;
+        virtual std::shared_ptr<NativeScript> clone(entt::entity entity, Scene &scene) const override;
 
     };
 }
\ No newline at end of file
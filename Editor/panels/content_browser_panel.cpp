@@ -8,8 +8,8 @@ namespace Engine {
     extern const std::filesystem::path asset_path = "assets";
 
     ContentBrowserPanel::ContentBrowserPanel(std::shared_ptr<Device> device) : current_directory(asset_path) {
-        file_icon = std::make_unique<Texture>(device, "assets/file.png");
-        directory_icon = std::make_unique<Texture>(device, "assets/directory.png");
+        file_icon = AssetManager::get_texture("assets/file.png");
+        directory_icon = AssetManager::get_texture("assets/directory.png");
     }
 
     void ContentBrowserPanel::file_tree(const std::filesystem::path &path) {
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <filesystem>
-#include "../../Engine/graphics/texture.h"
+#include "../../Engine/graphics/asset_manager.h"
 #include "../../Engine/graphics/descriptor_set.h"
 
 namespace Engine {
@@ -15,7 +15,7 @@ namespace Engine {
         void file_tree(const std::filesystem::path &path);
 
         std::filesystem::path current_directory;
-        std::unique_ptr<Texture> file_icon;
-        std::unique_ptr<Texture> directory_icon;
+        std::shared_ptr<Texture> file_icon;
+        std::shared_ptr<Texture> directory_icon;
     };
 }
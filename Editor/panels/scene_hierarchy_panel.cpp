@@ -23,12 +23,9 @@ namespace Engine {
         ImGui::Begin("Scene Hierarchy");
 
         if (context) {
-            context->registry.each([&](auto entityID) {
-                Entity entity{entityID, context.get()};
-                if (entity.has_component<RelationshipComponent>()) {
-                    if (entity.get_component<RelationshipComponent>().parent == entt::null) {
-                        draw_entity_node(entity);
-                    }
+            context->view<RelationshipComponent>().each([&](auto entityID, RelationshipComponent &rc) {
+                if (rc.parent == entt::null) {
+                    draw_entity_node({entityID, context.get()});
                 }
             });
 
@@ -72,8 +69,7 @@ namespace Engine {
         if (ImGui::BeginPopupContextItem()) {
             if (ImGui::MenuItem("Create Empty Entity")) {
                 auto new_entity = context->create_entity("Empty Entity");
-                new_entity.get_component<RelationshipComponent>().parent = entity;
-                entity.get_component<RelationshipComponent>().children.push_back(new_entity);
+                context->set_parent(new_entity, entity);
             }
 
             if (ImGui::MenuItem("Delete Entity")) {
@@ -84,35 +80,20 @@ namespace Engine {
         }
 
         if (opened) {
-            for (auto &entityID: entity.get_component<RelationshipComponent>().children) {
-                Entity child{entityID, context.get()};
-                draw_entity_node(child);
+            // a child can delete itself while it's drawn, step to its sibling before that
+            entt::entity child = entity.get_component<RelationshipComponent>().first_child;
+            while (child != entt::null) {
+                const entt::entity next_sibling = context->registry.get<RelationshipComponent>(child).next_sibling;
+                draw_entity_node({child, context.get()});
+                child = next_sibling;
             }
 
             ImGui::TreePop();
         }
 
         if (entity_deleted) {
-            if (entity.has_component<RelationshipComponent>()) {
-                {
-                    auto &children = entity.get_component<RelationshipComponent>().children;
-                    for (auto &childID: children) {
-                        context->registry.destroy(childID);
-                    }
-                    children.clear();
-                }
-
-                auto &parentID = entity.get_component<RelationshipComponent>().parent;
-                if (parentID != entt::null) {
-                    Entity parent{parentID, context.get()};
-                    auto &children = parent.get_component<RelationshipComponent>().children;
-                    children.erase(std::remove(children.begin(), children.end(), entity), children.end());
-                }
-
-            }
-
             context->destroy_entity(entity);
-            if (selection_context == entity)
+            if (selection_context && !context->registry.valid(selection_context))
                 selection_context = {};
         }
     }
@@ -7,6 +7,7 @@
 #include <utility>
 #include "../../Engine/math/math.h"
 #include "../../Engine/core/input_manager.h"
+#include "../../Engine/data/scene_query.h"
 
 namespace Engine {
     ViewportPanel::ViewportPanel(std::shared_ptr<SceneHierarchyPanel> _scene_hierarchy_panel, std::shared_ptr<Camera> _camera, std::shared_ptr<Window> _window, VkSampler sampler, VkImageView imageView) : scene_hierarchy_panel{std::move(_scene_hierarchy_panel)}, camera{std::move(_camera)}, window{std::move(_window)} {
@@ -25,6 +26,10 @@ namespace Engine {
 
         ImGui::Image(image, viewport_panel_size);
 
+        if (ImGui::IsItemHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left) && !ImGuizmo::IsOver() && !ImGuizmo::IsUsing()) {
+            pick_entity();
+        }
+
         if (InputManager::is_pressed(Key::U)) {
             if (!ImGuizmo::IsUsing())
                 gizmo_type = -1;
@@ -76,6 +81,38 @@ namespace Engine {
         ImGui::PopStyleVar();
     }
 
+    // Casts a ray from the camera through the clicked pixel and selects whatever it hits first.
+    void ViewportPanel::pick_entity() {
+        std::shared_ptr<Scene> scene = scene_hierarchy_panel->get_context();
+        if (!scene) {
+            return;
+        }
+
+        ImVec2 image_min = ImGui::GetItemRectMin();
+        ImVec2 image_size = ImGui::GetItemRectSize();
+        ImVec2 mouse = ImGui::GetMousePos();
+
+        // vulkan clip space, y points down and depth goes from 0 to 1
+        glm::vec2 ndc = {2.0f * (mouse.x - image_min.x) / image_size.x - 1.0f, 2.0f * (mouse.y - image_min.y) / image_size.y - 1.0f};
+        glm::mat4 inverse_view_projection = glm::inverse(camera->getProjection() * camera->getView());
+
+        glm::vec4 near_point = inverse_view_projection * glm::vec4{ndc, 0.0f, 1.0f};
+        glm::vec4 far_point = inverse_view_projection * glm::vec4{ndc, 1.0f, 1.0f};
+        near_point /= near_point.w;
+        far_point /= far_point.w;
+
+        Ray ray;
+        ray.origin = glm::vec3{near_point};
+        ray.direction = glm::normalize(glm::vec3{far_point} - glm::vec3{near_point});
+
+        QueryHit hit;
+        if (scene->get_query().raycast(ray, hit)) {
+            scene_hierarchy_panel->set_selected_entity(Entity{hit.entity, scene.get()});
+        } else {
+            scene_hierarchy_panel->set_selected_entity({});
+        }
+    }
+
     void ViewportPanel::update_image(VkSampler sampler, VkImageView imageView) {
         image = ImGui_ImplVulkan_AddTexture(sampler, imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
         should_resize = false;
@@ -17,6 +17,8 @@ namespace Engine {
         glm::ivec2 get_viewport_size() { return viewport_size; }
 
     private:
+        void pick_entity();
+
         // TODO: This garbage
         std::shared_ptr<SceneHierarchyPanel> scene_hierarchy_panel;
         std::shared_ptr<Camera> camera;
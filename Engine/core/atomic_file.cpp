@@ -0,0 +1,95 @@
+#include "atomic_file.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Engine {
+    namespace {
+        // Closing a stream only hands the data to the OS. Without flushing it to the disk first, a
+        // crash right after the rename can leave the new name pointing at an empty or partial file.
+#ifdef _WIN32
+        bool sync_file(const std::string &path) {
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                return false;
+            }
+            const bool synced = FlushFileBuffers(file) != 0;
+            CloseHandle(file);
+            return synced;
+        }
+
+        // NTFS journals the rename itself
+        void sync_directory(const std::string &) {}
+#else
+        bool sync_file(const std::string &path) {
+            const int fd = open(path.c_str(), O_WRONLY);
+            if (fd == -1) {
+                return false;
+            }
+            const bool synced = fsync(fd) == 0;
+            close(fd);
+            return synced;
+        }
+
+        // the rename is an entry in the directory, it's only durable once the directory is synced
+        // too, failing that is harmless as the old or the new file is still there
+        void sync_directory(const std::string &path) {
+            std::filesystem::path directory = std::filesystem::path{path}.parent_path();
+            if (directory.empty()) {
+                directory = ".";
+            }
+
+            const int fd = open(directory.c_str(), O_RDONLY);
+            if (fd != -1) {
+                fsync(fd);
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    AtomicFile::AtomicFile(const std::string &_path) : path{_path}, temp_path{_path + ".tmp"}, stream{temp_path, std::ios::binary | std::ios::trunc} {
+        if (!stream) {
+            throw std::runtime_error("failed to open file for writing: " + temp_path);
+        }
+    }
+
+    AtomicFile::~AtomicFile() {
+        if (!is_committed) {
+            stream.close();
+            std::error_code error;
+            std::filesystem::remove(temp_path, error);
+        }
+    }
+
+    void AtomicFile::commit() {
+        stream.close();
+        if (!stream) {
+            throw std::runtime_error("failed to write file: " + temp_path);
+        }
+        if (!sync_file(temp_path)) {
+            throw std::runtime_error("failed to flush file: " + temp_path);
+        }
+
+        // replaces an existing file on every platform, the temp file sits in the same directory so
+        // it's a rename and not a copy
+        std::error_code error;
+        std::filesystem::rename(temp_path, path, error);
+        if (error) {
+            throw std::runtime_error("failed to replace " + path + ": " + error.message());
+        }
+        is_committed = true;
+
+        sync_directory(path);
+    }
+}
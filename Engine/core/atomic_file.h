@@ -0,0 +1,30 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+namespace Engine {
+    // A file that's replaced in one step. Writes go to a temp file next to it and commit() flushes it
+    // to the disk and renames it over the target, so readers and a crash mid save see either the old
+    // file or the whole new one. Without commit() the temp file is removed again.
+    class AtomicFile {
+    public:
+        // throws when the temp file can't be created
+        explicit AtomicFile(const std::string &path);
+        ~AtomicFile();
+
+        AtomicFile(const AtomicFile &) = delete;
+        AtomicFile &operator=(const AtomicFile &) = delete;
+
+        std::ofstream &get_stream() { return stream; }
+
+        // throws when a write failed or the rename didn't go through
+        void commit();
+
+    private:
+        std::string path;
+        std::string temp_path;
+        std::ofstream stream;
+        bool is_committed = false;
+    };
+}
@@ -0,0 +1,342 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+
+namespace Engine {
+    struct JobCounterAccess {
+        static void add(JobCounter &counter) { counter.value.fetch_add(1, std::memory_order_relaxed); }
+
+        // true when this was the last job, the continuations are handed over in ready
+        static bool finish(JobCounter &counter, std::vector<std::function<void()>> &ready) {
+            // the lock covers the drop to zero, wait() takes it before returning so nobody is still
+            // touching the counter when its owner destroys it
+            std::lock_guard<std::mutex> lock(counter.mutex);
+            if (counter.value.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return false;
+            }
+            ready.swap(counter.continuations);
+            return true;
+        }
+    };
+
+    namespace {
+        constexpr u32 unknown_thread = ~0u;
+
+        // batches per thread when parallel_for picks the grain, leaves room for stealing to even out
+        // batches that take longer than others
+        constexpr u32 auto_batches_per_thread = 4;
+
+        struct QueuedJob {
+            JobSystem::Job func;
+            JobCounter *counter = nullptr;
+            bool is_batch = false; // a piece of a parallel_for
+        };
+
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<QueuedJob> jobs;
+        };
+
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<WorkQueue>> queues; // one per thread index
+        // set before the workers start and reset after they're joined, so they never look at workers
+        u32 thread_count = 1;
+
+        std::mutex main_thread_mutex;
+        std::vector<QueuedJob> main_thread_jobs;
+
+        std::mutex sleep_mutex;
+        std::condition_variable wake_condition;
+        std::atomic<u32> queued_jobs{0};
+        std::atomic<u32> sleeping_workers{0};
+        std::atomic<bool> running{false};
+
+        thread_local u32 current_thread = unknown_thread;
+        thread_local u32 steal_seed = 0;
+        // inside a parallel_for batch, the thread index belongs to it until it returns
+        thread_local bool is_in_batch = false;
+
+        void finish(JobCounter *counter);
+
+        void execute(QueuedJob &job, u32 thread_index) {
+            job.func(thread_index);
+            finish(job.counter);
+        }
+
+        void push(QueuedJob job) {
+            if (thread_count == 1) {
+                execute(job, 0);
+                return;
+            }
+
+            // threads the system doesn't know share the main thread's queue, it's locked anyway
+            const u32 thread_index = current_thread == unknown_thread ? 0 : current_thread;
+            {
+                std::lock_guard<std::mutex> lock(queues[thread_index]->mutex);
+                queues[thread_index]->jobs.push_back(std::move(job));
+            }
+
+            queued_jobs.fetch_add(1);
+            if (sleeping_workers.load() > 0) {
+                // taking the lock makes sure a worker that's going to sleep is already waiting
+                { std::lock_guard<std::mutex> lock(sleep_mutex); }
+                wake_condition.notify_one();
+            }
+        }
+
+        bool is_runnable(const QueuedJob &job) {
+            // another batch would get the same thread index as the one that's waiting
+            return !is_in_batch || !job.is_batch;
+        }
+
+        bool pop_own(u32 thread_index, QueuedJob &job) {
+            WorkQueue &queue = *queues[thread_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto it = std::find_if(queue.jobs.rbegin(), queue.jobs.rend(), is_runnable);
+            if (it == queue.jobs.rend()) {
+                return false;
+            }
+            job = std::move(*it);
+            queue.jobs.erase(std::next(it).base());
+            queued_jobs.fetch_sub(1);
+            return true;
+        }
+
+        bool steal(u32 thread_index, QueuedJob &job) {
+            // xorshift, so thieves don't all go after the same queue first
+            steal_seed ^= steal_seed << 13;
+            steal_seed ^= steal_seed >> 17;
+            steal_seed ^= steal_seed << 5;
+
+            const u32 queue_count = static_cast<u32>(queues.size());
+            const u32 first = steal_seed % queue_count;
+            for (u32 i = 0; i < queue_count; i++) {
+                const u32 victim = (first + i) % queue_count;
+                if (victim == thread_index) {
+                    continue;
+                }
+
+                WorkQueue &queue = *queues[victim];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                auto it = std::find_if(queue.jobs.begin(), queue.jobs.end(), is_runnable);
+                if (it != queue.jobs.end()) {
+                    job = std::move(*it);
+                    queue.jobs.erase(it);
+                    queued_jobs.fetch_sub(1);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool pop_main_thread(QueuedJob &job) {
+            std::lock_guard<std::mutex> lock(main_thread_mutex);
+            if (main_thread_jobs.empty()) {
+                return false;
+            }
+            job = std::move(main_thread_jobs.front());
+            main_thread_jobs.erase(main_thread_jobs.begin());
+            return true;
+        }
+
+        bool try_run_one(u32 thread_index) {
+            QueuedJob job;
+            if ((thread_index == 0 && pop_main_thread(job)) || pop_own(thread_index, job) || steal(thread_index, job)) {
+                execute(job, thread_index);
+                return true;
+            }
+            return false;
+        }
+
+        void finish(JobCounter *counter) {
+            if (!counter) {
+                return;
+            }
+
+            std::vector<std::function<void()>> ready;
+            if (JobCounterAccess::finish(*counter, ready)) {
+                for (auto &continuation : ready) {
+                    continuation();
+                }
+            }
+        }
+
+        void worker_loop(u32 thread_index) {
+            current_thread = thread_index;
+            steal_seed = thread_index * 2654435761u + 1;
+
+            while (true) {
+                if (try_run_one(thread_index)) {
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                sleeping_workers.fetch_add(1);
+                wake_condition.wait(lock, [] { return queued_jobs.load() > 0 || !running.load(); });
+                sleeping_workers.fetch_sub(1);
+                if (!running.load() && queued_jobs.load() == 0) {
+                    return;
+                }
+            }
+        }
+
+        void run_batch(const std::function<void(u32, u32, u32)> &func, u32 begin, u32 end, u32 thread_index) {
+            // restored on the way out, also when func throws or this batch runs inside another one
+            struct BatchScope {
+                bool was_in_batch = is_in_batch;
+                BatchScope() { is_in_batch = true; }
+                ~BatchScope() { is_in_batch = was_in_batch; }
+            } scope;
+            func(begin, end, thread_index);
+        }
+
+        void split(const std::function<void(u32, u32, u32)> &func, u32 begin, u32 end, u32 grain, JobCounter &counter, u32 thread_index) {
+            // the upper half goes to the queue for thieves, the lower half is split further here
+            while (end - begin > grain) {
+                const u32 batch_count = (end - begin + grain - 1) / grain;
+                const u32 middle = begin + batch_count / 2 * grain;
+                JobCounterAccess::add(counter);
+                push({[&func, &counter, middle, end, grain](u32 index) { split(func, middle, end, grain, counter, index); }, &counter, true});
+                end = middle;
+            }
+            run_batch(func, begin, end, thread_index);
+        }
+    }
+
+    void JobSystem::init(u32 worker_count) {
+        if (running) {
+            return;
+        }
+
+        if (worker_count == 0) {
+            u32 hardware_threads = std::thread::hardware_concurrency();
+            worker_count = hardware_threads > 1 ? hardware_threads - 1 : 0;
+        }
+
+        current_thread = 0;
+        steal_seed = 1;
+        running = true;
+
+        queues.clear();
+        for (u32 i = 0; i < worker_count + 1; i++) {
+            queues.push_back(std::make_unique<WorkQueue>());
+        }
+        thread_count = worker_count + 1;
+
+        workers.reserve(worker_count);
+        for (u32 i = 0; i < worker_count; i++) {
+            workers.emplace_back(worker_loop, i + 1);
+        }
+    }
+
+    void JobSystem::shutdown() {
+        if (!running) {
+            return;
+        }
+
+        run_main_thread_jobs();
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            running = false;
+        }
+        wake_condition.notify_all();
+
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+        queues.clear();
+        thread_count = 1;
+    }
+
+    u32 JobSystem::get_thread_count() {
+        return thread_count;
+    }
+
+    u32 JobSystem::get_thread_index() {
+        return current_thread == unknown_thread ? 0 : current_thread;
+    }
+
+    bool JobSystem::is_main_thread() {
+        // before init() there is nothing to tell the threads apart, the caller is taken as the main one
+        return current_thread == 0 || (current_thread == unknown_thread && thread_count == 1);
+    }
+
+    void JobSystem::run(JobCounter &counter, Job job) {
+        JobCounterAccess::add(counter);
+        push({std::move(job), &counter});
+    }
+
+    void JobSystem::run_after(JobCounter &dependency, JobCounter &counter, Job job) {
+        JobCounterAccess::add(counter);
+
+        {
+            std::lock_guard<std::mutex> lock(dependency.mutex);
+            if (dependency.value.load(std::memory_order_acquire) != 0) {
+                // std::function has to be copyable, the job moves into a shared_ptr
+                auto queued = std::make_shared<QueuedJob>(QueuedJob{std::move(job), &counter});
+                dependency.continuations.push_back([queued] { push(std::move(*queued)); });
+                return;
+            }
+        }
+        push({std::move(job), &counter});
+    }
+
+    void JobSystem::run_on_main_thread(JobCounter &counter, std::function<void()> job) {
+        JobCounterAccess::add(counter);
+
+        QueuedJob queued{[job = std::move(job)](u32) { job(); }, &counter};
+        if (is_main_thread()) {
+            execute(queued, 0);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(main_thread_mutex);
+        main_thread_jobs.push_back(std::move(queued));
+    }
+
+    void JobSystem::wait(JobCounter &counter) {
+        // threads the system doesn't know only wait, a job could need the main thread or its scratch
+        while (!counter.is_done()) {
+            if (thread_count == 1 || current_thread == unknown_thread || !try_run_one(current_thread)) {
+                std::this_thread::yield();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(counter.mutex);
+    }
+
+    void JobSystem::run_main_thread_jobs() {
+        QueuedJob job;
+        while (pop_main_thread(job)) {
+            execute(job, 0);
+        }
+    }
+
+    void JobSystem::parallel_for(u32 count, u32 grain, const std::function<void(u32, u32, u32)> &func) {
+        if (count == 0) {
+            return;
+        }
+
+        if (grain == 0) {
+            grain = std::max(count / (get_thread_count() * auto_batches_per_thread), 1u);
+        }
+
+        // a parallel_for inside a batch stays on its thread, it already owns the thread index
+        const u32 thread_index = get_thread_index();
+        if (thread_count == 1 || count <= grain || current_thread == unknown_thread || is_in_batch) {
+            for (u32 begin = 0; begin < count; begin += grain) {
+                run_batch(func, begin, std::min(begin + grain, count), thread_index);
+            }
+            return;
+        }
+
+        JobCounter counter;
+        split(func, 0, count, grain, counter, thread_index);
+        wait(counter);
+    }
+}
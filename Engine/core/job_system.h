@@ -0,0 +1,74 @@
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Engine {
+    // Number of jobs still pending in a group, JobSystem::wait() blocks until it drops to zero and
+    // jobs started with run_after() are held back until then. A counter can be reused once waited on,
+    // it has to outlive every job that counts on it.
+    class JobCounter {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter &) = delete;
+        JobCounter &operator=(const JobCounter &) = delete;
+
+        bool is_done() const { return value.load(std::memory_order_acquire) == 0; }
+
+    private:
+        std::atomic<u32> value{0};
+        std::mutex mutex;
+        std::vector<std::function<void()>> continuations; // queued when value drops to zero
+
+        friend class JobSystem;
+        friend struct JobCounterAccess; // the queues in job_system.cpp
+    };
+
+    // Work stealing job system. Every thread has its own deque, it pushes and pops its jobs at the
+    // back while idle threads steal from the front of the others, so a thread mostly works on
+    // what it just split off and thieves take the biggest pieces. Waiting on a counter runs jobs
+    // instead of blocking, so jobs can wait on jobs they started.
+    //
+    // Thread index 0 is the thread that called init(), the main thread. Vulkan and GLFW calls go
+    // through run_on_main_thread(). Without init() (or with a single hardware thread) every job runs
+    // inline on the caller.
+    class JobSystem {
+    public:
+        using Job = std::function<void(u32)>; // thread_index
+
+        static void init(u32 worker_count = 0);
+        // finishes the queued jobs, then stops the workers
+        static void shutdown();
+
+        // number of distinct thread indices handed to jobs
+        static u32 get_thread_count();
+        // index of the calling thread, threads the system doesn't know get 0
+        static u32 get_thread_index();
+        static bool is_main_thread();
+
+        static void run(JobCounter &counter, Job job);
+        // job is queued once dependency reaches zero, counter counts it from now on
+        static void run_after(JobCounter &dependency, JobCounter &counter, Job job);
+        // queued for the main thread, it runs them in wait() and run_main_thread_jobs()
+        static void run_on_main_thread(JobCounter &counter, std::function<void()> job);
+
+        // runs jobs on the calling thread until counter reaches zero, other threads just wait for it
+        static void wait(JobCounter &counter);
+
+        // drains the main thread queue, the app calls this once a frame
+        static void run_main_thread_jobs();
+
+        // Splits [0, count) into batches of at most grain elements (a grain of 0 picks one from the
+        // thread count) and blocks until all of them ran. Batches start at multiples of grain.
+        // func(begin, end, thread_index), thread_index is < get_thread_count() and owned by the
+        // caller for the duration of the batch, so it can index per thread scratch. A wait() inside
+        // func only runs jobs that aren't batches and a parallel_for() inside it runs inline, so no
+        // other batch gets the thread index in the meantime. Call it from the main thread or a job,
+        // anywhere else it runs inline.
+        static void parallel_for(u32 count, u32 grain, const std::function<void(u32, u32, u32)> &func);
+    };
+}
@@ -0,0 +1,93 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine {
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string &path) {
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            file = nullptr;
+            throw std::runtime_error("failed to open file: " + path);
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size)) {
+            CloseHandle(file);
+            throw std::runtime_error("failed to read file size: " + path);
+        }
+        size = static_cast<usize>(file_size.QuadPart);
+        if (size == 0) {
+            return;
+        }
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            throw std::runtime_error("failed to map file: " + path);
+        }
+        data = static_cast<const u8 *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!data) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("failed to map file: " + path);
+        }
+    }
+
+    MappedFile::~MappedFile() {
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (file) {
+            CloseHandle(file);
+        }
+    }
+#else
+    MappedFile::MappedFile(const std::string &path) {
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            throw std::runtime_error("failed to open file: " + path);
+        }
+
+        struct stat info {};
+        if (fstat(file, &info) != 0) {
+            close(file);
+            throw std::runtime_error("failed to read file size: " + path);
+        }
+        size = static_cast<usize>(info.st_size);
+
+        // an empty file can't be mapped, it stays a null view of size 0
+        if (size > 0) {
+            void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (mapped == MAP_FAILED) {
+                close(file);
+                throw std::runtime_error("failed to map file: " + path);
+            }
+            data = static_cast<const u8 *>(mapped);
+        }
+
+        // the mapping keeps its own reference to the file
+        close(file);
+    }
+
+    MappedFile::~MappedFile() {
+        if (data) {
+            munmap(const_cast<u8 *>(data), size);
+        }
+    }
+#endif
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "types.h"
+
+#include <string>
+
+namespace Engine {
+    // Read only view of a whole file mapped into memory, pages are loaded by the OS as they're touched.
+    class MappedFile {
+    public:
+        // throws when the file can't be opened or mapped
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        const u8 *get_data() const { return data; }
+        usize get_size() const { return size; }
+
+    private:
+        const u8 *data = nullptr;
+        usize size = 0;
+#ifdef _WIN32
+        void *file = nullptr;
+        void *mapping = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,221 @@
+#include "binary_scene.h"
+
+#include "../core/atomic_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace Engine {
+    namespace {
+        constexpr u64 chunk_alignment = 8;
+
+        static_assert(std::is_trivially_copyable_v<SceneFormat::Transform> && sizeof(SceneFormat::Transform) == 36);
+        static_assert(std::is_trivially_copyable_v<SceneFormat::Model> && sizeof(SceneFormat::Model) == 16);
+        static_assert(std::is_trivially_copyable_v<SceneFormat::PointLight> && sizeof(SceneFormat::PointLight) == 20);
+        static_assert(std::is_trivially_copyable_v<SceneFormat::RigidBody> && sizeof(SceneFormat::RigidBody) == 40);
+
+        usize get_element_size(u32 type) {
+            switch (type) {
+                case SceneFormat::STRINGS: return sizeof(char);
+                case SceneFormat::UUIDS: return sizeof(u64);
+                case SceneFormat::PARENTS: return sizeof(u32);
+                case SceneFormat::TAGS: return sizeof(SceneFormat::StringRef);
+                case SceneFormat::TRANSFORMS: return sizeof(SceneFormat::Transform);
+                case SceneFormat::MODELS: return sizeof(SceneFormat::Model);
+                case SceneFormat::POINT_LIGHTS: return sizeof(SceneFormat::PointLight);
+                case SceneFormat::RIGID_BODIES: return sizeof(SceneFormat::RigidBody);
+                default: return 0;
+            }
+        }
+    }
+
+    SceneFormat::StringRef BinarySceneWriter::add_string(const std::string &string) {
+        auto it = string_refs.find(string);
+        if (it != string_refs.end()) {
+            return it->second;
+        }
+
+        const SceneFormat::StringRef ref = append_string(string);
+        string_refs.emplace(string, ref);
+        return ref;
+    }
+
+    SceneFormat::StringRef BinarySceneWriter::append_string(const std::string &string) {
+        const SceneFormat::StringRef ref{static_cast<u32>(strings.size()), static_cast<u32>(string.size())};
+        strings.insert(strings.end(), string.begin(), string.end());
+        return ref;
+    }
+
+    void BinarySceneWriter::reserve(u32 entity_count) {
+        uuids.reserve(entity_count);
+        parents.reserve(entity_count);
+        tags.reserve(entity_count);
+        transforms.reserve(entity_count);
+    }
+
+    u32 BinarySceneWriter::add_entity(u64 uuid, u32 parent, const std::string &tag, const SceneFormat::Transform &transform) {
+        const u32 index = static_cast<u32>(uuids.size());
+        if (parent != SceneFormat::no_parent && parent >= index) {
+            throw std::runtime_error("binary scene entities have to be added after their parent");
+        }
+
+        uuids.push_back(uuid);
+        parents.push_back(parent);
+        // tags are mostly unique, looking each one up would cost more than the bytes it saves
+        tags.push_back(append_string(tag));
+        transforms.push_back(transform);
+        return index;
+    }
+
+    void BinarySceneWriter::add_model(u32 entity, const std::string &path, bool transparent) {
+        models.push_back({entity, add_string(path), transparent ? 1u : 0u});
+    }
+
+    void BinarySceneWriter::add_point_light(u32 entity, const glm::vec3 &color, f32 intensity) {
+        point_lights.push_back({entity, color, intensity});
+    }
+
+    void BinarySceneWriter::add_rigid_body(const SceneFormat::RigidBody &rigid_body) {
+        rigid_bodies.push_back(rigid_body);
+    }
+
+    std::string_view BinarySceneWriter::get_chunk_bytes(SceneFormat::ChunkType type) const {
+        auto bytes = [](const auto &vector) {
+            return std::string_view{reinterpret_cast<const char *>(vector.data()), vector.size() * sizeof(vector[0])};
+        };
+
+        switch (type) {
+            case SceneFormat::STRINGS: return bytes(strings);
+            case SceneFormat::UUIDS: return bytes(uuids);
+            case SceneFormat::PARENTS: return bytes(parents);
+            case SceneFormat::TAGS: return bytes(tags);
+            case SceneFormat::TRANSFORMS: return bytes(transforms);
+            case SceneFormat::MODELS: return bytes(models);
+            case SceneFormat::POINT_LIGHTS: return bytes(point_lights);
+            case SceneFormat::RIGID_BODIES: return bytes(rigid_bodies);
+        }
+        return {};
+    }
+
+    void BinarySceneWriter::write(const std::string &path) const {
+        SceneFormat::Header header{};
+        std::memcpy(header.magic, SceneFormat::magic, sizeof(header.magic));
+        header.version = SceneFormat::version;
+        header.entity_count = static_cast<u32>(uuids.size());
+        header.chunk_count = chunk_count;
+
+        SceneFormat::Chunk chunks[chunk_count];
+        u64 offset = sizeof(SceneFormat::Header) + sizeof(chunks);
+        for (u32 i = 0; i < chunk_count; i++) {
+            const u64 size = get_chunk_bytes(static_cast<SceneFormat::ChunkType>(i)).size();
+            offset = (offset + chunk_alignment - 1) / chunk_alignment * chunk_alignment;
+            chunks[i] = {i, static_cast<u32>(size / get_element_size(i)), offset, size};
+            offset += size;
+        }
+
+        AtomicFile file{path};
+        auto &stream = file.get_stream();
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char *>(chunks), sizeof(chunks));
+        u64 written = sizeof(header) + sizeof(chunks);
+        const char padding[chunk_alignment] = {};
+        for (u32 i = 0; i < chunk_count; i++) {
+            const std::string_view bytes = get_chunk_bytes(static_cast<SceneFormat::ChunkType>(i));
+            stream.write(padding, static_cast<std::streamsize>(chunks[i].offset - written));
+            stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            written = chunks[i].offset + chunks[i].size;
+        }
+        file.commit();
+    }
+
+    BinarySceneReader::BinarySceneReader(const std::string &path) : file{path} {
+        const u8 *data = file.get_data();
+        const usize size = file.get_size();
+
+        SceneFormat::Header header;
+        if (size < sizeof(header)) {
+            throw std::runtime_error("not a binary scene: " + path);
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, SceneFormat::magic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("not a binary scene: " + path);
+        }
+        if (header.version != SceneFormat::version) {
+            throw std::runtime_error("unsupported binary scene version: " + path);
+        }
+        if (size - sizeof(header) < static_cast<u64>(header.chunk_count) * sizeof(SceneFormat::Chunk)) {
+            throw std::runtime_error("binary scene is truncated: " + path);
+        }
+        entity_count = header.entity_count;
+
+        for (u32 i = 0; i < header.chunk_count; i++) {
+            SceneFormat::Chunk chunk;
+            std::memcpy(&chunk, data + sizeof(header) + i * sizeof(SceneFormat::Chunk), sizeof(chunk));
+
+            const usize element_size = get_element_size(chunk.type);
+            if (element_size == 0) {
+                continue;
+            }
+            if (chunk.offset % chunk_alignment != 0 || chunk.offset > size || chunk.size > size - chunk.offset || chunk.size != chunk.count * element_size) {
+                throw std::runtime_error("binary scene has a broken chunk: " + path);
+            }
+            chunks[chunk.type] = chunk;
+        }
+
+        strings = reinterpret_cast<const char *>(data + chunks[SceneFormat::STRINGS].offset);
+        const u32 string_table_size = chunks[SceneFormat::STRINGS].count;
+        auto check_string = [&](SceneFormat::StringRef ref) {
+            if (ref.offset > string_table_size || ref.length > string_table_size - ref.offset) {
+                throw std::runtime_error("binary scene has a broken string: " + path);
+            }
+        };
+
+        for (auto type : {SceneFormat::UUIDS, SceneFormat::PARENTS, SceneFormat::TAGS, SceneFormat::TRANSFORMS}) {
+            if (chunks[type].count != entity_count) {
+                throw std::runtime_error("binary scene is missing entity data: " + path);
+            }
+        }
+
+        // the references are checked once here, users can index with them blindly
+        u32 count = 0;
+        const u32 *parents = get_chunk<u32>(SceneFormat::PARENTS, count);
+        const SceneFormat::StringRef *tags = get_chunk<SceneFormat::StringRef>(SceneFormat::TAGS, count);
+        for (u32 i = 0; i < entity_count; i++) {
+            if (parents[i] != SceneFormat::no_parent && parents[i] >= i) {
+                throw std::runtime_error("binary scene has a parent after its child: " + path);
+            }
+            check_string(tags[i]);
+        }
+
+        // an entity has a component at most once, a chunk listing it twice would be emplaced twice
+        std::vector<u8> seen(entity_count);
+        auto check_entity = [&](u32 entity) {
+            if (entity >= entity_count) {
+                throw std::runtime_error("binary scene references a missing entity: " + path);
+            }
+            if (seen[entity]) {
+                throw std::runtime_error("binary scene references an entity twice: " + path);
+            }
+            seen[entity] = 1;
+        };
+
+        const SceneFormat::Model *models = get_chunk<SceneFormat::Model>(SceneFormat::MODELS, count);
+        for (u32 i = 0; i < count; i++) {
+            check_entity(models[i].entity);
+            check_string(models[i].path);
+        }
+        std::fill(seen.begin(), seen.end(), u8{0});
+        const SceneFormat::PointLight *point_lights = get_chunk<SceneFormat::PointLight>(SceneFormat::POINT_LIGHTS, count);
+        for (u32 i = 0; i < count; i++) {
+            check_entity(point_lights[i].entity);
+        }
+        std::fill(seen.begin(), seen.end(), u8{0});
+        const SceneFormat::RigidBody *rigid_bodies = get_chunk<SceneFormat::RigidBody>(SceneFormat::RIGID_BODIES, count);
+        for (u32 i = 0; i < count; i++) {
+            check_entity(rigid_bodies[i].entity);
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "../core/mapped_file.h"
+#include "../core/types.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+    // Binary scene file, the fast counterpart of the YAML scenes. Entities are numbered in depth first
+    // order, so a parent always comes before its children. Every component type is one chunk holding
+    // a packed array of the structs below, and strings live in a single string table. A reader maps
+    // the file and hands out pointers into it, nothing is parsed.
+    //
+    // Layout, little endian: Header, Chunk[chunk_count], then the chunk data, each chunk 8 byte
+    // aligned. Readers skip chunk types they don't know.
+    namespace SceneFormat {
+        constexpr char magic[4] = {'S', 'S', 'C', 'N'};
+        constexpr u32 version = 1;
+        constexpr u32 no_parent = ~0u;
+
+        enum ChunkType : u32 {
+            STRINGS = 0,      // char, the string table
+            UUIDS = 1,        // u64 per entity
+            PARENTS = 2,      // u32 per entity, index of the parent or no_parent
+            TAGS = 3,         // StringRef per entity
+            TRANSFORMS = 4,   // Transform per entity
+            MODELS = 5,       // Model
+            POINT_LIGHTS = 6, // PointLight
+            RIGID_BODIES = 7, // RigidBody
+        };
+
+        struct Header {
+            char magic[4];
+            u32 version;
+            u32 entity_count;
+            u32 chunk_count;
+        };
+
+        struct Chunk {
+            u32 type;
+            u32 count;
+            u64 offset; // from the start of the file
+            u64 size;
+        };
+
+        struct StringRef {
+            u32 offset;
+            u32 length;
+        };
+
+        struct Transform {
+            glm::vec3 translation;
+            glm::vec3 rotation;
+            glm::vec3 scale;
+        };
+
+        // the per component structs start with the index of their entity
+        struct Model {
+            u32 entity;
+            StringRef path;
+            u32 transparent;
+        };
+
+        struct PointLight {
+            u32 entity;
+            glm::vec3 color;
+            f32 intensity;
+        };
+
+        struct RigidBody {
+            u32 entity;
+            glm::vec3 velocity;
+            glm::vec3 acceleration;
+            f32 mass;
+            f32 radius;
+            u32 is_static;
+        };
+    }
+
+    // Collects a scene in the packed layout of the file. Filling one is a few copies per entity, so
+    // it also serves as the snapshot a scene is saved from on another thread.
+    class BinarySceneWriter {
+    public:
+        static constexpr u32 chunk_count = SceneFormat::RIGID_BODIES + 1;
+
+        void reserve(u32 entity_count);
+
+        // entities have to be added parents first, returns the index of the new one
+        u32 add_entity(u64 uuid, u32 parent, const std::string &tag, const SceneFormat::Transform &transform);
+
+        void add_model(u32 entity, const std::string &path, bool transparent);
+        void add_point_light(u32 entity, const glm::vec3 &color, f32 intensity);
+        void add_rigid_body(const SceneFormat::RigidBody &rigid_body);
+
+        // replaces the file in one step through a temp file, throws when it can't be written
+        void write(const std::string &path) const;
+
+        // the bytes one chunk ends up with in the file
+        std::string_view get_chunk_bytes(SceneFormat::ChunkType type) const;
+
+        u32 get_entity_count() const { return static_cast<u32>(uuids.size()); }
+        const std::vector<u64> &get_uuids() const { return uuids; }
+        const std::vector<u32> &get_parents() const { return parents; }
+        const std::vector<SceneFormat::StringRef> &get_tags() const { return tags; }
+        const std::vector<SceneFormat::Transform> &get_transforms() const { return transforms; }
+        const std::vector<SceneFormat::Model> &get_models() const { return models; }
+        const std::vector<SceneFormat::PointLight> &get_point_lights() const { return point_lights; }
+        const std::vector<SceneFormat::RigidBody> &get_rigid_bodies() const { return rigid_bodies; }
+        std::string_view get_string(SceneFormat::StringRef ref) const { return {strings.data() + ref.offset, ref.length}; }
+
+    private:
+        SceneFormat::StringRef add_string(const std::string &string); // stored once
+        SceneFormat::StringRef append_string(const std::string &string);
+
+        std::vector<char> strings;
+        std::unordered_map<std::string, SceneFormat::StringRef> string_refs; // a string is stored once
+        std::vector<u64> uuids;
+        std::vector<u32> parents;
+        std::vector<SceneFormat::StringRef> tags;
+        std::vector<SceneFormat::Transform> transforms;
+        std::vector<SceneFormat::Model> models;
+        std::vector<SceneFormat::PointLight> point_lights;
+        std::vector<SceneFormat::RigidBody> rigid_bodies;
+    };
+
+    class BinarySceneReader {
+    public:
+        // maps the file and checks the header, the chunk bounds and the entity references (in range,
+        // once per component chunk), throws when anything is off
+        explicit BinarySceneReader(const std::string &path);
+
+        u32 get_entity_count() const { return entity_count; }
+
+        // empty when the chunk isn't in the file
+        template<typename T>
+        const T *get_chunk(SceneFormat::ChunkType type, u32 &count) const {
+            const auto &chunk = chunks[type];
+            count = chunk.count;
+            return reinterpret_cast<const T *>(file.get_data() + chunk.offset);
+        }
+
+        std::string_view get_string(SceneFormat::StringRef ref) const { return {strings + ref.offset, ref.length}; }
+
+    private:
+        MappedFile file;
+        u32 entity_count = 0;
+        SceneFormat::Chunk chunks[BinarySceneWriter::chunk_count] = {};
+        const char *strings = nullptr;
+    };
+}
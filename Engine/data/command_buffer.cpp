@@ -0,0 +1,93 @@
+#include "command_buffer.h"
+#include "entity.h"
+#include "scene.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Engine {
+    namespace {
+        constexpr u32 no_lane = ~0u;
+
+        thread_local u32 recording_lane = no_lane;
+        thread_local u32 recording_key = 0;
+    }
+
+    void CommandBuffer::begin_recording(u32 lane, u32 key) {
+        recording_lane = lane;
+        recording_key = key;
+    }
+
+    void CommandBuffer::end_recording() {
+        recording_lane = no_lane;
+    }
+
+    void CommandBuffer::set_lane_count(u32 lane_count) {
+        // one extra lane for commands recorded outside of a script, only the main thread records there
+        if (lanes.size() < lane_count + 1) {
+            lanes.resize(lane_count + 1);
+        }
+    }
+
+    void CommandBuffer::record(Command command) {
+        if (lanes.empty()) {
+            lanes.resize(1);
+        }
+
+        if (recording_lane == no_lane) {
+            lanes.back().push_back({~0u, std::move(command)});
+        } else {
+            lanes[recording_lane].push_back({recording_key, std::move(command)});
+        }
+    }
+
+    void CommandBuffer::create_entity(const std::string &name, std::function<void(Entity)> init) {
+        record([name, init = std::move(init)](Scene &target) {
+            Entity entity = target.create_entity(name);
+            if (init) {
+                init(entity);
+            }
+        });
+    }
+
+    void CommandBuffer::destroy_entity(entt::entity entity) {
+        record([entity](Scene &target) {
+            if (target.registry.valid(entity)) {
+                target.destroy_entity({entity, &target});
+            }
+        });
+    }
+
+    void CommandBuffer::set_parent(entt::entity child, entt::entity parent) {
+        record([child, parent](Scene &target) {
+            if (target.registry.valid(child) && (parent == entt::null || target.registry.valid(parent))) {
+                target.set_parent({child, &target}, {parent, &target});
+            }
+        });
+    }
+
+    void CommandBuffer::record_for(entt::entity entity, std::function<void(entt::registry &, entt::entity)> command) {
+        record([entity, command = std::move(command)](Scene &target) {
+            if (target.registry.valid(entity)) {
+                command(target.registry, entity);
+            }
+        });
+    }
+
+    void CommandBuffer::flush() {
+        merged.clear();
+        for (auto &lane : lanes) {
+            std::move(lane.begin(), lane.end(), std::back_inserter(merged));
+            lane.clear();
+        }
+
+        // a script runs on one thread, so stable keeps its commands in the order it recorded them
+        std::stable_sort(merged.begin(), merged.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+
+        // commands may record more commands, those run at the next flush
+        for (auto &entry : merged) {
+            entry.command(scene);
+        }
+        merged.clear();
+    }
+}
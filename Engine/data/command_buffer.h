@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../core/types.h"
+
+#include <entt/entt.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+    class Scene;
+    class Entity;
+
+    // Structural changes (creating and destroying entities, reparenting, adding and removing
+    // components) can't happen while scripts run in parallel, they are recorded here and applied by
+    // Scene::update once all scripts finished. Every thread records into its own lane tagged with the
+    // position of the script that recorded it, flush() replays them in script order, so the result
+    // doesn't depend on which thread ran which script.
+    //
+    // Commands on an entity that is gone by the time they run are dropped.
+    class CommandBuffer {
+    public:
+        using Command = std::function<void(Scene &)>;
+
+        explicit CommandBuffer(Scene &_scene) : scene{_scene} {}
+
+        CommandBuffer(const CommandBuffer &) = delete;
+        CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+        void record(Command command);
+
+        // init runs on the new entity when the command is applied
+        void create_entity(const std::string &name, std::function<void(Entity)> init = {});
+        void destroy_entity(entt::entity entity);
+        void set_parent(entt::entity child, entt::entity parent);
+
+        template<typename T>
+        void add_component(entt::entity entity, T component) {
+            // std::function has to be copyable, move only components travel behind a shared_ptr
+            auto payload = std::make_shared<T>(std::move(component));
+            record_for(entity, [payload](entt::registry &registry, entt::entity e) { registry.emplace_or_replace<T>(e, std::move(*payload)); });
+        }
+
+        template<typename T>
+        void remove_component(entt::entity entity) {
+            record_for(entity, [](entt::registry &registry, entt::entity e) { registry.remove<T>(e); });
+        }
+
+        // Commands recorded on this thread until end_recording() go to lane and are ordered by key.
+        // Without it they go to the last lane after everything the scripts recorded.
+        static void begin_recording(u32 lane, u32 key);
+        static void end_recording();
+
+        // makes room for lane_count lanes, called before the scripts run
+        void set_lane_count(u32 lane_count);
+
+        // applies everything recorded so far, on the main thread with nothing else running
+        void flush();
+
+    private:
+        struct Entry {
+            u32 key;
+            Command command;
+        };
+
+        void record_for(entt::entity entity, std::function<void(entt::registry &, entt::entity)> command);
+
+        Scene &scene;
+        std::vector<std::vector<Entry>> lanes;
+        std::vector<Entry> merged; // scratch for flush
+    };
+}
@@ -40,7 +40,10 @@ namespace Engine {
         glm::vec3 translation = {0.0f, 0.0f, 0.0f};
         glm::vec3 rotation = {0.0f, 0.0f, 0.0f};
         glm::vec3 scale = {1.0f, 1.0f, 1.0f};
+        // world space, kept up to date by Scene::update_transforms
         glm::mat4 model_matrix = glm::mat4(1.0);
+        glm::mat4 normal_matrix = glm::mat4(1.0);
+        u32 version = 0; // bumped whenever the matrices above change
         bool is_dirty = true;
 
         TransformComponent() = default;
@@ -58,6 +61,7 @@ namespace Engine {
         std::shared_ptr<Model> model{};
         std::string path;
         bool transparent = false;
+        u32 transform_index = 0; // slot in the TransformBuffer, assigned every frame
 
         ModelComponent() = default;
         ModelComponent(const std::shared_ptr<Model> &_model) { model = _model; path = _model->getPath(); }
@@ -105,18 +109,27 @@ namespace Engine {
         }
     };
 
+    // Intrusive links of the scene hierarchy, the children of an entity form a doubly linked list
+    // through their siblings. Only Scene changes them (set_parent, destroy_entity, clone_entity).
     struct RelationshipComponent {
         entt::entity parent{entt::null};
-        std::vector<entt::entity> children{};
+        entt::entity first_child{entt::null};
+        entt::entity next_sibling{entt::null};
+        entt::entity prev_sibling{entt::null};
+        u32 depth = 0; // 0 for roots
 
         RelationshipComponent() = default;
     };
 
     struct PhysicsComponent {
-        glm::vec3 linear_velocity;
+        glm::vec3 linear_velocity = {0.0f, 0.0f, 0.0f};
         f32 inverse_mass = 0.0f;
         f32 elasticity = 0.0f;
-        std::unique_ptr<Shape> shape;
+        std::shared_ptr<const Shape> shape; // immutable, shared between copies and prefab instances
+
+        // the translation PhysicsSystem last wrote or loaded, anything else moved the body and it
+        // gets reloaded (TransformComponent::is_dirty is cleared every frame, also for physics writes)
+        glm::vec3 synced_translation = {0.0f, 0.0f, 0.0f};
 
         PhysicsComponent() = default;
 
@@ -0,0 +1,48 @@
+#include "prefab.h"
+#include "entity.h"
+#include "scene.h"
+
+#include <unordered_map>
+
+namespace Engine {
+    Prefab Prefab::from_entity(Scene &scene, Entity root) {
+        Prefab prefab;
+        std::unordered_map<entt::entity, u32> indices;
+
+        for (entt::entity node = root; node != entt::null; node = scene.next_in_subtree(root, node)) {
+            Entity entity{node, &scene};
+            const auto &rc = entity.get_component<RelationshipComponent>();
+            const auto &tc = entity.get_component<TransformComponent>();
+
+            Node prefab_node;
+            prefab_node.tag = entity.get_component<TagComponent>().tag;
+            prefab_node.parent = node == static_cast<entt::entity>(root) ? no_parent : indices.at(rc.parent);
+            prefab_node.translation = tc.translation;
+            prefab_node.rotation = tc.rotation;
+            prefab_node.scale = tc.scale;
+
+            if (entity.has_component<ModelComponent>()) {
+                const auto &mc = entity.get_component<ModelComponent>();
+                prefab_node.model = mc.model;
+                prefab_node.transparent = mc.transparent;
+            }
+            if (entity.has_component<PointLightComponent>()) {
+                prefab_node.point_light = entity.get_component<PointLightComponent>();
+            }
+            if (entity.has_component<RigidBodyComponent>()) {
+                prefab_node.rigid_body = entity.get_component<RigidBodyComponent>();
+            }
+            if (entity.has_component<PhysicsComponent>()) {
+                const auto &ph = entity.get_component<PhysicsComponent>();
+                prefab_node.shape = ph.shape;
+                prefab_node.inverse_mass = ph.inverse_mass;
+                prefab_node.elasticity = ph.elasticity;
+            }
+
+            indices[node] = static_cast<u32>(prefab.nodes.size());
+            prefab.nodes.push_back(std::move(prefab_node));
+        }
+
+        return prefab;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../core/types.h"
+#include "components.h"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Engine {
+    class Scene;
+    class Entity;
+    class NativeScript;
+
+    // Template of an entity subtree for Scene::instantiate. What doesn't change between copies is
+    // held by pointer, the model, the physics shape and the script type (as a factory, a script is
+    // bound to its entity), so a thousand instances share one of each and only own their transform,
+    // links and the small per instance values.
+    struct Prefab {
+        static constexpr u32 no_parent = ~0u;
+
+        using ScriptFactory = std::function<std::shared_ptr<NativeScript>(entt::entity, Scene &)>;
+
+        struct Node {
+            std::string tag;
+            u32 parent = no_parent; // index of an earlier node, no_parent only for the first one
+
+            glm::vec3 translation = {0.0f, 0.0f, 0.0f};
+            glm::vec3 rotation = {0.0f, 0.0f, 0.0f};
+            glm::vec3 scale = {1.0f, 1.0f, 1.0f};
+
+            std::shared_ptr<Model> model;
+            bool transparent = false;
+
+            std::optional<PointLightComponent> point_light;
+            std::optional<RigidBodyComponent> rigid_body;
+
+            // physics is added when there is a shape
+            std::shared_ptr<const Shape> shape;
+            f32 inverse_mass = 0.0f;
+            f32 elasticity = 0.0f;
+
+            ScriptFactory script;
+        };
+
+        // depth first, siblings in order, the first node is the root
+        std::vector<Node> nodes;
+
+        // Captures the subtree of root, models and shapes end up shared with it. Scripts are bound to
+        // their entity and can't be copied, set Node::script for them.
+        static Prefab from_entity(Scene &scene, Entity root);
+
+        // factory for scripts constructible from (entt::entity, Scene &)
+        template<typename T>
+        static ScriptFactory script_factory() {
+            return [](entt::entity entity, Scene &scene) { return std::make_shared<T>(entity, scene); };
+        }
+    };
+}
@@ -1,11 +1,42 @@
 #include "scene.h"
 #include "components.h"
 #include "entity.h"
+#include "scene_query.h"
+#include "transform_hierarchy.h"
+#include "command_buffer.h"
+#include "prefab.h"
+#include "../scripting/script_scheduler.h"
 
 #include <glm/glm.hpp>
 
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
 namespace Engine {
-    Scene::Scene() = default;
+    namespace {
+        // the entities and the components of a storage iterate in the same order
+        template<typename T>
+        void copy_storage(entt::registry &destination, entt::registry &source) {
+            auto &storage = source.storage<T>();
+            const entt::sparse_set &entities = storage;
+            destination.insert<T>(entities.begin(), entities.end(), storage.begin());
+        }
+    }
+
+    Scene::Scene() : scene_query{std::make_unique<SceneQuery>(*this)}, transform_hierarchy{std::make_unique<TransformHierarchy>(*this)},
+        command_buffer{std::make_unique<CommandBuffer>(*this)}, script_scheduler{std::make_unique<ScriptScheduler>(*this)} {
+        // the renderers, lights and physics each walk their component next to the transform every
+        // frame, owning the component keeps those entities at the front of its storage
+        group<ModelComponent>(entt::get<TransformComponent>);
+        group<PointLightComponent>(entt::get<TransformComponent>);
+        group<PhysicsComponent>(entt::get<TransformComponent>);
+
+        // entities can go away through any registry.destroy, not just destroy_entity
+        registry.on_destroy<IDComponent>().connect<&Scene::on_id_destroyed>(*this);
+    }
     Scene::~Scene() = default;
 
     Entity Scene::create_entity(const std::string &name) {
@@ -13,7 +44,12 @@ namespace Engine {
     }
 
     Entity Scene::create_entity_with_UUID(UUID uuid, const std::string &name) {
+        if (entity_ids.find(uuid) != entt::null) {
+            throw std::runtime_error("an entity with UUID " + std::to_string(static_cast<u64>(uuid)) + " already exists");
+        }
+
         Entity entity = {registry.create(), this};
+        entity_ids.insert(uuid, entity);
         entity.add_component<IDComponent>(uuid);
         entity.add_component<TransformComponent>();
         entity.add_component<RelationshipComponent>();
@@ -22,80 +58,300 @@ namespace Engine {
         return entity;
     }
 
+    Entity Scene::find_entity(UUID uuid) {
+        return {entity_ids.find(uuid), this};
+    }
+
+    void Scene::reserve(usize count) {
+        entity_ids.reserve(entity_ids.size() + count);
+    }
+
+    void Scene::on_id_destroyed(entt::registry &, entt::entity entity) {
+        entity_ids.erase(registry.get<IDComponent>(entity).ID);
+    }
+
     void Scene::destroy_entity(Entity entity) {
-        registry.destroy(entity);
+        detach(entity);
+
+        subtree.clear();
+        for (entt::entity node = entity; node != entt::null; node = next_in_subtree(entity, node)) {
+            subtree.push_back(node);
+        }
+        registry.destroy(subtree.begin(), subtree.end());
     }
 
-    void Scene::update_lights_ubo(GlobalUbo &ubo) {
-        registry.each([&](auto entityID) {
-            Entity entity = {entityID, this};
-            if (!entity)
-                return;
+    Entity Scene::clone_entity(Entity entity, Entity parent) {
+        // collected up front, parent may be inside the subtree and the copies would be walked as well
+        std::vector<entt::entity> nodes;
+        for (entt::entity node = entity; node != entt::null; node = next_in_subtree(entity, node)) {
+            nodes.push_back(node);
+        }
 
-            if (entity.has_component<PointLightComponent>()) {
-                auto light = entity.get_component<PointLightComponent>();
-                auto position = entity.get_component<TransformComponent>().translation;
+        // depth first, so a parent and the previous sibling are always copied before a node
+        std::unordered_map<entt::entity, entt::entity> clones;
+        for (entt::entity node : nodes) {
+            // creating the copy can move the component storages, copy what's needed first
+            const RelationshipComponent rc = registry.get<RelationshipComponent>(node);
+            const TransformComponent tc = registry.get<TransformComponent>(node);
+            const std::string tag = registry.get<TagComponent>(node).tag;
 
-                ubo.point_lights[ubo.num_point_lights].color = glm::vec4(light.color, light.intensity);
-                ubo.point_lights[ubo.num_point_lights].position = glm::vec4(position, 1.0);
+            Entity clone = create_entity(tag);
+            auto &clone_tc = clone.get_component<TransformComponent>();
+            clone_tc.translation = tc.translation;
+            clone_tc.rotation = tc.rotation;
+            clone_tc.scale = tc.scale;
 
-                ubo.num_point_lights += 1;
+            if (registry.all_of<ModelComponent>(node)) {
+                clone.add_component<ModelComponent>(ModelComponent{registry.get<ModelComponent>(node)});
             }
-        });
+            if (registry.all_of<PointLightComponent>(node)) {
+                clone.add_component<PointLightComponent>(PointLightComponent{registry.get<PointLightComponent>(node)});
+            }
+            if (registry.all_of<RigidBodyComponent>(node)) {
+                clone.add_component<RigidBodyComponent>(RigidBodyComponent{registry.get<RigidBodyComponent>(node)});
+            }
+            if (registry.all_of<CameraComponent>(node)) {
+                clone.add_component<CameraComponent>(CameraComponent{registry.get<CameraComponent>(node)});
+            }
+            if (registry.all_of<PhysicsComponent>(node)) {
+                // shapes are immutable, the copy shares it
+                clone.add_component<PhysicsComponent>(PhysicsComponent{registry.get<PhysicsComponent>(node)});
+            }
+
+            if (node == static_cast<entt::entity>(entity)) {
+                attach(clone, parent, entt::null);
+            } else {
+                attach(clone, clones.at(rc.parent), rc.prev_sibling == entt::null ? entt::null : clones.at(rc.prev_sibling));
+            }
+            clones[node] = clone;
+        }
+
+        transform_hierarchy->mark_dirty();
+        return {clones.at(entity), this};
     }
 
-    void Scene::update(const float &deltaTime) {
-        registry.each([&](auto entityID) {
-            Entity entity = {entityID, this};
-            if (!entity)
-                return;
+    std::vector<Entity> Scene::instantiate(const Prefab &prefab, u32 count, Entity parent) {
+        const auto &nodes = prefab.nodes;
+        const u32 node_count = static_cast<u32>(nodes.size());
+        if (node_count == 0 || count == 0) {
+            return {};
+        }
+
+        // the previous sibling of every node, copies are linked in prefab order
+        std::vector<u32> previous_siblings(node_count, Prefab::no_parent);
+        std::vector<u32> last_children(node_count, Prefab::no_parent);
+        for (u32 i = 0; i < node_count; i++) {
+            const u32 node_parent = nodes[i].parent;
+            if ((i == 0) != (node_parent == Prefab::no_parent) || (i > 0 && node_parent >= i)) {
+                throw std::runtime_error("prefab nodes have to be depth first with the root first");
+            }
+            if (i > 0) {
+                previous_siblings[i] = last_children[node_parent];
+                last_children[node_parent] = i;
+            }
+        }
+
+        // node major, the copies of node i are [i * count, (i + 1) * count)
+        std::vector<entt::entity> entities(static_cast<usize>(node_count) * count);
+        registry.create(entities.begin(), entities.end());
+        entity_ids.reserve(entity_ids.size() + entities.size());
+
+        for (u32 i = 0; i < node_count; i++) {
+            const Prefab::Node &node = nodes[i];
+            const auto first = entities.begin() + static_cast<std::ptrdiff_t>(i) * count;
+            const auto last = first + count;
+
+            registry.insert<IDComponent>(first, last);
+            for (auto it = first; it != last; it++) {
+                // each copy needs its own UUID, the inserted default is the same value everywhere
+                auto &id = registry.get<IDComponent>(*it);
+                id.ID = UUID();
+                entity_ids.insert(id.ID, *it);
+            }
+
+            registry.insert<TagComponent>(first, last, TagComponent{node.tag});
+
+            TransformComponent tc;
+            tc.translation = node.translation;
+            tc.rotation = node.rotation;
+            tc.scale = node.scale;
+            registry.insert<TransformComponent>(first, last, tc);
+
+            registry.insert<RelationshipComponent>(first, last);
+            for (u32 k = 0; k < count; k++) {
+                if (i == 0) {
+                    attach(first[k], parent, entt::null);
+                } else {
+                    const u32 previous = previous_siblings[i];
+                    attach(first[k], entities[static_cast<usize>(node.parent) * count + k], previous == Prefab::no_parent ? entt::null : entities[static_cast<usize>(previous) * count + k]);
+                }
+            }
+
+            if (node.model) {
+                ModelComponent mc{node.model};
+                mc.transparent = node.transparent;
+                registry.insert<ModelComponent>(first, last, mc);
+            }
+            if (node.point_light) {
+                registry.insert<PointLightComponent>(first, last, *node.point_light);
+            }
+            if (node.rigid_body) {
+                registry.insert<RigidBodyComponent>(first, last, *node.rigid_body);
+            }
+            if (node.shape) {
+                PhysicsComponent ph;
+                ph.inverse_mass = node.inverse_mass;
+                ph.elasticity = node.elasticity;
+                ph.shape = node.shape;
+                registry.insert<PhysicsComponent>(first, last, ph);
+            }
+            if (node.script) {
+                for (auto it = first; it != last; it++) {
+                    registry.emplace<ScriptComponent>(*it, node.script(*it, *this));
+                }
+            }
+        }
+
+        transform_hierarchy->mark_dirty();
+
+        std::vector<Entity> roots;
+        roots.reserve(count);
+        for (u32 k = 0; k < count; k++) {
+            roots.push_back({entities[k], this});
+        }
+        return roots;
+    }
+
+    std::shared_ptr<Scene> Scene::copy() {
+        auto scene = std::make_shared<Scene>();
+
+        // every entity has an ID, a fresh registry hands the hinted handles back unchanged
+        for (auto entity : view<IDComponent>()) {
+            scene->registry.create(entity);
+        }
+        scene->entity_ids = entity_ids;
 
-            if (entity.has_component<ScriptComponent>()) {
-                auto& script = entity.get_component<ScriptComponent>();
-                script.script->update(deltaTime);
+        copy_storage<IDComponent>(scene->registry, registry);
+        copy_storage<TagComponent>(scene->registry, registry);
+        copy_storage<TransformComponent>(scene->registry, registry);
+        copy_storage<RelationshipComponent>(scene->registry, registry);
+        copy_storage<ModelComponent>(scene->registry, registry);
+        copy_storage<PointLightComponent>(scene->registry, registry);
+        copy_storage<RigidBodyComponent>(scene->registry, registry);
+        copy_storage<CameraComponent>(scene->registry, registry);
+        copy_storage<PhysicsComponent>(scene->registry, registry);
+
+        view<ScriptComponent>().each([&](auto entity, ScriptComponent &sc) {
+            if (auto script = sc.script ? sc.script->clone(entity, *scene) : nullptr) {
+                scene->registry.emplace<ScriptComponent>(entity, script);
             }
         });
+
+        return scene;
     }
 
-    void Scene::update_children(Entity entity) {
-        for(auto& childID : entity.get_component<RelationshipComponent>().children) {
-            Entity child = {childID, this};
-            if (!entity)
-                return;
+    void Scene::set_parent(Entity child, Entity parent) {
+        // only an entity deeper than child can be below it
+        const u32 child_depth = registry.get<RelationshipComponent>(child).depth;
+        for (entt::entity ancestor = parent; ancestor != entt::null; ancestor = registry.get<RelationshipComponent>(ancestor).parent) {
+            if (ancestor == static_cast<entt::entity>(child)) {
+                throw std::runtime_error("an entity can't be parented to itself or one of its children");
+            }
+            if (registry.get<RelationshipComponent>(ancestor).depth <= child_depth) {
+                break;
+            }
+        }
 
-            auto& e_tc = entity.get_component<TransformComponent>();
-            glm::mat4 rotation = glm::toMat4(glm::quat(e_tc.rotation));
+        detach(child);
+        attach(child, parent, entt::null);
 
-            auto& tc = child.get_component<TransformComponent>();
-            tc.model_matrix = tc.calculate_matrix() * rotation * glm::translate(glm::mat4(1.0f), e_tc.translation) * glm::scale(glm::mat4(1.0f), e_tc.scale);
-            if(!child.get_component<RelationshipComponent>().children.empty()) {
-                update_children(child);
+        child.get_component<TransformComponent>().is_dirty = true;
+        transform_hierarchy->mark_dirty();
+    }
+
+    void Scene::detach(entt::entity entity) {
+        auto &rc = registry.get<RelationshipComponent>(entity);
+        if (rc.prev_sibling != entt::null) {
+            registry.get<RelationshipComponent>(rc.prev_sibling).next_sibling = rc.next_sibling;
+        } else if (rc.parent != entt::null) {
+            registry.get<RelationshipComponent>(rc.parent).first_child = rc.next_sibling;
+        }
+        if (rc.next_sibling != entt::null) {
+            registry.get<RelationshipComponent>(rc.next_sibling).prev_sibling = rc.prev_sibling;
+        }
+
+        rc.parent = entt::null;
+        rc.next_sibling = entt::null;
+        rc.prev_sibling = entt::null;
+    }
+
+    void Scene::attach(entt::entity entity, entt::entity parent, entt::entity after) {
+        auto &rc = registry.get<RelationshipComponent>(entity);
+        rc.parent = parent;
+
+        if (parent != entt::null) {
+            auto &parent_rc = registry.get<RelationshipComponent>(parent);
+            rc.prev_sibling = after;
+            if (after != entt::null) {
+                auto &after_rc = registry.get<RelationshipComponent>(after);
+                rc.next_sibling = after_rc.next_sibling;
+                after_rc.next_sibling = entity;
+            } else {
+                rc.next_sibling = parent_rc.first_child;
+                parent_rc.first_child = entity;
+            }
+            if (rc.next_sibling != entt::null) {
+                registry.get<RelationshipComponent>(rc.next_sibling).prev_sibling = entity;
             }
         }
+
+        const u32 depth = parent != entt::null ? registry.get<RelationshipComponent>(parent).depth + 1 : 0;
+        if (rc.depth == depth) {
+            return;
+        }
+
+        // the whole subtree moves by the same number of levels
+        const i64 shift = static_cast<i64>(depth) - static_cast<i64>(rc.depth);
+        for (entt::entity node = entity; node != entt::null; node = next_in_subtree(entity, node)) {
+            auto &node_rc = registry.get<RelationshipComponent>(node);
+            node_rc.depth = static_cast<u32>(static_cast<i64>(node_rc.depth) + shift);
+        }
     }
 
-    void Scene::update_transforms() {
-        registry.each([&](auto entityID) {
-            Entity entity = {entityID, this};
-            if (!entity)
-                return;
-
-            if (entity.has_component<RelationshipComponent>()) {
-                if(entity.get_component<TransformComponent>().is_dirty) {
-                    glm::mat4 parentMatrix = glm::mat4(1.0);
-                    if (entity.get_component<RelationshipComponent>().parent != entt::null) {
-                        Entity parent{entity.get_component<RelationshipComponent>().parent, this};
-                        auto& tc = parent.get_component<TransformComponent>();
-                        glm::mat4 rotation = glm::toMat4(glm::quat(tc.rotation));
-
-                        parentMatrix = rotation * glm::translate(glm::mat4(1.0f), tc.translation) * glm::scale(glm::mat4(1.0f), tc.scale);
-                    }
-                    auto& tc = entity.get_component<TransformComponent>();
-                    tc.model_matrix = tc.calculate_matrix() * parentMatrix;
-                    tc.is_dirty = false;
-                    update_children(entity);
-                }
+    entt::entity Scene::next_in_subtree(entt::entity root, entt::entity entity) {
+        const auto &rc = registry.get<RelationshipComponent>(entity);
+        if (rc.first_child != entt::null) {
+            return rc.first_child;
+        }
+
+        // no children, move on to the next sibling of the closest node inside root that has one
+        while (entity != root) {
+            const auto &node_rc = registry.get<RelationshipComponent>(entity);
+            if (node_rc.next_sibling != entt::null) {
+                return node_rc.next_sibling;
             }
+            entity = node_rc.parent;
+        }
+        return entt::null;
+    }
+
+    void Scene::update_lights_ubo(GlobalUbo &ubo) {
+        group<PointLightComponent>(entt::get<TransformComponent>).each([&](auto, PointLightComponent &light, TransformComponent &tc) {
+            ubo.point_lights[ubo.num_point_lights].color = glm::vec4(light.color, light.intensity);
+            ubo.point_lights[ubo.num_point_lights].position = glm::vec4(tc.translation, 1.0);
+
+            ubo.num_point_lights += 1;
         });
     }
+
+    void Scene::update(const float &deltaTime) {
+        script_scheduler->update(deltaTime);
+        command_buffer->flush();
+    }
+
+    void Scene::update_transforms() {
+        // the query is built from the world matrices, they have to be current first
+        transform_hierarchy->update();
+        scene_query->update();
+    }
 }
\ No newline at end of file
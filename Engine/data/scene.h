@@ -1,14 +1,23 @@
 #pragma once
 
 #include "../core/UUID.h"
+#include "uuid_map.h"
 
 #include <entt/entt.hpp>
 
+#include <memory>
+#include <vector>
+
 #include "../core/timestamp.h"
 #include "../graphics/frame_info.h"
 
 namespace Engine {
+    class CommandBuffer;
     class Entity;
+    struct Prefab;
+    class ScriptScheduler;
+    class SceneQuery;
+    class TransformHierarchy;
 
     class Scene {
     public:
@@ -16,17 +25,69 @@ namespace Engine {
         ~Scene();
 
         Entity create_entity(const std::string &name = std::string());
+        // throws when the UUID is already taken
         Entity create_entity_with_UUID(UUID uuid, const std::string &name = std::string());
+        // destroys the entity together with everything below it
         void destroy_entity(Entity entity);
 
+        // a null Entity when nothing has the UUID
+        Entity find_entity(UUID uuid);
+
+        // makes room in the UUID lookup for count more entities before a scene is loaded
+        void reserve(usize count);
+
+        // Copies the entity and everything below it under parent (a root for a null parent). The
+        // copies get new UUIDs, scripts are bound to their entity and aren't copied.
+        Entity clone_entity(Entity entity, Entity parent = {});
+
+        // Creates count copies of the prefab under parent and returns their roots. Every storage grows
+        // once per prefab node for all copies together, the instances share models, shapes and script
+        // types with the prefab. Throws when the prefab nodes aren't depth first.
+        std::vector<Entity> instantiate(const Prefab &prefab, u32 count = 1, Entity parent = {});
+
+        // Copy of the whole scene for play mode. Entity handles and UUIDs stay the same, so links and
+        // anything else holding an entity stay valid in the copy. Components are copied a storage at a
+        // time, models and shapes are shared. Scripts are recreated through NativeScript::clone().
+        std::shared_ptr<Scene> copy();
+
+        // moves child under parent, a null parent makes it a root, throws when parent is below child
+        void set_parent(Entity child, Entity parent);
+
         void update_lights_ubo(GlobalUbo &ubo);
+        // runs the scripts, then applies the structural changes they recorded
         void update(const float &deltaTime);
         void update_transforms();
 
+        // Typed iteration over the entities that have all the given components, in packed storage order,
+        // instead of walking every entity and probing its components. Scene() sets up the owning
+        // groups the systems run every frame, a component can only be owned by one group.
+        template<typename... Components>
+        auto view() { return registry.view<Components...>(); }
+
+        template<typename... Owned, typename... Get>
+        auto group(entt::get_t<Get...> get = entt::get_t<Get...>{}) { return registry.group<Owned...>(get); }
+
+        CommandBuffer &get_commands() { return *command_buffer; }
+
+        SceneQuery &get_query() { return *scene_query; }
+        const SceneQuery &get_query() const { return *scene_query; }
+
     private:
-        void update_children(Entity entity);
+        // unlinks entity from its parent and siblings, its subtree stays attached to it
+        void detach(entt::entity entity);
+        // links a detached entity under parent right after the sibling after, or first for entt::null
+        void attach(entt::entity entity, entt::entity parent, entt::entity after);
+        // the entity after entity in a depth first walk of the subtree of root, entt::null at the end
+        entt::entity next_in_subtree(entt::entity root, entt::entity entity);
+        void on_id_destroyed(entt::registry &registry, entt::entity entity);
 
         entt::registry registry;
+        UUIDMap entity_ids;
+        std::unique_ptr<SceneQuery> scene_query; // after the registry, it hooks into its signals
+        std::unique_ptr<TransformHierarchy> transform_hierarchy;
+        std::unique_ptr<CommandBuffer> command_buffer;
+        std::unique_ptr<ScriptScheduler> script_scheduler;
+        std::vector<entt::entity> subtree; // scratch for destroy_entity
 
         friend class Entity;
         friend class SceneSerializer;
@@ -38,5 +99,10 @@ namespace Engine {
         friend class ShadowSystem;
         friend class App;
         friend class PhysicsSystem;
+        friend class SceneQuery;
+        friend class TransformHierarchy;
+        friend class CommandBuffer;
+        friend class ScriptScheduler;
+        friend struct Prefab;
     };
 }
\ No newline at end of file
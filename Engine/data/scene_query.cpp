@@ -0,0 +1,349 @@
+#include "scene_query.h"
+
+#include "scene.h"
+#include "components.h"
+
+#include "../physics/gjk.h"
+#include "../physics/intersect.h"
+#include "../core/job_system.h"
+
+namespace Engine {
+    // Slab test returning the entry distance and the normal of the face that was hit.
+    static bool ray_box(const AABB &box, const glm::vec3 &origin, const glm::vec3 &direction, f32 max_distance, f32 &t, glm::vec3 &normal) {
+        const glm::vec3 inverse_direction = 1.0f / direction;
+        if (!box.ray_intersects(origin, inverse_direction, max_distance, t)) {
+            return false;
+        }
+
+        if (t <= 0.0f) {
+            normal = -direction;
+            return true;
+        }
+
+        const glm::vec3 t_min = glm::min((box.min - origin) * inverse_direction, (box.max - origin) * inverse_direction);
+        glm::length_t axis = 0;
+        if (t_min.y > t_min[axis]) { axis = 1; }
+        if (t_min.z > t_min[axis]) { axis = 2; }
+
+        normal = glm::vec3{0.0f};
+        normal[axis] = direction[axis] > 0.0f ? -1.0f : 1.0f;
+        return true;
+    }
+
+    SceneQuery::SceneQuery(Scene &_scene) : scene{_scene} {
+        auto &registry = scene.registry;
+        registry.on_construct<ModelComponent>().connect<&SceneQuery::on_component_changed>(*this);
+        registry.on_destroy<ModelComponent>().connect<&SceneQuery::on_component_changed>(*this);
+        registry.on_construct<PhysicsComponent>().connect<&SceneQuery::on_component_changed>(*this);
+        registry.on_destroy<PhysicsComponent>().connect<&SceneQuery::on_component_changed>(*this);
+    }
+
+    SceneQuery::~SceneQuery() {
+        auto &registry = scene.registry;
+        registry.on_construct<ModelComponent>().disconnect<&SceneQuery::on_component_changed>(*this);
+        registry.on_destroy<ModelComponent>().disconnect<&SceneQuery::on_component_changed>(*this);
+        registry.on_construct<PhysicsComponent>().disconnect<&SceneQuery::on_component_changed>(*this);
+        registry.on_destroy<PhysicsComponent>().disconnect<&SceneQuery::on_component_changed>(*this);
+    }
+
+    // The components are still attached while on_destroy runs, so the entry is rebuilt on the next update.
+    void SceneQuery::on_component_changed(entt::registry &, entt::entity entity) {
+        pending.push_back(entity);
+    }
+
+    void SceneQuery::update() {
+        for (auto entity : pending) {
+            refresh(entity);
+        }
+        pending.clear();
+
+        scene.group<ModelComponent>(entt::get<TransformComponent>).each([&](auto entity, ModelComponent &mc, TransformComponent &tn) {
+            auto it = entries.find(entity);
+            if (it == entries.end() || it->second.version != tn.version || it->second.model != mc.model.get()) {
+                refresh(entity);
+            }
+        });
+
+        // the shape pointer is cached, a swapped shape has to be picked up before anything queries it
+        scene.group<PhysicsComponent>(entt::get<TransformComponent>).each([&](auto entity, PhysicsComponent &ph, TransformComponent &tn) {
+            auto it = entries.find(entity);
+            if (it == entries.end() || it->second.version != tn.version || it->second.shape != ph.shape.get()) {
+                refresh(entity);
+            }
+        });
+    }
+
+    void SceneQuery::refresh(entt::entity entity) {
+        auto &registry = scene.registry;
+        if (!registry.valid(entity)) {
+            remove(entity);
+            return;
+        }
+
+        auto *tn = registry.try_get<TransformComponent>(entity);
+        auto *mc = registry.try_get<ModelComponent>(entity);
+        auto *ph = registry.try_get<PhysicsComponent>(entity);
+
+        Entry entry{};
+        if (tn) {
+            entry.version = tn->version;
+        }
+
+        // the world matrix is the one TransformHierarchy cached, the local transform of a child is
+        // relative to its parent
+        if (tn && mc && mc->model && mc->model->bounds.is_valid()) {
+            const glm::mat4 &model_to_world = tn->model_matrix;
+            entry.model = mc->model.get();
+            entry.model_bounds = mc->model->bounds;
+            entry.model_world_bounds = entry.model_bounds.transformed(model_to_world);
+            entry.world_to_model = glm::inverse(model_to_world);
+            entry.bounds = AABB::merge(entry.bounds, entry.model_world_bounds);
+            entry.flags |= MODELS;
+        }
+
+        if (tn && ph && ph->shape) {
+            entry.shape = ph->shape.get();
+            entry.shape_position = glm::vec3{tn->model_matrix[3]};
+            entry.bounds = AABB::merge(entry.bounds, entry.shape->get_bounds(entry.shape_position));
+            entry.flags |= PHYSICS;
+        }
+
+        if (entry.flags == 0) {
+            remove(entity);
+            return;
+        }
+
+        auto it = entries.find(entity);
+        if (it == entries.end()) {
+            entry.proxy = tree.create_proxy(entry.bounds, entity);
+            entries.emplace(entity, entry);
+            return;
+        }
+
+        entry.proxy = it->second.proxy;
+        tree.move_proxy(entry.proxy, entry.bounds, entry.bounds.center() - it->second.bounds.center());
+        it->second = entry;
+    }
+
+    void SceneQuery::remove(entt::entity entity) {
+        auto it = entries.find(entity);
+        if (it == entries.end()) {
+            return;
+        }
+
+        tree.destroy_proxy(it->second.proxy);
+        entries.erase(it);
+    }
+
+    bool SceneQuery::raycast_entry(const Entry &entry, const Ray &ray, f32 max_distance, u32 flags, QueryHit &hit) const {
+        bool has_hit = false;
+
+        if ((flags & PHYSICS) && (entry.flags & PHYSICS)) {
+            f32 t = 0.0f;
+            glm::vec3 normal;
+            if (entry.shape->get_type() == Shape::SPHERE) {
+                f32 radius = static_cast<const Sphere *>(entry.shape)->radius;
+                f32 t1, t2;
+                if (ray_sphere(ray.origin, ray.direction, entry.shape_position, radius, t1, t2) && t2 >= 0.0f && t1 <= max_distance) {
+                    t = std::max(t1, 0.0f);
+                    glm::vec3 offset = ray.origin + ray.direction * t - entry.shape_position;
+                    normal = t > 0.0f ? offset / radius : -ray.direction;
+                    has_hit = true;
+                }
+            } else if (ray_box(entry.shape->get_bounds(entry.shape_position), ray.origin, ray.direction, max_distance, t, normal)) {
+                has_hit = true;
+            }
+
+            if (has_hit) {
+                max_distance = t;
+                hit.distance = t;
+                hit.normal = normal;
+            }
+        }
+
+        if ((flags & MODELS) && (entry.flags & MODELS)) {
+            // the transform is affine, so t measures the same distance in both spaces
+            const glm::vec3 origin = glm::vec3{entry.world_to_model * glm::vec4{ray.origin, 1.0f}};
+            const glm::vec3 direction = glm::mat3{entry.world_to_model} * ray.direction;
+
+            f32 t;
+            glm::vec3 normal;
+            if (ray_box(entry.model_bounds, origin, direction, max_distance, t, normal)) {
+                hit.distance = t;
+                hit.normal = t > 0.0f ? glm::normalize(glm::transpose(glm::mat3{entry.world_to_model}) * normal) : -ray.direction;
+                has_hit = true;
+            }
+        }
+
+        if (has_hit) {
+            hit.position = ray.origin + ray.direction * hit.distance;
+        }
+
+        return has_hit;
+    }
+
+    bool SceneQuery::sphere_cast_entry(const Entry &entry, const Ray &ray, f32 radius, f32 max_distance, u32 flags, QueryHit &hit) const {
+        bool has_hit = false;
+
+        auto cast_against_box = [&](AABB box) {
+            box.expand(radius);
+
+            f32 t;
+            glm::vec3 normal;
+            if (ray_box(box, ray.origin, ray.direction, max_distance, t, normal)) {
+                max_distance = t;
+                hit.distance = t;
+                hit.normal = normal;
+                hit.position = ray.origin + ray.direction * t - normal * radius;
+                has_hit = true;
+            }
+        };
+
+        if ((flags & PHYSICS) && (entry.flags & PHYSICS)) {
+            if (entry.shape->get_type() == Shape::SPHERE) {
+                f32 shape_radius = static_cast<const Sphere *>(entry.shape)->radius;
+                f32 t1, t2;
+                if (ray_sphere(ray.origin, ray.direction, entry.shape_position, shape_radius + radius, t1, t2) && t2 >= 0.0f && t1 <= max_distance) {
+                    f32 t = std::max(t1, 0.0f);
+                    glm::vec3 offset = ray.origin + ray.direction * t - entry.shape_position;
+                    f32 length = glm::length(offset);
+
+                    max_distance = t;
+                    hit.distance = t;
+                    hit.normal = length > 0.0f ? offset / length : -ray.direction;
+                    hit.position = entry.shape_position + hit.normal * shape_radius;
+                    has_hit = true;
+                }
+            } else {
+                cast_against_box(entry.shape->get_bounds(entry.shape_position));
+            }
+        }
+
+        if ((flags & MODELS) && (entry.flags & MODELS)) {
+            cast_against_box(entry.model_world_bounds);
+        }
+
+        return has_hit;
+    }
+
+    bool SceneQuery::overlaps_sphere_entry(const Entry &entry, const glm::vec3 &center, f32 radius, u32 flags) const {
+        auto overlaps_box = [&](const AABB &box) {
+            glm::vec3 d = box.closest_point(center) - center;
+            return glm::dot(d, d) <= radius * radius;
+        };
+
+        if ((flags & PHYSICS) && (entry.flags & PHYSICS)) {
+            if (entry.shape->get_type() == Shape::SPHERE) {
+                f32 radius_sum = static_cast<const Sphere *>(entry.shape)->radius + radius;
+                glm::vec3 d = entry.shape_position - center;
+                if (glm::dot(d, d) <= radius_sum * radius_sum) {
+                    return true;
+                }
+            } else if (entry.shape->get_type() == Shape::CONVEX) {
+                // distance from the hull to the center, zero once the center is inside
+                const Sphere point{0.0f};
+                glm::vec3 pt_on_hull;
+                glm::vec3 pt_on_point;
+                glm::vec3 search_direction{0.0f};
+                GJK::closest_points(*entry.shape, entry.shape_position, point, center, pt_on_hull, pt_on_point, search_direction);
+
+                glm::vec3 d = pt_on_hull - pt_on_point;
+                if (glm::dot(d, d) <= radius * radius) {
+                    return true;
+                }
+            } else if (overlaps_box(entry.shape->get_bounds(entry.shape_position))) {
+                return true;
+            }
+        }
+
+        return (flags & MODELS) && (entry.flags & MODELS) && overlaps_box(entry.model_world_bounds);
+    }
+
+    bool SceneQuery::raycast(const Ray &ray, QueryHit &hit, u32 flags) const {
+        hit.entity = entt::null;
+
+        tree.raycast(ray.origin, ray.direction, ray.max_distance, [&](i32 proxy_id, f32 max_distance) {
+            entt::entity entity = tree.get_entity(proxy_id);
+            QueryHit candidate;
+            if (!raycast_entry(entries.at(entity), ray, max_distance, flags, candidate)) {
+                return max_distance;
+            }
+
+            hit = candidate;
+            hit.entity = entity;
+            return hit.distance;
+        });
+
+        return hit.entity != entt::null;
+    }
+
+    bool SceneQuery::sphere_cast(const Ray &ray, f32 radius, QueryHit &hit, u32 flags) const {
+        hit.entity = entt::null;
+
+        tree.raycast(ray.origin, ray.direction, ray.max_distance, [&](i32 proxy_id, f32 max_distance) {
+            entt::entity entity = tree.get_entity(proxy_id);
+            QueryHit candidate;
+            if (!sphere_cast_entry(entries.at(entity), ray, radius, max_distance, flags, candidate)) {
+                return max_distance;
+            }
+
+            hit = candidate;
+            hit.entity = entity;
+            return hit.distance;
+        }, radius);
+
+        return hit.entity != entt::null;
+    }
+
+    void SceneQuery::overlap_sphere(const glm::vec3 &center, f32 radius, std::vector<entt::entity> &results, u32 flags) const {
+        AABB box{center - glm::vec3{radius}, center + glm::vec3{radius}};
+        tree.query(box, [&](i32 proxy_id) {
+            entt::entity entity = tree.get_entity(proxy_id);
+            if (overlaps_sphere_entry(entries.at(entity), center, radius, flags)) {
+                results.push_back(entity);
+            }
+            return true;
+        });
+    }
+
+    void SceneQuery::overlap_box(const AABB &box, std::vector<entt::entity> &results, u32 flags) const {
+        tree.query(box, [&](i32 proxy_id) {
+            entt::entity entity = tree.get_entity(proxy_id);
+            const Entry &entry = entries.at(entity);
+
+            bool overlaps = (flags & MODELS) && (entry.flags & MODELS) && entry.model_world_bounds.overlaps(box);
+            if (!overlaps && (flags & PHYSICS) && (entry.flags & PHYSICS)) {
+                if (entry.shape->get_type() == Shape::SPHERE) {
+                    glm::vec3 d = box.closest_point(entry.shape_position) - entry.shape_position;
+                    f32 radius = static_cast<const Sphere *>(entry.shape)->radius;
+                    overlaps = glm::dot(d, d) <= radius * radius;
+                } else {
+                    overlaps = entry.shape->get_bounds(entry.shape_position).overlaps(box);
+                }
+            }
+
+            if (overlaps) {
+                results.push_back(entity);
+            }
+            return true;
+        });
+    }
+
+    void SceneQuery::raycast_batch(const std::vector<Ray> &rays, std::vector<QueryHit> &hits, u32 flags) const {
+        hits.resize(rays.size());
+        JobSystem::parallel_for(static_cast<u32>(rays.size()), batch_size, [&](u32 begin, u32 end, u32) {
+            for (u32 i = begin; i < end; i++) {
+                raycast(rays[i], hits[i], flags);
+            }
+        });
+    }
+
+    void SceneQuery::sphere_cast_batch(const std::vector<Ray> &rays, f32 radius, std::vector<QueryHit> &hits, u32 flags) const {
+        hits.resize(rays.size());
+        JobSystem::parallel_for(static_cast<u32>(rays.size()), batch_size, [&](u32 begin, u32 end, u32) {
+            for (u32 i = begin; i < end; i++) {
+                sphere_cast(rays[i], radius, hits[i], flags);
+            }
+        });
+    }
+}
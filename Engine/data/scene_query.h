@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../core/types.h"
+#include "../math/aabb.h"
+#include "../physics/dynamic_aabb_tree.h"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+    class Scene;
+    class Shape;
+    class Model;
+
+    struct Ray {
+        glm::vec3 origin = {0.0f, 0.0f, 0.0f};
+        glm::vec3 direction = {0.0f, 0.0f, -1.0f}; // normalized
+        f32 max_distance = std::numeric_limits<f32>::max();
+    };
+
+    struct QueryHit {
+        entt::entity entity{entt::null};
+        glm::vec3 position = {0.0f, 0.0f, 0.0f};
+        glm::vec3 normal = {0.0f, 0.0f, 0.0f};
+        f32 distance = 0.0f;
+    };
+
+    // Raycasts, sphere casts and overlap tests against the model bounds and physics shapes of a scene.
+    // Entities are kept in a DynamicAABBTree that is refit from the world matrices once per frame,
+    // an entry is refit when the version of its transform moved on.
+    // All queries are const and can run from any number of threads while update() isn't running.
+    class SceneQuery {
+    public:
+        enum QueryFlags : u32 {
+            MODELS = 1 << 0,
+            PHYSICS = 1 << 1,
+            ALL = MODELS | PHYSICS,
+        };
+
+        static constexpr u32 batch_size = 32;
+
+        explicit SceneQuery(Scene &_scene);
+        ~SceneQuery();
+
+        SceneQuery(const SceneQuery &) = delete;
+        SceneQuery &operator=(const SceneQuery &) = delete;
+
+        // Scene::update_transforms calls this after the hierarchy updated the world matrices
+        void update();
+
+        // closest hit along the ray
+        bool raycast(const Ray &ray, QueryHit &hit, u32 flags = ALL) const;
+
+        // closest hit of a sphere swept along the ray, boxes are inflated by the radius which is
+        // slightly conservative around their corners
+        bool sphere_cast(const Ray &ray, f32 radius, QueryHit &hit, u32 flags = ALL) const;
+
+        // results are appended
+        void overlap_sphere(const glm::vec3 &center, f32 radius, std::vector<entt::entity> &results, u32 flags = ALL) const;
+        void overlap_box(const AABB &box, std::vector<entt::entity> &results, u32 flags = ALL) const;
+
+        // Runs the queries on the JobSystem, hits[i].entity is entt::null when rays[i] didn't hit anything.
+        void raycast_batch(const std::vector<Ray> &rays, std::vector<QueryHit> &hits, u32 flags = ALL) const;
+        void sphere_cast_batch(const std::vector<Ray> &rays, f32 radius, std::vector<QueryHit> &hits, u32 flags = ALL) const;
+
+    private:
+        struct Entry {
+            i32 proxy = DynamicAABBTree::null_node;
+            u32 flags = 0;
+            u32 version = 0; // TransformComponent::version the entry was built from
+            AABB bounds; // world space bounds of every part below
+
+            // model part, rays are tested against the local bounds in model space
+            const Model *model = nullptr;
+            AABB model_bounds;
+            AABB model_world_bounds;
+            glm::mat4 world_to_model{1.0f};
+
+            // physics part
+            const Shape *shape = nullptr;
+            glm::vec3 shape_position = {0.0f, 0.0f, 0.0f};
+        };
+
+        void refresh(entt::entity entity);
+        void remove(entt::entity entity);
+
+        bool raycast_entry(const Entry &entry, const Ray &ray, f32 max_distance, u32 flags, QueryHit &hit) const;
+        bool sphere_cast_entry(const Entry &entry, const Ray &ray, f32 radius, f32 max_distance, u32 flags, QueryHit &hit) const;
+        bool overlaps_sphere_entry(const Entry &entry, const glm::vec3 &center, f32 radius, u32 flags) const;
+
+        void on_component_changed(entt::registry &registry, entt::entity entity);
+
+        Scene &scene;
+        DynamicAABBTree tree;
+        std::unordered_map<entt::entity, Entry> entries;
+        std::vector<entt::entity> pending;
+    };
+}
@@ -0,0 +1,138 @@
+#include "scene_saver.h"
+
+#include "scene_serializer.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+
+namespace Engine {
+    namespace {
+        // FNV-1a like the other checksums, it runs on the writer thread
+        u64 hash_bytes(std::string_view bytes) {
+            u64 hash = 14695981039346656037ull;
+            for (char c : bytes) {
+                hash ^= static_cast<u8>(c);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+    }
+
+    SceneSaver::SceneSaver() {
+        // started here and not in the initializer list, run() needs the other members constructed
+        thread = std::thread{[this] { run(); }};
+    }
+
+    SceneSaver::~SceneSaver() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            is_stopping = true;
+        }
+        work_condition.notify_one();
+        thread.join();
+    }
+
+    void SceneSaver::save(const std::shared_ptr<Scene> &scene, const std::string &path, Format format) {
+        Request request{path, format, SceneSerializer{scene}.snapshot()};
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = std::find_if(queue.begin(), queue.end(), [&](const Request &queued) { return queued.path == path; });
+            if (it != queue.end()) {
+                *it = std::move(request);
+            } else {
+                queue.push_back(std::move(request));
+            }
+        }
+        work_condition.notify_one();
+    }
+
+    void SceneSaver::set_autosave(const std::string &path, Format format, f32 interval) {
+        autosave_path = path;
+        autosave_format = format;
+        autosave_interval = interval;
+        autosave_timer = 0.0f;
+    }
+
+    void SceneSaver::update(const std::shared_ptr<Scene> &scene, f32 delta_time) {
+        if (autosave_interval <= 0.0f) {
+            return;
+        }
+
+        autosave_timer += delta_time;
+        if (autosave_timer < autosave_interval) {
+            return;
+        }
+        autosave_timer = 0.0f;
+
+        // a slow disk shouldn't pile up snapshots, the next interval catches up
+        if (!is_busy()) {
+            save(scene, autosave_path, autosave_format);
+        }
+    }
+
+    bool SceneSaver::is_busy() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return is_writing || !queue.empty();
+    }
+
+    void SceneSaver::wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle_condition.wait(lock, [&] { return !is_writing && queue.empty(); });
+    }
+
+    std::string SceneSaver::get_last_error() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return last_error;
+    }
+
+    void SceneSaver::run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            work_condition.wait(lock, [&] { return is_stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return; // stopping and everything is written
+            }
+
+            Request request = std::move(queue.front());
+            queue.pop_front();
+            is_writing = true;
+            lock.unlock();
+
+            std::string error;
+            try {
+                write(request);
+            } catch (const std::exception &e) {
+                error = e.what();
+            }
+
+            lock.lock();
+            is_writing = false;
+            last_error = std::move(error);
+            if (queue.empty()) {
+                idle_condition.notify_all();
+            }
+        }
+    }
+
+    void SceneSaver::write(const Request &request) {
+        ChunkHashes hashes;
+        for (u32 i = 0; i < BinarySceneWriter::chunk_count; i++) {
+            hashes[i] = hash_bytes(request.snapshot.get_chunk_bytes(static_cast<SceneFormat::ChunkType>(i)));
+        }
+
+        // the file could have been replaced or deleted behind the saver's back
+        auto it = written_files.find(request.path);
+        if (it != written_files.end() && it->second.format == request.format && it->second.hashes == hashes && std::filesystem::exists(request.path)) {
+            return;
+        }
+
+        if (request.format == Format::BINARY) {
+            request.snapshot.write(request.path);
+        } else {
+            SceneSerializer::write_yaml(request.snapshot, request.path);
+        }
+        written_files[request.path] = {request.format, hashes};
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../core/types.h"
+#include "binary_scene.h"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace Engine {
+    class Scene;
+
+    // Saves scenes without holding up the frame. save() only takes a snapshot of the scene, a thread of
+    // its own writes it out and replaces the file in one step. Every chunk of a snapshot is hashed,
+    // when none changed since the saver last wrote the same file the write is skipped, so autosaving a
+    // scene nobody touches costs one snapshot. Nothing tracks which entities changed, the snapshot
+    // always copies the whole scene on the calling thread and a changed file is written in full.
+    //
+    // The writer is a plain thread and not a job, writing blocks on the disk and the main thread would
+    // pick the job up itself whenever it waits on the job system.
+    class SceneSaver {
+    public:
+        enum class Format { YAML, BINARY };
+
+        SceneSaver();
+        // writes out what's still queued
+        ~SceneSaver();
+
+        SceneSaver(const SceneSaver &) = delete;
+        SceneSaver &operator=(const SceneSaver &) = delete;
+
+        // main thread, a newer save replaces one to the same path that's still queued
+        void save(const std::shared_ptr<Scene> &scene, const std::string &path, Format format);
+
+        // update() saves every interval seconds, 0 turns autosaving off
+        void set_autosave(const std::string &path, Format format, f32 interval);
+        void update(const std::shared_ptr<Scene> &scene, f32 delta_time);
+
+        bool is_busy() const;
+        // blocks until everything queued is written
+        void wait();
+
+        // what the last failed write threw, empty after a successful one
+        std::string get_last_error() const;
+
+    private:
+        using ChunkHashes = std::array<u64, BinarySceneWriter::chunk_count>;
+
+        struct Request {
+            std::string path;
+            Format format;
+            BinarySceneWriter snapshot;
+        };
+
+        struct WrittenFile {
+            Format format;
+            ChunkHashes hashes;
+        };
+
+        void run();
+        void write(const Request &request);
+
+        std::thread thread;
+        mutable std::mutex mutex;
+        std::condition_variable work_condition;
+        std::condition_variable idle_condition;
+        std::deque<Request> queue;
+        bool is_writing = false;
+        bool is_stopping = false;
+        std::string last_error;
+
+        std::unordered_map<std::string, WrittenFile> written_files; // writer thread only
+
+        std::string autosave_path;
+        Format autosave_format = Format::YAML;
+        f32 autosave_interval = 0.0f;
+        f32 autosave_timer = 0.0f;
+    };
+}
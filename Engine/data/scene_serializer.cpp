@@ -1,7 +1,15 @@
 #include "scene_serializer.h"
 
+#include "binary_scene.h"
+#include "../core/atomic_file.h"
+#include "../graphics/asset_manager.h"
+
 #include <yaml-cpp/yaml.h>
 
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
 namespace YAML {
     template<>
     struct convert<glm::vec3> {
@@ -64,87 +72,136 @@ namespace Engine {
         return out;
     }
 
-    static void serialize_entity(YAML::Emitter &out, Entity entity) {
-        out << YAML::BeginMap; // Entity
-        out << YAML::Key << "Entity" << YAML::Value << entity.get_UUID();
-
-        if (entity.has_component<TagComponent>()) {
-            out << YAML::Key << "TagComponent";
-            out << YAML::BeginMap; // TagComponent
-
-            auto &tag = entity.get_component<TagComponent>().tag;
-            out << YAML::Key << "Tag" << YAML::Value << tag;
-
-            out << YAML::EndMap; // TagComponent
-        }
-
-        if (entity.has_component<TransformComponent>()) {
-            out << YAML::Key << "TransformComponent";
-            out << YAML::BeginMap; // TransformComponent
+    BinarySceneWriter SceneSerializer::snapshot() const {
+        auto &registry = scene->registry;
 
-            auto &tc = entity.get_component<TransformComponent>();
-            out << YAML::Key << "Translation" << YAML::Value << tc.translation;
-            out << YAML::Key << "Rotation" << YAML::Value << tc.rotation;
-            out << YAML::Key << "Scale" << YAML::Value << tc.scale;
+        BinarySceneWriter writer;
+        writer.reserve(static_cast<u32>(registry.view<RelationshipComponent>().size()));
 
-            out << YAML::EndMap; // TransformComponent
-        }
+        // The ancestors of the current entity with their indices. Depth first, the parent of an
+        // entity is always on it, so finding it is a few pops instead of a lookup per entity.
+        std::vector<std::pair<entt::entity, u32>> ancestors;
 
-        if (entity.has_component<RigidBodyComponent>()) {
-            out << YAML::Key << "RigidBodyComponent";
-            out << YAML::BeginMap; // RigidBodyComponent
+        // depth first from every root, parents come before their children and siblings keep their order
+        registry.view<RelationshipComponent>().each([&](auto root, RelationshipComponent &root_rc) {
+            if (root_rc.parent != entt::null)
+                return;
 
-            auto &rb = entity.get_component<RigidBodyComponent>();
-            out << YAML::Key << "Velocity" << YAML::Value << rb.velocity;
-            out << YAML::Key << "Acceleration" << YAML::Value << rb.velocity;
-            out << YAML::Key << "Mass" << YAML::Value << rb.mass;
-            out << YAML::Key << "Radius" << YAML::Value << rb.radius;
-            out << YAML::Key << "isStatic" << YAML::Value << rb.is_static;
+            ancestors.clear();
+            for (entt::entity entity = root; entity != entt::null; entity = scene->next_in_subtree(root, entity)) {
+                const auto &rc = registry.get<RelationshipComponent>(entity);
+                while (!ancestors.empty() && ancestors.back().first != rc.parent) {
+                    ancestors.pop_back();
+                }
 
-            out << YAML::EndMap; // RigidBodyComponent
-        }
+                const auto &tc = registry.get<TransformComponent>(entity);
+                const u32 index = writer.add_entity(registry.get<IDComponent>(entity).ID, ancestors.empty() ? SceneFormat::no_parent : ancestors.back().second,
+                                                    registry.get<TagComponent>(entity).tag, {tc.translation, tc.rotation, tc.scale});
+                ancestors.emplace_back(entity, index);
 
-        if (entity.has_component<ModelComponent>()) {
-            out << YAML::Key << "ModelComponent";
-            out << YAML::BeginMap; // ModelComponent
+                if (auto *mc = registry.try_get<ModelComponent>(entity)) {
+                    writer.add_model(index, mc->path, mc->transparent);
+                }
 
-            out << YAML::Key << "Path" << YAML::Value << entity.get_component<ModelComponent>().path;
+                if (auto *light = registry.try_get<PointLightComponent>(entity)) {
+                    writer.add_point_light(index, light->color, light->intensity);
+                }
 
-            out << YAML::EndMap; // ModelComponent
-        }
+                if (auto *rb = registry.try_get<RigidBodyComponent>(entity)) {
+                    writer.add_rigid_body({index, rb->velocity, rb->acceleration, rb->mass, rb->radius, rb->is_static ? 1u : 0u});
+                }
+            }
+        });
 
-        if (entity.has_component<PointLightComponent>()) {
-            out << YAML::Key << "PointLightComponent";
-            out << YAML::BeginMap; // PointLightComponent
+        return writer;
+    }
 
-            auto &light = entity.get_component<PointLightComponent>();
-            out << YAML::Key << "Color" << YAML::Value << light.color;
-            out << YAML::Key << "Intensity" << YAML::Value << light.intensity;
+    void SceneSerializer::serialize(const std::string &filepath) {
+        write_yaml(snapshot(), filepath);
+    }
 
-            out << YAML::EndMap; // PointLightComponent
-        }
+    void SceneSerializer::write_yaml(const BinarySceneWriter &snapshot, const std::string &filepath) {
+        const auto &uuids = snapshot.get_uuids();
+        const auto &parents = snapshot.get_parents();
+        const auto &tags = snapshot.get_tags();
+        const auto &transforms = snapshot.get_transforms();
+        const auto &models = snapshot.get_models();
+        const auto &point_lights = snapshot.get_point_lights();
+        const auto &rigid_bodies = snapshot.get_rigid_bodies();
 
-        out << YAML::EndMap; // Entity
-    }
+        // the component arrays are in entity order, one cursor each walks along with the entities
+        usize model = 0;
+        usize point_light = 0;
+        usize rigid_body = 0;
 
-    void SceneSerializer::serialize(const std::string &filepath) {
         YAML::Emitter out;
         out << YAML::BeginMap;
         out << YAML::Key << "Scene" << YAML::Value << "Untitled";
         out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
-        scene->registry.each([&](auto entityID) {
-            Entity entity = {entityID, scene.get()};
-            if (!entity)
-                return;
+        for (u32 i = 0; i < snapshot.get_entity_count(); i++) {
+            out << YAML::BeginMap; // Entity
+            out << YAML::Key << "Entity" << YAML::Value << uuids[i];
 
-            serialize_entity(out, entity);
-        });
+            out << YAML::Key << "TagComponent";
+            out << YAML::BeginMap; // TagComponent
+            out << YAML::Key << "Tag" << YAML::Value << std::string{snapshot.get_string(tags[i])};
+            out << YAML::EndMap; // TagComponent
+
+            out << YAML::Key << "TransformComponent";
+            out << YAML::BeginMap; // TransformComponent
+            out << YAML::Key << "Translation" << YAML::Value << transforms[i].translation;
+            out << YAML::Key << "Rotation" << YAML::Value << transforms[i].rotation;
+            out << YAML::Key << "Scale" << YAML::Value << transforms[i].scale;
+            out << YAML::EndMap; // TransformComponent
+
+            if (parents[i] != SceneFormat::no_parent) {
+                out << YAML::Key << "RelationshipComponent";
+                out << YAML::BeginMap; // RelationshipComponent
+                out << YAML::Key << "Parent" << YAML::Value << uuids[parents[i]];
+                out << YAML::EndMap; // RelationshipComponent
+            }
+
+            if (rigid_body < rigid_bodies.size() && rigid_bodies[rigid_body].entity == i) {
+                out << YAML::Key << "RigidBodyComponent";
+                out << YAML::BeginMap; // RigidBodyComponent
+
+                auto &rb = rigid_bodies[rigid_body++];
+                out << YAML::Key << "Velocity" << YAML::Value << rb.velocity;
+                out << YAML::Key << "Acceleration" << YAML::Value << rb.acceleration;
+                out << YAML::Key << "Mass" << YAML::Value << rb.mass;
+                out << YAML::Key << "Radius" << YAML::Value << rb.radius;
+                out << YAML::Key << "isStatic" << YAML::Value << (rb.is_static != 0);
+
+                out << YAML::EndMap; // RigidBodyComponent
+            }
+
+            if (model < models.size() && models[model].entity == i) {
+                out << YAML::Key << "ModelComponent";
+                out << YAML::BeginMap; // ModelComponent
+                out << YAML::Key << "Path" << YAML::Value << std::string{snapshot.get_string(models[model++].path)};
+                out << YAML::EndMap; // ModelComponent
+            }
+
+            if (point_light < point_lights.size() && point_lights[point_light].entity == i) {
+                out << YAML::Key << "PointLightComponent";
+                out << YAML::BeginMap; // PointLightComponent
+
+                auto &light = point_lights[point_light++];
+                out << YAML::Key << "Color" << YAML::Value << light.color;
+                out << YAML::Key << "Intensity" << YAML::Value << light.intensity;
+
+                out << YAML::EndMap; // PointLightComponent
+            }
+
+            out << YAML::EndMap; // Entity
+        }
 
         out << YAML::EndSeq;
         out << YAML::EndMap;
 
-        std::ofstream fout(filepath);
-        fout << out.c_str();
+        AtomicFile file{filepath};
+        file.get_stream() << out.c_str();
+        file.commit();
     }
 
     bool SceneSerializer::deserialize(const std::shared_ptr<Device>& device, const std::string &filepath) {
@@ -163,6 +220,13 @@ namespace Engine {
 
         auto entities = data["Entities"];
         if (entities) {
+            scene->reserve(entities.size());
+
+            // a child's parent is always earlier in the file, its last linked child is where the next one goes
+            std::unordered_map<entt::entity, entt::entity> last_children;
+            // models are loaded after the entities, once per path
+            std::vector<entt::entity> model_entities;
+
             for (auto entity : entities) {
                 auto uuid = entity["Entity"].as<uint64_t>();
 
@@ -171,7 +235,14 @@ namespace Engine {
                 if (tag_component)
                     name = tag_component["Tag"].as<std::string>();
 
-                Entity deserialized_entity = scene->create_entity_with_UUID(uuid, name);
+                // two entities with one UUID, the file is broken
+                Entity deserialized_entity;
+                try {
+                    deserialized_entity = scene->create_entity_with_UUID(uuid, name);
+                }
+                catch (std::runtime_error&) {
+                    return false;
+                }
 
                 auto transform_component = entity["TransformComponent"];
                 if (transform_component) {
@@ -182,6 +253,16 @@ namespace Engine {
                     tc.is_dirty = true;
                 }
 
+                auto relationship_component = entity["RelationshipComponent"];
+                if (relationship_component) {
+                    Entity parent = scene->find_entity(relationship_component["Parent"].as<uint64_t>());
+                    if (parent) {
+                        auto it = last_children.find(parent);
+                        scene->attach(deserialized_entity, parent, it != last_children.end() ? it->second : entt::null);
+                        last_children[parent] = deserialized_entity;
+                    }
+                }
+
                 auto rigidbody_component = entity["RigidBodyComponent"];
                 if (rigidbody_component) {
                     deserialized_entity.add_component<RigidBodyComponent>();
@@ -195,8 +276,8 @@ namespace Engine {
 
                 auto model_component = entity["ModelComponent"];
                 if (model_component) {
-                    auto model = std::make_shared<Model>(device, model_component["Path"].as<std::string>());
-                    deserialized_entity.add_component<ModelComponent>(model);
+                    deserialized_entity.add_component<ModelComponent>().path = model_component["Path"].as<std::string>();
+                    model_entities.push_back(deserialized_entity);
                 }
 
                 auto light_point_component = entity["PointLightComponent"];
@@ -207,8 +288,113 @@ namespace Engine {
                     deserialized_entity.get_component<PointLightComponent>().intensity = light_point_component["Intensity"].as<float>();
                 }
             }
+
+            if (device) {
+                std::vector<std::string> paths;
+                paths.reserve(model_entities.size());
+                for (auto entity : model_entities) {
+                    paths.push_back(scene->registry.get<ModelComponent>(entity).path);
+                }
+
+                auto models = AssetManager::get_models(paths);
+                for (usize i = 0; i < model_entities.size(); i++) {
+                    scene->registry.get<ModelComponent>(model_entities[i]).model = std::move(models[i]);
+                }
+            }
         }
 
         return true;
     }
-}
\ No newline at end of file
+
+    void SceneSerializer::serialize_binary(const std::string &filepath) {
+        snapshot().write(filepath);
+    }
+
+    bool SceneSerializer::deserialize_binary(const std::shared_ptr<Device>& device, const std::string &filepath) {
+        std::unique_ptr<BinarySceneReader> reader;
+        try {
+            reader = std::make_unique<BinarySceneReader>(filepath);
+        }
+        catch (std::runtime_error&) {
+            return false;
+        }
+
+        const u32 entity_count = reader->get_entity_count();
+        scene->reserve(entity_count);
+
+        u32 count = 0;
+        const u64 *uuids = reader->get_chunk<u64>(SceneFormat::UUIDS, count);
+        const u32 *parents = reader->get_chunk<u32>(SceneFormat::PARENTS, count);
+        const SceneFormat::StringRef *tags = reader->get_chunk<SceneFormat::StringRef>(SceneFormat::TAGS, count);
+        const SceneFormat::Transform *transforms = reader->get_chunk<SceneFormat::Transform>(SceneFormat::TRANSFORMS, count);
+
+        // the reader checked every index, parents come first so they're always created already
+        std::vector<entt::entity> entities(entity_count);
+        std::vector<entt::entity> last_children(entity_count, entt::null);
+        for (u32 i = 0; i < entity_count; i++) {
+            Entity entity;
+            try {
+                entity = scene->create_entity_with_UUID(uuids[i], std::string{reader->get_string(tags[i])});
+            }
+            catch (std::runtime_error&) {
+                return false;
+            }
+            entities[i] = entity;
+
+            auto &tc = entity.get_component<TransformComponent>();
+            tc.translation = transforms[i].translation;
+            tc.rotation = transforms[i].rotation;
+            tc.scale = transforms[i].scale;
+            tc.is_dirty = true;
+
+            if (parents[i] != SceneFormat::no_parent) {
+                scene->attach(entity, entities[parents[i]], last_children[parents[i]]);
+                last_children[parents[i]] = entity;
+            }
+        }
+
+        // the writer stores every path once, so the string offset already tells the models apart
+        std::unordered_map<u32, u32> path_indices;
+        std::vector<std::string> paths;
+        std::vector<u32> model_paths;
+        const SceneFormat::Model *model_components = reader->get_chunk<SceneFormat::Model>(SceneFormat::MODELS, count);
+        for (u32 i = 0; i < count; i++) {
+            const auto &source = model_components[i];
+            auto [it, inserted] = path_indices.try_emplace(source.path.offset, static_cast<u32>(paths.size()));
+            if (inserted) {
+                paths.emplace_back(reader->get_string(source.path));
+            }
+            model_paths.push_back(it->second);
+
+            auto &mc = scene->registry.emplace<ModelComponent>(entities[source.entity]);
+            mc.path = paths[it->second];
+            mc.transparent = source.transparent != 0;
+        }
+
+        if (device) {
+            auto models = AssetManager::get_models(paths);
+            for (u32 i = 0; i < count; i++) {
+                scene->registry.get<ModelComponent>(entities[model_components[i].entity]).model = models[model_paths[i]];
+            }
+        }
+
+        const SceneFormat::PointLight *point_lights = reader->get_chunk<SceneFormat::PointLight>(SceneFormat::POINT_LIGHTS, count);
+        for (u32 i = 0; i < count; i++) {
+            auto &light = scene->registry.emplace<PointLightComponent>(entities[point_lights[i].entity]);
+            light.color = point_lights[i].color;
+            light.intensity = point_lights[i].intensity;
+        }
+
+        const SceneFormat::RigidBody *rigid_bodies = reader->get_chunk<SceneFormat::RigidBody>(SceneFormat::RIGID_BODIES, count);
+        for (u32 i = 0; i < count; i++) {
+            auto &rb = scene->registry.emplace<RigidBodyComponent>(entities[rigid_bodies[i].entity]);
+            rb.velocity = rigid_bodies[i].velocity;
+            rb.acceleration = rigid_bodies[i].acceleration;
+            rb.mass = rigid_bodies[i].mass;
+            rb.radius = rigid_bodies[i].radius;
+            rb.is_static = rigid_bodies[i].is_static != 0;
+        }
+
+        return true;
+    }
+}
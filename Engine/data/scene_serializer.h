@@ -4,15 +4,30 @@
 
 #include "../data/scene.h"
 #include "../data/entity.h"
+#include "../data/binary_scene.h"
 
 namespace Engine {
     class SceneSerializer {
     public:
         explicit SceneSerializer(std::shared_ptr<Scene> _scene) : scene{std::move(_scene)} {};
 
+        // both formats replace the file in one step, a failed save leaves the old one intact
         void serialize(const std::string &filepath);
+        // false for a file that can't be read or has two entities with the same UUID, the scene can
+        // be partly filled then
         bool deserialize(const std::shared_ptr<Device>& device, const std::string &filepath);
 
+        // Same content as the YAML scenes in the binary format of binary_scene.h, for loading big
+        // scenes fast. Without a device models keep only their path, enough for converting scenes.
+        void serialize_binary(const std::string &filepath);
+        bool deserialize_binary(const std::shared_ptr<Device>& device, const std::string &filepath);
+
+        // Packs everything the files store, in file order. Saving on another thread takes one of these
+        // on the main thread and writes it from there. It still visits every entity (a few component
+        // lookups and the string copies), SnapshotBenchmark times it against the write.
+        BinarySceneWriter snapshot() const;
+        static void write_yaml(const BinarySceneWriter &snapshot, const std::string &filepath);
+
     private:
         std::shared_ptr<Scene> scene;
     };
@@ -0,0 +1,124 @@
+#include "transform_hierarchy.h"
+
+#include "scene.h"
+#include "components.h"
+
+#include "../core/job_system.h"
+#include "../math/transform_kernels.h"
+
+namespace Engine {
+    TransformHierarchy::TransformHierarchy(Scene &_scene) : scene{_scene} {
+        auto &registry = scene.registry;
+        registry.on_construct<RelationshipComponent>().connect<&TransformHierarchy::on_relationship_changed>(*this);
+        registry.on_destroy<RelationshipComponent>().connect<&TransformHierarchy::on_relationship_changed>(*this);
+    }
+
+    TransformHierarchy::~TransformHierarchy() {
+        auto &registry = scene.registry;
+        registry.on_construct<RelationshipComponent>().disconnect<&TransformHierarchy::on_relationship_changed>(*this);
+        registry.on_destroy<RelationshipComponent>().disconnect<&TransformHierarchy::on_relationship_changed>(*this);
+    }
+
+    void TransformHierarchy::on_relationship_changed(entt::registry &, entt::entity) {
+        is_dirty = true;
+    }
+
+    void TransformHierarchy::rebuild() {
+        auto &registry = scene.registry;
+        auto relationships = registry.view<TransformComponent, RelationshipComponent>();
+
+        nodes.clear();
+        parents.clear();
+        level_offsets.clear();
+
+        relationships.each([&](auto entity, TransformComponent &, RelationshipComponent &rc) {
+            if (rc.parent == entt::null) {
+                nodes.push_back(entity);
+                parents.push_back(no_parent);
+            }
+        });
+
+        // breadth first, each pass appends the next level
+        level_offsets.push_back(0);
+        u32 level_begin = 0;
+        while (level_begin < static_cast<u32>(nodes.size())) {
+            const u32 level_end = static_cast<u32>(nodes.size());
+            level_offsets.push_back(level_end);
+
+            for (u32 i = level_begin; i < level_end; i++) {
+                // Scene keeps the links valid, destroying an entity takes its subtree with it
+                for (entt::entity child = relationships.get<RelationshipComponent>(nodes[i]).first_child; child != entt::null; child = relationships.get<RelationshipComponent>(child).next_sibling) {
+                    nodes.push_back(child);
+                    parents.push_back(i);
+                }
+            }
+
+            level_begin = level_end;
+        }
+
+        world_matrices.resize(nodes.size());
+        changed.assign(nodes.size(), 0);
+        update_all = true;
+    }
+
+    void TransformHierarchy::update() {
+        if (is_dirty) {
+            rebuild();
+            is_dirty = false;
+        }
+
+        batch_scratch.resize(JobSystem::get_thread_count());
+
+        auto transforms = scene.registry.view<TransformComponent>();
+        for (usize level = 0; level + 1 < level_offsets.size(); level++) {
+            const u32 level_begin = level_offsets[level];
+            const u32 count = level_offsets[level + 1] - level_begin;
+
+            JobSystem::parallel_for(count, batch_size, [&](u32 begin, u32 end, u32 thread_index) {
+                BatchScratch &scratch = batch_scratch[thread_index];
+                auto &[indices, components, local_transforms, local_matrices] = scratch;
+                u32 changed_count = 0;
+
+                for (u32 i = level_begin + begin; i < level_begin + end; i++) {
+                    auto &tc = transforms.get<TransformComponent>(nodes[i]);
+                    const u32 parent = parents[i];
+
+                    changed[i] = update_all || tc.is_dirty || (parent != no_parent && changed[parent]);
+                    if (!changed[i]) {
+                        continue;
+                    }
+
+                    for (glm::length_t axis = 0; axis < 3; axis++) {
+                        local_transforms[axis][changed_count] = tc.translation[axis];
+                        local_transforms[3 + axis][changed_count] = tc.rotation[axis];
+                        local_transforms[6 + axis][changed_count] = tc.scale[axis];
+                    }
+                    indices[changed_count] = i;
+                    components[changed_count] = &tc;
+                    changed_count++;
+                }
+
+                const TransformKernels::TransformArrays arrays = {
+                    {local_transforms[0], local_transforms[1], local_transforms[2]},
+                    {local_transforms[3], local_transforms[4], local_transforms[5]},
+                    {local_transforms[6], local_transforms[7], local_transforms[8]},
+                };
+                TransformKernels::compose(arrays, changed_count, local_matrices);
+
+                for (u32 k = 0; k < changed_count; k++) {
+                    const u32 i = indices[k];
+                    const u32 parent = parents[i];
+                    world_matrices[i] = parent == no_parent ? local_matrices[k] : world_matrices[parent] * local_matrices[k];
+
+                    auto &tc = *components[k];
+                    tc.model_matrix = world_matrices[i];
+                    tc.normal_matrix = glm::transpose(glm::inverse(glm::mat3(world_matrices[i])));
+                    tc.version++;
+                    tc.is_dirty = false;
+                }
+            });
+        }
+
+        update_all = false;
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../core/types.h"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace Engine {
+    class Scene;
+    struct TransformComponent;
+
+    // The parent/child links of a scene flattened into arrays sorted by depth, so every parent sits
+    // in an earlier level than its children. A world matrix only needs the local transform and the
+    // parent's world matrix, the levels run one after another and each one is split across the
+    // JobSystem. The arrays are rebuilt when the hierarchy changes, links have to go through
+    // Scene::set_parent for that to be noticed.
+    class TransformHierarchy {
+    public:
+        static constexpr u32 batch_size = 256;
+        static constexpr u32 no_parent = ~0u;
+
+        explicit TransformHierarchy(Scene &_scene);
+        ~TransformHierarchy();
+
+        TransformHierarchy(const TransformHierarchy &) = delete;
+        TransformHierarchy &operator=(const TransformHierarchy &) = delete;
+
+        void mark_dirty() { is_dirty = true; }
+
+        // Recomputes the world matrix of every dirty transform and everything below it, then clears
+        // the dirty flags.
+        void update();
+
+    private:
+        // what a batch packs its changed nodes into so their local matrices are composed together,
+        // about 28 KB, too much for a worker's stack
+        struct BatchScratch {
+            u32 indices[batch_size];
+            TransformComponent *components[batch_size];
+            f32 local_transforms[9][batch_size];
+            glm::mat4 local_matrices[batch_size];
+        };
+
+        void rebuild();
+        void on_relationship_changed(entt::registry &registry, entt::entity entity);
+
+        Scene &scene;
+        bool is_dirty = true;
+        bool update_all = true;
+
+        std::vector<entt::entity> nodes;
+        std::vector<u32> parents; // index into nodes
+        std::vector<u32> level_offsets; // level i is [level_offsets[i], level_offsets[i + 1])
+        std::vector<glm::mat4> world_matrices;
+        std::vector<u8> changed; // not vector<bool>, neighbouring entries are written from different threads
+        std::vector<BatchScratch> batch_scratch; // one per JobSystem thread index
+    };
+}
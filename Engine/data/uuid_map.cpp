@@ -0,0 +1,114 @@
+#include "uuid_map.h"
+
+namespace Engine {
+    namespace {
+        // splitmix64 finalizer, UUIDs are random but ones written by hand or tools often aren't
+        u64 mix(u64 value) {
+            value ^= value >> 30;
+            value *= 0xbf58476d1ce4e5b9ull;
+            value ^= value >> 27;
+            value *= 0x94d049bb133111ebull;
+            value ^= value >> 31;
+            return value;
+        }
+    }
+
+    usize UUIDMap::get_home(u64 uuid) const {
+        return static_cast<usize>(mix(uuid)) & (slots.size() - 1);
+    }
+
+    void UUIDMap::reserve(usize _count) {
+        usize capacity = slots.empty() ? 16 : slots.size();
+        while (_count * 4 > capacity * 3) {
+            capacity *= 2;
+        }
+        if (capacity != slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    void UUIDMap::clear() {
+        slots.clear();
+        count = 0;
+    }
+
+    void UUIDMap::rehash(usize capacity) {
+        std::vector<Slot> old_slots = std::move(slots);
+        slots.assign(capacity, Slot{0, entt::null});
+
+        for (const Slot &slot : old_slots) {
+            if (slot.entity == entt::null) {
+                continue;
+            }
+
+            usize index = get_home(slot.uuid);
+            while (slots[index].entity != entt::null) {
+                index = (index + 1) & (slots.size() - 1);
+            }
+            slots[index] = slot;
+        }
+    }
+
+    bool UUIDMap::insert(UUID uuid, entt::entity entity) {
+        reserve(count + 1);
+
+        usize index = get_home(uuid);
+        while (slots[index].entity != entt::null) {
+            if (slots[index].uuid == uuid) {
+                return false;
+            }
+            index = (index + 1) & (slots.size() - 1);
+        }
+
+        slots[index] = {uuid, entity};
+        count++;
+        return true;
+    }
+
+    void UUIDMap::erase(UUID uuid) {
+        if (slots.empty()) {
+            return;
+        }
+
+        const usize mask = slots.size() - 1;
+        usize index = get_home(uuid);
+        while (slots[index].uuid != uuid || slots[index].entity == entt::null) {
+            if (slots[index].entity == entt::null) {
+                return;
+            }
+            index = (index + 1) & mask;
+        }
+
+        // pull back every following entry of the run that would otherwise become unreachable
+        usize hole = index;
+        usize next = (hole + 1) & mask;
+        while (slots[next].entity != entt::null) {
+            const usize home = get_home(slots[next].uuid);
+            // the entry can move into the hole unless its home lies cyclically in (hole, next]
+            const bool stays = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+            if (!stays) {
+                slots[hole] = slots[next];
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+
+        slots[hole] = Slot{0, entt::null};
+        count--;
+    }
+
+    entt::entity UUIDMap::find(UUID uuid) const {
+        if (slots.empty()) {
+            return entt::null;
+        }
+
+        usize index = get_home(uuid);
+        while (slots[index].entity != entt::null) {
+            if (slots[index].uuid == uuid) {
+                return slots[index].entity;
+            }
+            index = (index + 1) & (slots.size() - 1);
+        }
+        return entt::null;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../core/UUID.h"
+#include "../core/types.h"
+
+#include <entt/entity/entity.hpp>
+
+#include <vector>
+
+namespace Engine {
+    // UUID -> entity, open addressing with linear probing in a power of two table kept at most 3/4
+    // full. Erasing shifts the following entries back instead of leaving tombstones, so lookups
+    // never slow down after many destroys. An empty slot is one whose entity is entt::null.
+    class UUIDMap {
+    public:
+        UUIDMap() = default;
+
+        // makes room for count entries without rehashing, for loading whole scenes
+        void reserve(usize count);
+        void clear();
+
+        // false when the UUID is already in the map, the old entry stays
+        bool insert(UUID uuid, entt::entity entity);
+        void erase(UUID uuid);
+
+        // entt::null when the UUID isn't in the map
+        entt::entity find(UUID uuid) const;
+
+        usize size() const { return count; }
+
+    private:
+        struct Slot {
+            u64 uuid;
+            entt::entity entity;
+        };
+
+        usize get_home(u64 uuid) const;
+        void rehash(usize capacity);
+
+        std::vector<Slot> slots;
+        usize count = 0;
+    };
+}
@@ -4,21 +4,32 @@
 #include "core/timestamp.h"
 #include "core/input_manager.h"
 #include "core/window.h"
+#include "core/job_system.h"
+#include "core/mapped_file.h"
+#include "core/atomic_file.h"
 
 #include "data/scene.h"
 #include "data/entity.h"
 #include "data/scene_serializer.h"
+#include "data/binary_scene.h"
+#include "data/scene_saver.h"
+#include "data/scene_query.h"
+#include "data/command_buffer.h"
+#include "data/prefab.h"
 
 #include "graphics/device.h"
 #include "graphics/model.h"
+#include "graphics/cooked_mesh.h"
 #include "graphics/pipeline.h"
 #include "graphics/swapchain.h"
 #include "graphics/renderer.h"
 #include "graphics/camera.h"
 #include "graphics/imgui_layer.h"
 #include "graphics/buffer.h"
+#include "graphics/transform_buffer.h"
 #include "graphics/descriptor_set.h"
 #include "graphics/texture.h"
+#include "graphics/asset_manager.h"
 #include "graphics/core.h"
 #include "graphics/image.h"
 
@@ -35,5 +46,6 @@
 #include "scripting/native_script.h"
 
 #include "physics/physics_system.h"
+#include "physics/jolt_physics_backend.h"
 
 #include "math/math.h"
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "asset_manager.h"
+
+#include "../core/job_system.h"
+
+#include <exception>
+#include <filesystem>
+
+namespace Engine {
+    namespace {
+        template<typename T>
+        struct Cache {
+            std::unordered_map<std::string, std::weak_ptr<T>> assets;
+            usize prune_size = 64; // expired entries are swept when the map grows past this
+
+            std::shared_ptr<T> find(const std::string &key) {
+                auto it = assets.find(key);
+                return it != assets.end() ? it->second.lock() : nullptr;
+            }
+
+            void insert(const std::string &key, const std::shared_ptr<T> &asset) {
+                assets[key] = asset;
+                if (assets.size() > prune_size) {
+                    prune();
+                    prune_size = std::max<usize>(64, assets.size() * 2);
+                }
+            }
+
+            void prune() {
+                for (auto it = assets.begin(); it != assets.end();) {
+                    it = it->second.expired() ? assets.erase(it) : std::next(it);
+                }
+            }
+
+            u32 count_alive() const {
+                u32 count = 0;
+                for (const auto &[key, asset] : assets) {
+                    count += asset.expired() ? 0 : 1;
+                }
+                return count;
+            }
+        };
+
+        std::shared_ptr<Device> device;
+        Cache<Model> models;
+        Cache<Texture> textures;
+        std::shared_ptr<Texture> default_textures[3];
+        AssetManager::Statistics statistics;
+
+        std::string get_texture_key(const std::string &path, ImageFormat format, int components) {
+            return AssetManager::normalize_path(path) + "?format=" + std::to_string(static_cast<int>(format)) + "&components=" + std::to_string(components);
+        }
+    }
+
+    void AssetManager::init(std::shared_ptr<Device> _device) {
+        device = std::move(_device);
+    }
+
+    void AssetManager::shutdown() {
+        for (auto &texture : default_textures) {
+            texture.reset();
+        }
+        models.assets.clear();
+        textures.assets.clear();
+        device.reset();
+    }
+
+    std::shared_ptr<Texture> AssetManager::get_texture(const std::string &path, ImageFormat format, int components) {
+        const std::string key = get_texture_key(path, format, components);
+        if (auto texture = textures.find(key)) {
+            statistics.texture_hits++;
+            return texture;
+        }
+
+        statistics.texture_misses++;
+        auto texture = std::make_shared<Texture>(device, Texture::load_data(path, components), format);
+        textures.insert(key, texture);
+        return texture;
+    }
+
+    std::shared_ptr<Texture> AssetManager::get_texture(const std::string &path, const Texture::Data &data, ImageFormat format) {
+        const std::string key = get_texture_key(path, format, 4);
+        if (auto texture = textures.find(key)) {
+            statistics.texture_hits++;
+            return texture;
+        }
+
+        statistics.texture_misses++;
+        auto texture = std::make_shared<Texture>(device, data, format);
+        textures.insert(key, texture);
+        return texture;
+    }
+
+    std::shared_ptr<Texture> AssetManager::get_default_texture(DefaultTexture type) {
+        auto &texture = default_textures[static_cast<usize>(type)];
+        if (!texture) {
+            Texture::Data data;
+            data.width = 1;
+            data.height = 1;
+            switch (type) {
+                case DefaultTexture::WHITE: data.pixels = {255, 255, 255, 255}; break;
+                case DefaultTexture::BLACK: data.pixels = {0, 0, 0, 255}; break;
+                case DefaultTexture::NORMAL: data.pixels = {128, 128, 255, 255}; break;
+            }
+            texture = std::make_shared<Texture>(device, data);
+        }
+        return texture;
+    }
+
+    std::shared_ptr<Model> AssetManager::get_model(const std::string &path) {
+        return get_models({path})[0];
+    }
+
+    std::vector<std::shared_ptr<Model>> AssetManager::get_models(const std::vector<std::string> &paths) {
+        std::vector<std::shared_ptr<Model>> result(paths.size());
+
+        // the paths that miss, each once, and where their model goes
+        std::vector<std::string> missing_keys;
+        std::vector<std::string> missing_paths;
+        std::vector<std::vector<usize>> missing_slots;
+        std::unordered_map<std::string, usize> missing_indices;
+        for (usize i = 0; i < paths.size(); i++) {
+            const std::string key = normalize_path(paths[i]);
+            if ((result[i] = models.find(key))) {
+                statistics.model_hits++;
+                continue;
+            }
+
+            auto [it, inserted] = missing_indices.try_emplace(key, missing_keys.size());
+            if (inserted) {
+                statistics.model_misses++;
+                missing_keys.push_back(key);
+                missing_paths.push_back(paths[i]);
+                missing_slots.emplace_back();
+            } else {
+                statistics.model_hits++;
+            }
+            missing_slots[it->second].push_back(i);
+        }
+
+        // one path per batch, a model is big enough to be worth a steal on its own
+        std::vector<Model::Data> data(missing_paths.size());
+        std::vector<std::exception_ptr> errors(missing_paths.size());
+        JobSystem::parallel_for(static_cast<u32>(missing_paths.size()), 1, [&](u32 begin, u32 end, u32) {
+            for (u32 i = begin; i < end; i++) {
+                try {
+                    data[i] = Model::load_data(missing_paths[i]);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        });
+
+        for (auto &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // Only the images that aren't loaded yet are decoded, each file once even when several
+        // models use it. The first model using it gets the pixels, the others find its texture.
+        struct MissingImage {
+            usize model;
+            usize image;
+        };
+        std::vector<MissingImage> missing_images;
+        std::unordered_set<std::string> missing_image_keys;
+        for (usize i = 0; i < data.size(); i++) {
+            const auto &image_paths = data[i].image_paths;
+            data[i].images.resize(image_paths.size());
+            for (usize j = 0; j < image_paths.size(); j++) {
+                const std::string key = get_texture_key(image_paths[j], ImageFormat::R8G8B8A8_UNORM, 4);
+                if (!textures.find(key) && missing_image_keys.insert(key).second) {
+                    missing_images.push_back({i, j});
+                }
+            }
+        }
+
+        std::vector<std::exception_ptr> image_errors(missing_images.size());
+        JobSystem::parallel_for(static_cast<u32>(missing_images.size()), 1, [&](u32 begin, u32 end, u32) {
+            for (u32 i = begin; i < end; i++) {
+                const MissingImage &image = missing_images[i];
+                try {
+                    data[image.model].images[image.image] = Texture::load_data(data[image.model].image_paths[image.image]);
+                } catch (...) {
+                    image_errors[i] = std::current_exception();
+                }
+            }
+        });
+
+        for (auto &error : image_errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        for (usize i = 0; i < missing_paths.size(); i++) {
+            auto model = std::make_shared<Model>(device, data[i]);
+            data[i] = {}; // the pixels aren't needed once they're on the device
+            models.insert(missing_keys[i], model);
+            for (usize slot : missing_slots[i]) {
+                result[slot] = model;
+            }
+        }
+
+        return result;
+    }
+
+    AssetManager::Statistics AssetManager::get_statistics() {
+        Statistics result = statistics;
+        result.loaded_models = models.count_alive();
+        result.loaded_textures = textures.count_alive();
+        return result;
+    }
+
+    std::string AssetManager::normalize_path(const std::string &path) {
+        return std::filesystem::absolute(std::filesystem::path(path)).lexically_normal().generic_string();
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../pgepch.h"
+#include "device.h"
+#include "model.h"
+#include "texture.h"
+
+namespace Engine {
+    // Shares the models and textures loaded from files. An asset is keyed by its normalized path and
+    // the settings it was imported with, asking for it again while something still holds it returns
+    // the same handle. The caches only keep weak references, an asset goes away with its last user
+    // and the next request loads it again.
+    //
+    // Main thread only, creating the GPU resources is. get_models() moves the file parsing of the
+    // models that miss and the decoding of their images that miss onto the job system.
+    class AssetManager {
+    public:
+        enum class DefaultTexture {
+            WHITE,  // 1, 1, 1, 1
+            BLACK,  // 0, 0, 0, 1
+            NORMAL, // a flat tangent space normal
+        };
+
+        struct Statistics {
+            u64 model_hits = 0;
+            u64 model_misses = 0;
+            u64 texture_hits = 0;
+            u64 texture_misses = 0;
+            u32 loaded_models = 0;   // still alive
+            u32 loaded_textures = 0; // still alive, default textures not included
+        };
+
+        static void init(std::shared_ptr<Device> device);
+        // drops the default textures and the caches, before the device goes away
+        static void shutdown();
+
+        static std::shared_ptr<Texture> get_texture(const std::string &path, ImageFormat format = ImageFormat::R8G8B8A8_UNORM, int components = 4);
+        // for pixels that are decoded already, they're only uploaded on a miss
+        static std::shared_ptr<Texture> get_texture(const std::string &path, const Texture::Data &data, ImageFormat format = ImageFormat::R8G8B8A8_UNORM);
+        // generated, not loaded from a file, so they're always there
+        static std::shared_ptr<Texture> get_default_texture(DefaultTexture type);
+
+        static std::shared_ptr<Model> get_model(const std::string &path);
+        // One model per path, each distinct path that misses is parsed once with the misses spread
+        // over the job system, then they're uploaded here.
+        static std::vector<std::shared_ptr<Model>> get_models(const std::vector<std::string> &paths);
+
+        static Statistics get_statistics();
+
+        // absolute with the ./ and ../ resolved and forward slashes, without touching the disk
+        static std::string normalize_path(const std::string &path);
+    };
+}
@@ -0,0 +1,187 @@
+#include "cooked_mesh.h"
+
+#include "../core/atomic_file.h"
+#include "../core/mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+namespace Engine {
+    namespace {
+        constexpr u64 section_alignment = 16;
+
+        static_assert(std::is_trivially_copyable_v<MeshFormat::Header>);
+        static_assert(std::is_trivially_copyable_v<MeshFormat::Primitive>);
+        static_assert(std::is_trivially_copyable_v<Model::Vertex>);
+
+        u64 align(u64 offset) {
+            return (offset + section_alignment - 1) / section_alignment * section_alignment;
+        }
+    }
+
+    MeshFormat::Source MeshFormat::get_source(const std::string &path) {
+        std::error_code error;
+        Source source;
+        source.size = static_cast<u64>(std::filesystem::file_size(path, error));
+        if (error) {
+            return {};
+        }
+        source.write_time = static_cast<i64>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+        if (error) {
+            return {};
+        }
+        return source;
+    }
+
+    void write_cooked_mesh(const std::string &path, const Model::Data &data, const MeshFormat::Source &source) {
+        // image paths are stored relative to the cooked file, it can move along with its images
+        const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+        std::string strings;
+        std::vector<MeshFormat::StringRef> images;
+        for (const auto &image_path : data.image_paths) {
+            std::string relative = std::filesystem::path(image_path).lexically_relative(directory).generic_string();
+            if (relative.empty()) {
+                relative = image_path;
+            }
+            images.push_back({static_cast<u32>(strings.size()), static_cast<u32>(relative.size())});
+            strings += relative;
+        }
+
+        MeshFormat::Header header{};
+        std::memcpy(header.magic, MeshFormat::magic, sizeof(header.magic));
+        header.version = MeshFormat::version;
+        header.source = source;
+        header.vertex_size = sizeof(Model::Vertex);
+        header.vertex_count = data.vertex_count;
+        header.index_count = data.index_count;
+        header.primitive_count = static_cast<u32>(data.primitives.size());
+        header.image_count = static_cast<u32>(images.size());
+        header.string_table_size = static_cast<u32>(strings.size());
+        header.bounds_min = data.bounds.min;
+        header.bounds_max = data.bounds.max;
+
+        struct Section {
+            u64 *offset;
+            const void *data;
+            u64 size;
+        };
+        const Section sections[] = {
+            {&header.primitives_offset, data.primitives.data(), data.primitives.size() * sizeof(MeshFormat::Primitive)},
+            {&header.images_offset, images.data(), images.size() * sizeof(MeshFormat::StringRef)},
+            {&header.strings_offset, strings.data(), strings.size()},
+            {&header.vertices_offset, data.vertices, static_cast<u64>(data.vertex_count) * sizeof(Model::Vertex)},
+            {&header.indices_offset, data.indices, static_cast<u64>(data.index_count) * sizeof(u32)},
+        };
+
+        u64 offset = sizeof(header);
+        for (const auto &section : sections) {
+            offset = align(offset);
+            *section.offset = offset;
+            offset += section.size;
+        }
+
+        AtomicFile file{path};
+        auto &stream = file.get_stream();
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        u64 written = sizeof(header);
+        const char padding[section_alignment] = {};
+        for (const auto &section : sections) {
+            stream.write(padding, static_cast<std::streamsize>(*section.offset - written));
+            if (section.size > 0) {
+                stream.write(static_cast<const char *>(section.data), static_cast<std::streamsize>(section.size));
+            }
+            written = *section.offset + section.size;
+        }
+        file.commit();
+    }
+
+    Model::Data read_cooked_mesh(const std::string &path, MeshFormat::Source *source) {
+        auto file = std::make_shared<MappedFile>(path);
+        const u8 *bytes = file->get_data();
+        const usize size = file->get_size();
+
+        MeshFormat::Header header;
+        if (size < sizeof(header)) {
+            throw std::runtime_error("not a cooked mesh: " + path);
+        }
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.magic, MeshFormat::magic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("not a cooked mesh: " + path);
+        }
+        if (header.version != MeshFormat::version || header.vertex_size != sizeof(Model::Vertex)) {
+            throw std::runtime_error("unsupported cooked mesh version: " + path);
+        }
+
+        auto check_section = [&](u64 offset, u64 count, u64 element_size) {
+            if (offset % section_alignment != 0 || offset > size || count > (size - offset) / element_size) {
+                throw std::runtime_error("cooked mesh is truncated: " + path);
+            }
+        };
+        check_section(header.primitives_offset, header.primitive_count, sizeof(MeshFormat::Primitive));
+        check_section(header.images_offset, header.image_count, sizeof(MeshFormat::StringRef));
+        check_section(header.strings_offset, header.string_table_size, 1);
+        check_section(header.vertices_offset, header.vertex_count, sizeof(Model::Vertex));
+        check_section(header.indices_offset, header.index_count, sizeof(u32));
+
+        Model::Data data;
+        data.path = path;
+        data.bounds = AABB{header.bounds_min, header.bounds_max};
+
+        // the primitives are small and get a copy, a mapped file only has to be byte aligned
+        data.primitives.resize(header.primitive_count);
+        std::memcpy(data.primitives.data(), bytes + header.primitives_offset, header.primitive_count * sizeof(MeshFormat::Primitive));
+        for (const auto &primitive : data.primitives) {
+            const bool is_inside = primitive.firstVertex <= header.vertex_count && primitive.vertexCount <= header.vertex_count - primitive.firstVertex &&
+                                   primitive.firstIndex <= header.index_count && primitive.indexCount <= header.index_count - primitive.firstIndex;
+            bool has_images = true;
+            for (i32 image : {primitive.base_color_image, primitive.metallic_roughness_image, primitive.normal_image, primitive.occlusion_image, primitive.emissive_image}) {
+                has_images = has_images && image >= -1 && image < static_cast<i32>(header.image_count);
+            }
+            if (!is_inside || !has_images) {
+                throw std::runtime_error("cooked mesh has a broken primitive: " + path);
+            }
+        }
+
+        const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+        const char *strings = reinterpret_cast<const char *>(bytes + header.strings_offset);
+        for (u32 i = 0; i < header.image_count; i++) {
+            MeshFormat::StringRef image;
+            std::memcpy(&image, bytes + header.images_offset + i * sizeof(image), sizeof(image));
+            if (image.offset > header.string_table_size || image.length > header.string_table_size - image.offset) {
+                throw std::runtime_error("cooked mesh has a broken image path: " + path);
+            }
+            data.image_paths.push_back((directory / std::string{strings + image.offset, image.length}).generic_string());
+        }
+
+        // sections are 16 byte aligned in the file and the mapping starts on a page, so these point
+        // at properly aligned arrays
+        data.vertices = reinterpret_cast<const Model::Vertex *>(bytes + header.vertices_offset);
+        data.vertex_count = header.vertex_count;
+        data.indices = reinterpret_cast<const u32 *>(bytes + header.indices_offset);
+        data.index_count = header.index_count;
+
+        // Indices are drawn with firstVertex as the vertex offset, so they're relative to the range of
+        // their primitive. This reads every index once, the upload right after reads them anyway.
+        for (const auto &primitive : data.primitives) {
+            const u32 *indices = data.indices + primitive.firstIndex;
+            u32 max_index = 0;
+            for (u32 i = 0; i < primitive.indexCount; i++) {
+                max_index = std::max(max_index, indices[i]);
+            }
+            if (primitive.indexCount > 0 && max_index >= primitive.vertexCount) {
+                throw std::runtime_error("cooked mesh has an index outside its primitive: " + path);
+            }
+        }
+
+        data.geometry = std::move(file);
+
+        if (source) {
+            *source = header.source;
+        }
+        return data;
+    }
+}
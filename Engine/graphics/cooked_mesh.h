@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../core/types.h"
+#include "model.h"
+
+#include <string>
+
+namespace Engine {
+    // Cooked mesh, the geometry and materials of a Model already in the layout its buffers use. The
+    // vertices are Model::Vertex and the indices u32 exactly as they go to the GPU, so loading one is
+    // mapping the file and copying both arrays into the staging buffers, the loaded model keeps the
+    // mapping as its CPU side geometry. Materials are the parameters the shader gets plus the image
+    // each texture slot uses, image paths are relative to the cooked file.
+    //
+    // Layout, little endian: Header, Primitive[primitive_count], StringRef[image_count], the string
+    // table, Vertex[vertex_count], u32[index_count], every section 16 byte aligned.
+    namespace MeshFormat {
+        constexpr char magic[4] = {'S', 'M', 'S', 'H'};
+        constexpr u32 version = 1;
+
+        // the glTF a mesh was cooked from, a cooked mesh is stale once its source changes
+        struct Source {
+            u64 size = 0;
+            i64 write_time = 0;
+
+            bool operator==(const Source &other) const { return size == other.size && write_time == other.write_time; }
+        };
+
+        // zeroes when the file isn't there
+        Source get_source(const std::string &path);
+
+        struct Header {
+            char magic[4];
+            u32 version;
+            Source source;
+            u32 vertex_size; // sizeof(Model::Vertex) when it was cooked, another layout means cooking again
+            u32 vertex_count;
+            u32 index_count;
+            u32 primitive_count;
+            u32 image_count;
+            u32 string_table_size;
+            glm::vec3 bounds_min;
+            glm::vec3 bounds_max;
+            u64 primitives_offset; // from the start of the file
+            u64 images_offset;
+            u64 strings_offset;
+            u64 vertices_offset;
+            u64 indices_offset;
+        };
+
+        struct StringRef {
+            u32 offset;
+            u32 length;
+        };
+
+        using Primitive = Model::Data::Primitive;
+    }
+
+    // throws when the file can't be written, replaces it in one step like the scene files
+    void write_cooked_mesh(const std::string &path, const Model::Data &data, const MeshFormat::Source &source);
+
+    // Maps the file and checks every offset, count, index and image reference, throws when anything
+    // is off.
+    // Images come back as paths only, source is filled in with what the mesh was cooked from.
+    Model::Data read_cooked_mesh(const std::string &path, MeshFormat::Source *source = nullptr);
+}
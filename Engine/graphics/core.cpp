@@ -13,6 +13,7 @@ namespace Engine {
                 .add_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1000)
                 .add_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000)
                 .add_pool_size(VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 200)
+                .add_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 100)
                 .build_shared();
 
         global_descriptor_set_layout = DescriptorSetLayout::Builder(device)
@@ -21,6 +22,7 @@ namespace Engine {
                 .add_binding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
                 .add_binding(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
                 .add_binding(4, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
+                .add_binding(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
                 .build_shared();
 
         pbr_material_descriptor_set_layout = DescriptorSetLayout::Builder(device)
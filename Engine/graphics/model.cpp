@@ -11,13 +11,14 @@
 #include <fx/gltf.h>
 
 #include "descriptor_set.h"
+#include "asset_manager.h"
+#include "cooked_mesh.h"
 
 namespace Engine {
 
     Model::~Model() {}
 
-    void Model::createVertexBuffers(const std::vector<Vertex> &vertices) {
-        uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    void Model::createVertexBuffers(const Vertex *vertices, uint32_t vertexCount) {
         assert(vertexCount >= 3 && "Vertex count must be at least 3");
         VkDeviceSize bufferSize = sizeof(vertices[0]) * vertexCount;
         uint32_t vertexSize = sizeof(vertices[0]);
@@ -30,7 +31,7 @@ namespace Engine {
         };
 
         stagingBuffer.map();
-        stagingBuffer.write_to_buffer((void *) vertices.data());
+        stagingBuffer.write_to_buffer((void *) vertices);
 
         vertexBuffer = std::make_unique<Buffer>(m_Device,
                                                 vertexSize,
@@ -41,8 +42,7 @@ namespace Engine {
         m_Device->copy_buffer(stagingBuffer.get_buffer(), vertexBuffer->get_buffer(), bufferSize);
     }
 
-    void Model::createIndexBuffers(const std::vector<uint32_t> &indices) {
-        uint32_t indexCount = static_cast<uint32_t>(indices.size());
+    void Model::createIndexBuffers(const uint32_t *indices, uint32_t indexCount) {
         hasIndexBuffer = indexCount > 0;
 
         if (!hasIndexBuffer) {
@@ -60,7 +60,7 @@ namespace Engine {
         };
 
         stagingBuffer.map();
-        stagingBuffer.write_to_buffer((void *) indices.data());
+        stagingBuffer.write_to_buffer((void *) indices);
 
         indexBuffer = std::make_unique<Buffer>(m_Device,
                                                indexSize,
@@ -104,15 +104,62 @@ namespace Engine {
         }
     }
 
-    Model::Model(std::shared_ptr<Device> device, const std::string &filepath) : m_Path{filepath}, m_Device{device} {
+    Model::Data Model::load_data(const std::string &filepath) {
+        Data data;
+        if (std::filesystem::path(filepath).extension() == ".smesh") {
+            data = read_cooked_mesh(filepath);
+        } else {
+            const std::string cooked_path = filepath + ".smesh";
+            const MeshFormat::Source source = MeshFormat::get_source(filepath);
+
+            bool is_cooked = false;
+            std::error_code error;
+            if (std::filesystem::exists(cooked_path, error)) {
+                // a broken or stale cache is cooked again
+                try {
+                    MeshFormat::Source cooked_source;
+                    data = read_cooked_mesh(cooked_path, &cooked_source);
+                    is_cooked = cooked_source == source;
+                } catch (const std::runtime_error &) {}
+            }
+
+            if (!is_cooked) {
+                data = load_gltf_data(filepath);
+                // the cache is only a shortcut, an asset directory that can't be written to goes without
+                try {
+                    write_cooked_mesh(cooked_path, data, source);
+                } catch (const std::runtime_error &) {}
+            }
+            data.path = filepath;
+        }
+        return data;
+    }
+
+    void Model::cook(const std::string &filepath, const std::string &cooked_path) {
+        write_cooked_mesh(cooked_path, load_gltf_data(filepath), MeshFormat::get_source(filepath));
+    }
+
+    Model::Data Model::load_gltf_data(const std::string &filepath) {
         fx::gltf::Document doc = fx::gltf::LoadFromText(filepath);
         std::filesystem::path path = std::filesystem::path(filepath);
 
+        Data data;
+        data.path = filepath;
+
         for (auto &image: doc.images) {
-            images.push_back(
-                    std::make_shared<Texture>(m_Device, path.parent_path().append(image.uri).generic_string()));
+            data.image_paths.push_back(path.parent_path().append(image.uri).generic_string());
         }
 
+        struct Geometry {
+            std::vector<Vertex> vertices;
+            std::vector<uint32_t> indices;
+        };
+        auto geometry = std::make_shared<Geometry>();
+
+        auto get_image = [&](const fx::gltf::Material::Texture &texture) {
+            return static_cast<i32>(doc.textures[texture.index].source);
+        };
+
         uint32_t vertexOffset = 0;
         uint32_t indexOffset = 0;
 
@@ -160,157 +207,59 @@ namespace Engine {
                     }
                 }
 
-                std::shared_ptr<Texture> defaultTexture = std::make_shared<Texture>(m_Device, "assets/white.png");
-                /*Material material{};
+                Data::Primitive mesh_primitive{};
                 if (primitive.material != -1) {
                     fx::gltf::Material &primitiveMaterial = doc.materials[primitive.material];
-
+                    PBRParameters &pbr_parameters = mesh_primitive.pbr_parameters;
 
                     if (!primitiveMaterial.pbrMetallicRoughness.baseColorTexture.empty()) {
-                        uint32_t textureIndex = primitiveMaterial.pbrMetallicRoughness.baseColorTexture.index;
-                        uint32_t imageIndex = doc.textures[textureIndex].source;
-                        material.albedoTexture = images[imageIndex];
-                    } else {
-                        material.albedoTexture = defaultTexture;
-                    }
-
-                    if (!primitiveMaterial.pbrMetallicRoughness.metallicRoughnessTexture.empty()) {
-                        uint32_t textureIndex = primitiveMaterial.pbrMetallicRoughness.metallicRoughnessTexture.index;
-                        uint32_t imageIndex = doc.textures[textureIndex].source;
-                        material.metallicRoughnessTexture = images[imageIndex];
+                        mesh_primitive.base_color_image = get_image(primitiveMaterial.pbrMetallicRoughness.baseColorTexture);
+                        pbr_parameters.has_base_color_texture = 1;
                     } else {
-                        material.metallicRoughnessTexture = defaultTexture;
-                    }
-
-                    if (!primitiveMaterial.normalTexture.empty()) {
-                        uint32_t textureIndex = primitiveMaterial.normalTexture.index;
-                        uint32_t imageIndex = doc.textures[textureIndex].source;
-                        material.normalTexture = images[imageIndex];
-                    } else {
-                        material.normalTexture = defaultTexture;
-                    }
-                } else {
-                    material.albedoTexture = defaultTexture;
-                    material.normalTexture = defaultTexture;
-                    material.metallicRoughnessTexture = defaultTexture;
-                }
-
-                VkDescriptorImageInfo albedo_image_info = material.albedoTexture->get_descriptor_image_info();
-                VkDescriptorImageInfo normal_image_info = material.normalTexture->get_descriptor_image_info();
-                VkDescriptorImageInfo metallicRoughness_image_info = material.metallicRoughnessTexture->get_descriptor_image_info();
-
-                DescriptorWriter(*Core::pbr_material_descriptor_set_layout, *Core::global_descriptor_pool)
-                        .write_image(0, &albedo_image_info)
-                        .write_image(1, &normal_image_info)
-                        .write_image(2, &metallicRoughness_image_info)
-                        .build(m_Device, material.descriptorSet);*/
-
-                PBRMaterial material = {};
-                if (primitive.material != -1) {
-                    fx::gltf::Material &primitiveMaterial = doc.materials[primitive.material];
-                    if (!primitiveMaterial.pbrMetallicRoughness.baseColorTexture.empty()) {
-                        uint32_t textureIndex = primitiveMaterial.pbrMetallicRoughness.baseColorTexture.index;
-                        uint32_t imageIndex = doc.textures[textureIndex].source;
-                        material.base_color_texture = images[imageIndex];
-                        material.pbr_parameters.has_base_color_texture = 1;
-                    } else {
-                        material.base_color_texture = defaultTexture;
-                        material.pbr_parameters.has_base_color_texture = 0;
+                        pbr_parameters.has_base_color_texture = 0;
                         auto color = primitiveMaterial.pbrMetallicRoughness.baseColorFactor;
-                        material.pbr_parameters.base_color_factor = { color[0], color[1], color[2], color[3] };
+                        pbr_parameters.base_color_factor = { color[0], color[1], color[2], color[3] };
                     }
 
                     if (!primitiveMaterial.pbrMetallicRoughness.metallicRoughnessTexture.empty()) {
-                        uint32_t textureIndex = primitiveMaterial.pbrMetallicRoughness.metallicRoughnessTexture.index;
-                        uint32_t imageIndex = doc.textures[textureIndex].source;
-                        material.metallic_roughness_texture = images[imageIndex];
-                        material.pbr_parameters.has_metallic_roughness_texture = 1;
+                        mesh_primitive.metallic_roughness_image = get_image(primitiveMaterial.pbrMetallicRoughness.metallicRoughnessTexture);
+                        pbr_parameters.has_metallic_roughness_texture = 1;
                     } else {
-                        material.metallic_roughness_texture = defaultTexture;
-                        material.pbr_parameters.has_metallic_roughness_texture = 0;
-                        material.pbr_parameters.metallic_factor = primitiveMaterial.pbrMetallicRoughness.metallicFactor;
-                        material.pbr_parameters.roughness_factor = primitiveMaterial.pbrMetallicRoughness.roughnessFactor;
+                        pbr_parameters.has_metallic_roughness_texture = 0;
+                        pbr_parameters.metallic_factor = primitiveMaterial.pbrMetallicRoughness.metallicFactor;
+                        pbr_parameters.roughness_factor = primitiveMaterial.pbrMetallicRoughness.roughnessFactor;
                     }
 
                     if (!primitiveMaterial.normalTexture.empty()) {
-                        uint32_t textureIndex = primitiveMaterial.normalTexture.index;
-                        uint32_t imageIndex = doc.textures[textureIndex].source;
-                        material.normal_texture = images[imageIndex];
-                        material.pbr_parameters.has_normal_texture = 1;
-                        material.pbr_parameters.scale = primitiveMaterial.normalTexture.scale;
+                        mesh_primitive.normal_image = get_image(primitiveMaterial.normalTexture);
+                        pbr_parameters.has_normal_texture = 1;
+                        pbr_parameters.scale = primitiveMaterial.normalTexture.scale;
                     } else {
-                        material.normal_texture = defaultTexture;
-                        material.pbr_parameters.has_normal_texture = 0;
+                        pbr_parameters.has_normal_texture = 0;
                     }
 
                     if (!primitiveMaterial.occlusionTexture.empty()) {
-                        uint32_t textureIndex = primitiveMaterial.occlusionTexture.index;
-                        uint32_t imageIndex = doc.textures[textureIndex].source;
-                        material.occlusion_texture = images[imageIndex];
-                        material.pbr_parameters.has_occlusion_texture = 1;
+                        mesh_primitive.occlusion_image = get_image(primitiveMaterial.occlusionTexture);
+                        pbr_parameters.has_occlusion_texture = 1;
                     } else {
-                        material.occlusion_texture = defaultTexture;
-                        material.pbr_parameters.has_occlusion_texture = 0;
-                        material.pbr_parameters.strength = primitiveMaterial.occlusionTexture.strength;
+                        pbr_parameters.has_occlusion_texture = 0;
+                        pbr_parameters.strength = primitiveMaterial.occlusionTexture.strength;
                     }
 
                     if (!primitiveMaterial.emissiveTexture.empty()) {
-                        uint32_t textureIndex = primitiveMaterial.emissiveTexture.index;
-                        uint32_t imageIndex = doc.textures[textureIndex].source;
-                        material.emissive_texture = images[imageIndex];
-                        material.pbr_parameters.has_emissive_texture = 1;
+                        mesh_primitive.emissive_image = get_image(primitiveMaterial.emissiveTexture);
+                        pbr_parameters.has_emissive_texture = 1;
                     } else {
-                        material.emissive_texture = defaultTexture;
-                        material.pbr_parameters.has_emissive_texture = 0;
+                        pbr_parameters.has_emissive_texture = 0;
                         auto color = primitiveMaterial.emissiveFactor;
-                        material.pbr_parameters.emissive_factor = { color[0], color[1], color[2] };
+                        pbr_parameters.emissive_factor = { color[0], color[1], color[2] };
                     }
 
-                    material.pbr_parameters.alpha_cut_off = primitiveMaterial.alphaCutoff;
-                    material.pbr_parameters.alpha_mode = static_cast<f32>(primitiveMaterial.alphaMode);
-                } else {
-                    material.base_color_texture = defaultTexture;
-                    material.metallic_roughness_texture = defaultTexture;
-                    material.normal_texture = defaultTexture;
-                    material.occlusion_texture = defaultTexture;
-                    material.emissive_texture = defaultTexture;
+                    pbr_parameters.alpha_cut_off = primitiveMaterial.alphaCutoff;
+                    pbr_parameters.alpha_mode = static_cast<f32>(primitiveMaterial.alphaMode);
                 }
 
-                Buffer stagingBuffer{m_Device,
-                                     sizeof(PBRParameters),
-                                     1,
-                                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                     MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE
-                };
-
-                stagingBuffer.map();
-                stagingBuffer.write_to_buffer(&material.pbr_parameters);
-
-                material.pbr_parameters_buffer = std::make_unique<Buffer>(m_Device,
-                                                       sizeof(PBRParameters),
-                                                       1,
-                                                       VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                       MemoryFlagBits::DEDICATED_MEMORY
-                );
-
-                m_Device->copy_buffer(stagingBuffer.get_buffer(), material.pbr_parameters_buffer->get_buffer(), sizeof(PBRParameters));
-
-                VkDescriptorImageInfo base_color_image_info = material.base_color_texture->get_descriptor_image_info();
-                VkDescriptorImageInfo metallic_roughness_image_info = material.metallic_roughness_texture->get_descriptor_image_info();
-                VkDescriptorImageInfo normal_image_info = material.normal_texture->get_descriptor_image_info();
-                VkDescriptorImageInfo occlusion_image_info = material.occlusion_texture->get_descriptor_image_info();
-                VkDescriptorImageInfo emissive_image_info = material.emissive_texture->get_descriptor_image_info();
-                VkDescriptorBufferInfo pbr_parameters_buffer_info = material.pbr_parameters_buffer->get_descriptor_info();
-
-                DescriptorWriter(*Core::pbr_material_descriptor_set_layout, *Core::global_descriptor_pool)
-                        .write_image(0, &base_color_image_info)
-                        .write_image(1, &metallic_roughness_image_info)
-                        .write_image(2, &normal_image_info)
-                        .write_image(3, &occlusion_image_info)
-                        .write_image(4, &emissive_image_info)
-                        .write_buffer(5, &pbr_parameters_buffer_info)
-                        .build(m_Device, material.descriptor_set);
-
+                geometry->vertices.reserve(geometry->vertices.size() + vertexCount);
                 for (size_t v = 0; v < vertexCount; v++) {
                     Vertex vertex{};
                     vertex.position = glm::make_vec3(&positionBuffer[v * 3]);
@@ -319,7 +268,8 @@ namespace Engine {
                     vertex.tangent = glm::vec4(
                             tangentsBuffer ? glm::make_vec4(&tangentsBuffer[v * 4]) : glm::vec4(0.0f));;
                     vertex.uv = texCoordsBuffer ? glm::make_vec2(&texCoordsBuffer[v * 2]) : glm::vec2(0.0f);
-                    vertices.push_back(vertex);
+                    geometry->vertices.push_back(vertex);
+                    data.bounds.expand_to_include(vertex.position);
                 }
 
                 {
@@ -328,13 +278,14 @@ namespace Engine {
                     const fx::gltf::Buffer &buffer = doc.buffers[bufferView.buffer];
 
                     indexCount += static_cast<uint32_t>(accessor.count);
+                    geometry->indices.reserve(geometry->indices.size() + accessor.count);
 
                     switch (accessor.componentType) {
                         case fx::gltf::Accessor::ComponentType::UnsignedInt: {
                             const uint32_t *buf = reinterpret_cast<const uint32_t *>(&buffer.data[accessor.byteOffset +
                                                                                                   bufferView.byteOffset]);
                             for (size_t index = 0; index < accessor.count; index++) {
-                                indices.push_back(buf[index]);
+                                geometry->indices.push_back(buf[index]);
                             }
                             break;
                         }
@@ -342,7 +293,7 @@ namespace Engine {
                             const uint16_t *buf = reinterpret_cast<const uint16_t *>(&buffer.data[accessor.byteOffset +
                                                                                                   bufferView.byteOffset]);
                             for (size_t index = 0; index < accessor.count; index++) {
-                                indices.push_back(buf[index]);
+                                geometry->indices.push_back(buf[index]);
                             }
                             break;
                         }
@@ -350,32 +301,104 @@ namespace Engine {
                             const uint8_t *buf = reinterpret_cast<const uint8_t *>(&buffer.data[accessor.byteOffset +
                                                                                                 bufferView.byteOffset]);
                             for (size_t index = 0; index < accessor.count; index++) {
-                                indices.push_back(buf[index]);
+                                geometry->indices.push_back(buf[index]);
                             }
                             break;
                         }
                         default:
-                            return;
+                            throw std::runtime_error("unsupported index type in model: " + filepath);
                     }
                 }
 
-                Primitive mesh_primitive{};
                 mesh_primitive.firstVertex = vertexOffset;
                 mesh_primitive.vertexCount = vertexCount;
                 mesh_primitive.indexCount = indexCount;
                 mesh_primitive.firstIndex = indexOffset;
-                mesh_primitive.material = std::move(material);
-                primitives.push_back(mesh_primitive);
+                data.primitives.push_back(mesh_primitive);
 
                 vertexOffset += vertexCount;
                 indexOffset += indexCount;
-
             }
         }
 
-        createVertexBuffers(vertices);
-        createIndexBuffers(indices);
+        data.vertices = geometry->vertices.data();
+        data.vertex_count = static_cast<uint32_t>(geometry->vertices.size());
+        data.indices = geometry->indices.data();
+        data.index_count = static_cast<uint32_t>(geometry->indices.size());
+        data.geometry = std::move(geometry);
+        return data;
+    }
+
+    Model::Model(std::shared_ptr<Device> device, const std::string &filepath) : Model{std::move(device), load_data(filepath)} {}
+
+    Model::Model(std::shared_ptr<Device> device, const Data &data) : bounds{data.bounds}, vertices{data.vertices}, vertex_count{data.vertex_count},
+                                                                     indices{data.indices}, index_count{data.index_count}, geometry{data.geometry},
+                                                                     m_Path{data.path}, m_Device{device} {
+        // an image that's loaded already isn't decoded again
+        for (usize i = 0; i < data.image_paths.size(); i++) {
+            const bool is_decoded = i < data.images.size() && !data.images[i].pixels.empty();
+            images.push_back(is_decoded ? AssetManager::get_texture(data.image_paths[i], data.images[i]) : AssetManager::get_texture(data.image_paths[i]));
+        }
+
+        auto get_texture = [&](i32 image) {
+            return image != -1 ? images[image] : AssetManager::get_default_texture(AssetManager::DefaultTexture::WHITE);
+        };
+
+        for (auto &primitive: data.primitives) {
+            PBRMaterial material = {};
+            material.base_color_texture = get_texture(primitive.base_color_image);
+            material.metallic_roughness_texture = get_texture(primitive.metallic_roughness_image);
+            material.normal_texture = get_texture(primitive.normal_image);
+            material.occlusion_texture = get_texture(primitive.occlusion_image);
+            material.emissive_texture = get_texture(primitive.emissive_image);
+            material.pbr_parameters = primitive.pbr_parameters;
+
+            Buffer stagingBuffer{m_Device,
+                                 sizeof(PBRParameters),
+                                 1,
+                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                 MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE
+            };
+
+            stagingBuffer.map();
+            stagingBuffer.write_to_buffer(&material.pbr_parameters);
+
+            material.pbr_parameters_buffer = std::make_unique<Buffer>(m_Device,
+                                                   sizeof(PBRParameters),
+                                                   1,
+                                                   VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                   MemoryFlagBits::DEDICATED_MEMORY
+            );
+
+            m_Device->copy_buffer(stagingBuffer.get_buffer(), material.pbr_parameters_buffer->get_buffer(), sizeof(PBRParameters));
+
+            VkDescriptorImageInfo base_color_image_info = material.base_color_texture->get_descriptor_image_info();
+            VkDescriptorImageInfo metallic_roughness_image_info = material.metallic_roughness_texture->get_descriptor_image_info();
+            VkDescriptorImageInfo normal_image_info = material.normal_texture->get_descriptor_image_info();
+            VkDescriptorImageInfo occlusion_image_info = material.occlusion_texture->get_descriptor_image_info();
+            VkDescriptorImageInfo emissive_image_info = material.emissive_texture->get_descriptor_image_info();
+            VkDescriptorBufferInfo pbr_parameters_buffer_info = material.pbr_parameters_buffer->get_descriptor_info();
+
+            DescriptorWriter(*Core::pbr_material_descriptor_set_layout, *Core::global_descriptor_pool)
+                    .write_image(0, &base_color_image_info)
+                    .write_image(1, &metallic_roughness_image_info)
+                    .write_image(2, &normal_image_info)
+                    .write_image(3, &occlusion_image_info)
+                    .write_image(4, &emissive_image_info)
+                    .write_buffer(5, &pbr_parameters_buffer_info)
+                    .build(m_Device, material.descriptor_set);
+
+            Primitive mesh_primitive{};
+            mesh_primitive.firstVertex = primitive.firstVertex;
+            mesh_primitive.vertexCount = primitive.vertexCount;
+            mesh_primitive.indexCount = primitive.indexCount;
+            mesh_primitive.firstIndex = primitive.firstIndex;
+            mesh_primitive.material = std::move(material);
+            primitives.push_back(mesh_primitive);
+        }
 
+        createVertexBuffers(vertices, vertex_count);
+        createIndexBuffers(indices, index_count);
     }
 
     std::vector<VkVertexInputBindingDescription> Model::Vertex::getBindingDescriptions() {
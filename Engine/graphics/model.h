@@ -14,6 +14,7 @@
 #include "texture.h"
 #include "descriptor_set.h"
 #include "frame_info.h"
+#include "../math/aabb.h"
 
 namespace Engine {
     class Model {
@@ -77,7 +78,51 @@ namespace Engine {
             }
         };
 
+        // Everything in a model file that doesn't need the device: geometry, the image files and which
+        // image each material slot uses. Loading it is the slow part and safe on any thread.
+        struct Data {
+            struct Primitive {
+                uint32_t firstIndex;
+                uint32_t firstVertex;
+                uint32_t indexCount;
+                uint32_t vertexCount;
+                PBRParameters pbr_parameters = {};
+                // indices into images, -1 uses the default white texture
+                i32 base_color_image = -1;
+                i32 metallic_roughness_image = -1;
+                i32 normal_image = -1;
+                i32 occlusion_image = -1;
+                i32 emissive_image = -1;
+            };
+
+            std::string path;
+            // in the vertex and index buffer layout, either parsed into memory or pointing into a
+            // mapped cooked mesh, geometry keeps whichever it is alive
+            const Vertex *vertices = nullptr;
+            uint32_t vertex_count = 0;
+            const uint32_t *indices = nullptr;
+            uint32_t index_count = 0;
+            std::shared_ptr<const void> geometry;
+            std::vector<Primitive> primitives;
+            std::vector<std::string> image_paths;
+            // Decoded ahead of time by whoever knows they miss the texture cache, by image. Left empty
+            // the model looks its images up by path and only decodes the ones that aren't loaded yet.
+            std::vector<Texture::Data> images;
+            AABB bounds;
+        };
+
+        // Reads a glTF or a cooked mesh (.smesh, see cooked_mesh.h). A glTF is cooked into
+        // filepath + ".smesh" the first time, later loads map that instead as long as the glTF keeps
+        // its size and write time. Images aren't decoded here. Throws when the file can't be read.
+        static Data load_data(const std::string &filepath);
+
+        // parses a glTF and writes its cooked mesh, for cooking offline
+        static void cook(const std::string &filepath, const std::string &cooked_path);
+
+        // AssetManager::get_model() shares models, these always load a new one. Images go through the
+        // AssetManager either way, models using the same image files share the textures.
         Model(std::shared_ptr<Device> device, const std::string &filepath);
+        Model(std::shared_ptr<Device> device, const Data &data);
         ~Model();
 
         void bind(VkCommandBuffer commandBuffer);
@@ -86,14 +131,27 @@ namespace Engine {
 
         std::string getPath() { return m_Path; }
 
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
+        // the geometry the buffers were filled from, kept on the CPU for physics shapes and the like
+        const Vertex *get_vertices() const { return vertices; }
+        uint32_t get_vertex_count() const { return vertex_count; }
+        const uint32_t *get_indices() const { return indices; }
+        uint32_t get_index_count() const { return index_count; }
+
         std::vector<Primitive> primitives;
         std::vector<std::shared_ptr<Texture>> images;
+        AABB bounds; // model space bounds of all primitives
     private:
-        void createVertexBuffers(const std::vector<Vertex> &vertices);
+        static Data load_gltf_data(const std::string &filepath);
+
+        void createVertexBuffers(const Vertex *vertices, uint32_t vertexCount);
+
+        void createIndexBuffers(const uint32_t *indices, uint32_t indexCount);
 
-        void createIndexBuffers(const std::vector<uint32_t> &indices);
+        const Vertex *vertices = nullptr;
+        uint32_t vertex_count = 0;
+        const uint32_t *indices = nullptr;
+        uint32_t index_count = 0;
+        std::shared_ptr<const void> geometry;
 
         std::unique_ptr<Buffer> vertexBuffer;
 
@@ -5,18 +5,36 @@
 #include <stb_image.h>
 
 namespace Engine {
-    Texture::Texture(std::shared_ptr<Device> _device, const std::string &path, ImageFormat format, int components) : device{_device} {
-        int width, height, channels, m_BytesPerPixel;
+    Texture::Data Texture::load_data(const std::string &path, int components) {
+        int width, height, channels;
 
-        stbi_set_flip_vertically_on_load(0);
-        stbi_uc* data = stbi_load(path.c_str(), &width, &height, &m_BytesPerPixel, components);
+        // the thread local flag, other loaders flip their images on the main thread
+        stbi_set_flip_vertically_on_load_thread(0);
+        stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, components);
+        if (!pixels) {
+            throw std::runtime_error("failed to load texture: " + path);
+        }
+
+        Data data;
+        data.width = width;
+        data.height = height;
+        data.pixels.assign(pixels, pixels + static_cast<usize>(width) * static_cast<usize>(height) * static_cast<usize>(components));
+        stbi_image_free(pixels);
+        return data;
+    }
+
+    Texture::Texture(std::shared_ptr<Device> _device, const std::string &path, ImageFormat format, int components) : Texture{std::move(_device), load_data(path, components), format} {}
+
+    Texture::Texture(std::shared_ptr<Device> _device, const Data &data, ImageFormat format) : device{_device} {
+        const int width = data.width;
+        const int height = data.height;
 
         u32 mip_levels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
 
         Buffer stagingBuffer{device, 4, static_cast<uint32_t>(width * height), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE};
 
         stagingBuffer.map();
-        stagingBuffer.write_to_buffer(data);
+        stagingBuffer.write_to_buffer((void *) data.pixels.data());
 
         vk_format = (VkFormat)format;
 
@@ -43,8 +61,6 @@ namespace Engine {
             .mip_levels = mip_levels,
             .image = image
         });
-
-        stbi_image_free(data);
     }
 
     Texture::~Texture() {
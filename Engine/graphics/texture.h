@@ -9,7 +9,19 @@
 namespace Engine {
     class Texture {
     public:
+        // decoded pixels, loading them doesn't touch the device so it can run on any thread
+        struct Data {
+            i32 width = 0;
+            i32 height = 0;
+            std::vector<u8> pixels; // width * height * components, rows top to bottom
+        };
+
+        // throws when the image can't be read
+        static Data load_data(const std::string &filepath, int components = 4);
+
         Texture(std::shared_ptr<Device> _device, const std::string &filepath, ImageFormat format = ImageFormat::R8G8B8A8_UNORM, int components = 4);
+        // uploads already decoded pixels, main thread only like every other upload
+        Texture(std::shared_ptr<Device> _device, const Data &data, ImageFormat format = ImageFormat::R8G8B8A8_UNORM);
         ~Texture();
 
         Texture(const Texture &) = delete;
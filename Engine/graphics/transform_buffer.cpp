@@ -0,0 +1,60 @@
+#include "transform_buffer.h"
+
+#include "../data/scene.h"
+#include "../data/components.h"
+
+#include <utility>
+
+namespace Engine {
+    TransformBuffer::TransformBuffer(std::shared_ptr<Device> _device) : device{std::move(_device)} {
+        for (auto &frame : frames) {
+            allocate(frame, initial_capacity);
+        }
+    }
+
+    void TransformBuffer::allocate(Frame &frame, u32 capacity) {
+        frame.buffer = std::make_unique<Buffer>(device, sizeof(GpuTransform), capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE);
+        frame.buffer->map();
+        frame.capacity = capacity;
+        frame.entities.assign(capacity, entt::null);
+        frame.versions.assign(capacity, 0);
+    }
+
+    bool TransformBuffer::update(u32 frame_index, Scene &scene) {
+        Frame &frame = frames[frame_index];
+        auto models = scene.group<ModelComponent>(entt::get<TransformComponent>);
+
+        bool grown = false;
+        const u32 count = static_cast<u32>(models.size());
+        if (count > frame.capacity) {
+            u32 capacity = frame.capacity;
+            while (capacity < count) {
+                capacity *= 2;
+            }
+            allocate(frame, capacity);
+            grown = true;
+        }
+
+        // the group keeps its order while nothing is added or removed, so slots mostly stay put
+        auto *transforms = static_cast<GpuTransform *>(frame.buffer->get_mapped_memory());
+        u32 index = 0;
+        models.each([&](auto entity, ModelComponent &mc, TransformComponent &tc) {
+            mc.transform_index = index;
+            if (frame.entities[index] != entity || frame.versions[index] != tc.version) {
+                transforms[index] = {tc.model_matrix, tc.normal_matrix};
+                frame.entities[index] = entity;
+                frame.versions[index] = tc.version;
+            }
+            index++;
+        });
+
+        if (count > 0) {
+            frame.buffer->flush(count * sizeof(GpuTransform), 0);
+        }
+        return grown;
+    }
+
+    VkDescriptorBufferInfo TransformBuffer::get_descriptor_info(u32 frame_index) const {
+        return frames[frame_index].buffer->get_descriptor_info();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "buffer.h"
+#include "swapchain.h"
+#include "../core/types.h"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Engine {
+    class Scene;
+
+    // World and normal matrices of every model in a scene, in one storage buffer per frame in flight
+    // bound at set 0, binding 5. Draws push ModelComponent::transform_index instead of the matrices.
+    class TransformBuffer {
+    public:
+        static constexpr u32 binding = 5;
+        static constexpr u32 initial_capacity = 1024;
+
+        struct GpuTransform {
+            glm::mat4 model_matrix{1.0f};
+            glm::mat4 normal_matrix{1.0f};
+        };
+
+        explicit TransformBuffer(std::shared_ptr<Device> _device);
+
+        TransformBuffer(const TransformBuffer &) = delete;
+        TransformBuffer &operator=(const TransformBuffer &) = delete;
+
+        // Hands out the transform indices and copies the matrices that changed since this frame's
+        // buffer was last written. Returns true when the buffer had to grow, the descriptor of the
+        // frame has to be written again then.
+        bool update(u32 frame_index, Scene &scene);
+
+        VkDescriptorBufferInfo get_descriptor_info(u32 frame_index) const;
+
+    private:
+        struct Frame {
+            std::unique_ptr<Buffer> buffer;
+            u32 capacity = 0;
+
+            // what each slot holds right now, a slot is only written again when either changes
+            std::vector<entt::entity> entities;
+            std::vector<u32> versions;
+        };
+
+        void allocate(Frame &frame, u32 capacity);
+
+        std::shared_ptr<Device> device;
+        std::array<Frame, SwapChain::MAX_FRAMES_IN_FLIGHT> frames;
+    };
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../core/types.h"
+
+namespace Engine {
+    struct AABB {
+        glm::vec3 min = glm::vec3{std::numeric_limits<f32>::max()};
+        glm::vec3 max = glm::vec3{-std::numeric_limits<f32>::max()};
+
+        AABB() = default;
+        AABB(const glm::vec3 &_min, const glm::vec3 &_max) : min{_min}, max{_max} {}
+
+        static AABB merge(const AABB &a, const AABB &b) {
+            return AABB{glm::min(a.min, b.min), glm::max(a.max, b.max)};
+        }
+
+        bool overlaps(const AABB &other) const {
+            return min.x <= other.max.x && max.x >= other.min.x &&
+                   min.y <= other.max.y && max.y >= other.min.y &&
+                   min.z <= other.max.z && max.z >= other.min.z;
+        }
+
+        bool contains(const AABB &other) const {
+            return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+                   max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+        }
+
+        void expand(const f32 &margin) {
+            min -= glm::vec3{margin};
+            max += glm::vec3{margin};
+        }
+
+        void expand_to_include(const glm::vec3 &point) {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        bool is_valid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+        // Slab test against origin + t * direction, t_entry is clamped to zero when the origin is inside.
+        bool ray_intersects(const glm::vec3 &origin, const glm::vec3 &inverse_direction, const f32 &max_distance, f32 &t_entry) const {
+            glm::vec3 t1 = (min - origin) * inverse_direction;
+            glm::vec3 t2 = (max - origin) * inverse_direction;
+            glm::vec3 t_min = glm::min(t1, t2);
+            glm::vec3 t_max = glm::max(t1, t2);
+
+            f32 entry = std::max(std::max(t_min.x, t_min.y), std::max(t_min.z, 0.0f));
+            f32 exit = std::min(std::min(t_max.x, t_max.y), std::min(t_max.z, max_distance));
+            if (entry > exit) {
+                return false;
+            }
+
+            t_entry = entry;
+            return true;
+        }
+
+        // bounds of the box after an affine transform, from the transformed center and extents
+        AABB transformed(const glm::mat4 &transform) const {
+            const glm::vec3 c = glm::vec3{transform * glm::vec4{center(), 1.0f}};
+            const glm::vec3 e = extents();
+
+            glm::vec3 new_extents{0.0f};
+            for (glm::length_t i = 0; i < 3; i++) {
+                for (glm::length_t j = 0; j < 3; j++) {
+                    new_extents[i] += std::abs(transform[j][i]) * e[j];
+                }
+            }
+
+            return AABB{c - new_extents, c + new_extents};
+        }
+
+        glm::vec3 closest_point(const glm::vec3 &point) const { return glm::clamp(point, min, max); }
+
+        glm::vec3 center() const { return (min + max) * 0.5f; }
+        glm::vec3 extents() const { return (max - min) * 0.5f; }
+
+        // used as the insertion cost, cheaper than the volume and behaves better for flat boxes
+        f32 surface_area() const {
+            glm::vec3 d = max - min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+    };
+}
@@ -0,0 +1,271 @@
+#include "transform_kernels.h"
+
+#include <cmath>
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace Engine::TransformKernels {
+    namespace {
+        // the part of a rotation matrix a quaternion turns into, row major r[row][column]
+        void quaternion_to_rotation(f32 x, f32 y, f32 z, f32 w, f32 r[3][3]) {
+            r[0][0] = 1.0f - 2.0f * (y * y + z * z);
+            r[1][0] = 2.0f * (x * y + w * z);
+            r[2][0] = 2.0f * (x * z - w * y);
+            r[0][1] = 2.0f * (x * y - w * z);
+            r[1][1] = 1.0f - 2.0f * (x * x + z * z);
+            r[2][1] = 2.0f * (y * z + w * x);
+            r[0][2] = 2.0f * (x * z + w * y);
+            r[1][2] = 2.0f * (y * z - w * x);
+            r[2][2] = 1.0f - 2.0f * (x * x + y * y);
+        }
+
+        void compose_one(const TransformArrays &transforms, u32 i, glm::mat4 &matrix) {
+            const f32 cx = std::cos(transforms.rotation[0][i] * 0.5f), sx = std::sin(transforms.rotation[0][i] * 0.5f);
+            const f32 cy = std::cos(transforms.rotation[1][i] * 0.5f), sy = std::sin(transforms.rotation[1][i] * 0.5f);
+            const f32 cz = std::cos(transforms.rotation[2][i] * 0.5f), sz = std::sin(transforms.rotation[2][i] * 0.5f);
+
+            f32 r[3][3];
+            quaternion_to_rotation(sx * cy * cz - cx * sy * sz, cx * sy * cz + sx * cy * sz, cx * cy * sz - sx * sy * cz, cx * cy * cz + sx * sy * sz, r);
+
+            for (u32 column = 0; column < 3; column++) {
+                const f32 scale = transforms.scale[column][i];
+                matrix[column] = glm::vec4{r[0][column] * scale, r[1][column] * scale, r[2][column] * scale, 0.0f};
+            }
+            matrix[3] = glm::vec4{transforms.translation[0][i], transforms.translation[1][i], transforms.translation[2][i], 1.0f};
+        }
+
+        void decompose_angles(const f32 column_0[3], const f32 column_1[3], const f32 column_2[3], f32 &x, f32 &y, f32 &z) {
+            y = std::asin(-column_0[2]);
+            if (std::cos(y) != 0.0f) {
+                x = std::atan2(column_1[2], column_2[2]);
+                z = std::atan2(column_0[1], column_0[0]);
+            } else {
+                x = std::atan2(-column_2[0], column_1[1]);
+                z = 0.0f;
+            }
+        }
+
+        void decompose_one(const glm::mat4 &matrix, const TransformArrays &transforms, u32 i) {
+            f32 columns[3][3];
+            for (u32 column = 0; column < 3; column++) {
+                const glm::vec3 axis{matrix[column]};
+                const f32 scale = glm::length(axis);
+                transforms.scale[column][i] = scale;
+                for (u32 row = 0; row < 3; row++) {
+                    columns[column][row] = axis[row] / scale;
+                }
+                transforms.translation[column][i] = matrix[3][column];
+            }
+
+            decompose_angles(columns[0], columns[1], columns[2], transforms.rotation[0][i], transforms.rotation[1][i], transforms.rotation[2][i]);
+        }
+
+        // Thin wrappers so the wide kernels below are written once for both vector widths.
+#if defined(__SSE2__) || defined(_M_X64)
+        struct Wide4 {
+            using Type = __m128;
+            static constexpr u32 width = 4;
+
+            static Type load(const f32 *p) { return _mm_loadu_ps(p); }
+            static void store(f32 *p, Type a) { _mm_storeu_ps(p, a); }
+            static Type set(f32 a) { return _mm_set1_ps(a); }
+            static Type add(Type a, Type b) { return _mm_add_ps(a, b); }
+            static Type sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+            static Type mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+            static Type div(Type a, Type b) { return _mm_div_ps(a, b); }
+            static Type sqrt(Type a) { return _mm_sqrt_ps(a); }
+            static Type round(Type a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+            static Type floor(Type a) {
+                Type truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+                return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1.0f)));
+            }
+            static Type equal(Type a, Type b) { return _mm_cmpeq_ps(a, b); }
+            static Type greater_equal(Type a, Type b) { return _mm_cmpge_ps(a, b); }
+            static Type select(Type mask, Type a, Type b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+            static Type negate_if(Type mask, Type a) { return _mm_xor_ps(a, _mm_and_ps(mask, _mm_set1_ps(-0.0f))); }
+        };
+#endif
+
+#if defined(__AVX__)
+        struct Wide8 {
+            using Type = __m256;
+            static constexpr u32 width = 8;
+
+            static Type load(const f32 *p) { return _mm256_loadu_ps(p); }
+            static void store(f32 *p, Type a) { _mm256_storeu_ps(p, a); }
+            static Type set(f32 a) { return _mm256_set1_ps(a); }
+            static Type add(Type a, Type b) { return _mm256_add_ps(a, b); }
+            static Type sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+            static Type mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+            static Type div(Type a, Type b) { return _mm256_div_ps(a, b); }
+            static Type sqrt(Type a) { return _mm256_sqrt_ps(a); }
+            static Type round(Type a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+            static Type floor(Type a) { return _mm256_floor_ps(a); }
+            static Type equal(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+            static Type greater_equal(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+            static Type select(Type mask, Type a, Type b) { return _mm256_blendv_ps(b, a, mask); }
+            static Type negate_if(Type mask, Type a) { return _mm256_xor_ps(a, _mm256_and_ps(mask, _mm256_set1_ps(-0.0f))); }
+        };
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+        // Cephes style sine and cosine, within a couple of ulp of std::sin/std::cos for the angles a
+        // transform sees. The argument is reduced to [-pi/4, pi/4] around the closest multiple of pi/2.
+        template<typename W>
+        void sin_cos(typename W::Type a, typename W::Type &sin, typename W::Type &cos) {
+            const typename W::Type quadrant = W::round(W::mul(a, W::set(0.636619772367581f)));
+
+            typename W::Type x = W::sub(a, W::mul(quadrant, W::set(1.5703125f)));
+            x = W::sub(x, W::mul(quadrant, W::set(4.837512969970703125e-4f)));
+            x = W::sub(x, W::mul(quadrant, W::set(7.54978995489188216e-8f)));
+            const typename W::Type z = W::mul(x, x);
+
+            typename W::Type s = W::add(W::mul(z, W::set(-1.9515295891e-4f)), W::set(8.3321608736e-3f));
+            s = W::add(W::mul(s, z), W::set(-1.6666654611e-1f));
+            s = W::add(W::mul(W::mul(s, z), x), x);
+
+            typename W::Type c = W::add(W::mul(z, W::set(2.443315711809948e-5f)), W::set(-1.388731625493765e-3f));
+            c = W::add(W::mul(c, z), W::set(4.166664568298827e-2f));
+            c = W::add(W::sub(W::mul(W::mul(c, z), z), W::mul(z, W::set(0.5f))), W::set(1.0f));
+
+            // quadrant mod 4 picks which polynomial is which and their signs
+            const typename W::Type q = W::sub(quadrant, W::mul(W::floor(W::mul(quadrant, W::set(0.25f))), W::set(4.0f)));
+            const typename W::Type swap = W::equal(W::sub(q, W::mul(W::floor(W::mul(q, W::set(0.5f))), W::set(2.0f))), W::set(1.0f));
+            const typename W::Type negate_sin = W::greater_equal(q, W::set(2.0f));
+            const typename W::Type negate_cos = W::equal(W::floor(W::mul(W::add(q, W::set(1.0f)), W::set(0.5f))), W::set(1.0f));
+
+            sin = W::negate_if(negate_sin, W::select(swap, c, s));
+            cos = W::negate_if(negate_cos, W::select(swap, s, c));
+        }
+
+        template<typename W>
+        void compose_wide(const TransformArrays &transforms, u32 i, glm::mat4 *matrices) {
+            using T = typename W::Type;
+            const T half = W::set(0.5f);
+            const T one = W::set(1.0f);
+            const T two = W::set(2.0f);
+
+            T sx, cx, sy, cy, sz, cz;
+            sin_cos<W>(W::mul(W::load(transforms.rotation[0] + i), half), sx, cx);
+            sin_cos<W>(W::mul(W::load(transforms.rotation[1] + i), half), sy, cy);
+            sin_cos<W>(W::mul(W::load(transforms.rotation[2] + i), half), sz, cz);
+
+            // euler angles to quaternion, the same order glm::quat(vec3) uses
+            const T cy_cz = W::mul(cy, cz), sy_sz = W::mul(sy, sz);
+            const T sy_cz = W::mul(sy, cz), cy_sz = W::mul(cy, sz);
+            const T qx = W::sub(W::mul(sx, cy_cz), W::mul(cx, sy_sz));
+            const T qy = W::add(W::mul(cx, sy_cz), W::mul(sx, cy_sz));
+            const T qz = W::sub(W::mul(cx, cy_sz), W::mul(sx, sy_cz));
+            const T qw = W::add(W::mul(cx, cy_cz), W::mul(sx, sy_sz));
+
+            const T xx = W::mul(qx, qx), yy = W::mul(qy, qy), zz = W::mul(qz, qz);
+            const T xy = W::mul(qx, qy), xz = W::mul(qx, qz), yz = W::mul(qy, qz);
+            const T wx = W::mul(qw, qx), wy = W::mul(qw, qy), wz = W::mul(qw, qz);
+
+            const T scale_x = W::load(transforms.scale[0] + i);
+            const T scale_y = W::load(transforms.scale[1] + i);
+            const T scale_z = W::load(transforms.scale[2] + i);
+
+            // columns of rotation * scale, then the translation column
+            f32 lanes[12][W::width];
+            W::store(lanes[0], W::mul(W::sub(one, W::mul(two, W::add(yy, zz))), scale_x));
+            W::store(lanes[1], W::mul(W::mul(two, W::add(xy, wz)), scale_x));
+            W::store(lanes[2], W::mul(W::mul(two, W::sub(xz, wy)), scale_x));
+            W::store(lanes[3], W::mul(W::mul(two, W::sub(xy, wz)), scale_y));
+            W::store(lanes[4], W::mul(W::sub(one, W::mul(two, W::add(xx, zz))), scale_y));
+            W::store(lanes[5], W::mul(W::mul(two, W::add(yz, wx)), scale_y));
+            W::store(lanes[6], W::mul(W::mul(two, W::add(xz, wy)), scale_z));
+            W::store(lanes[7], W::mul(W::mul(two, W::sub(yz, wx)), scale_z));
+            W::store(lanes[8], W::mul(W::sub(one, W::mul(two, W::add(xx, yy))), scale_z));
+            W::store(lanes[9], W::load(transforms.translation[0] + i));
+            W::store(lanes[10], W::load(transforms.translation[1] + i));
+            W::store(lanes[11], W::load(transforms.translation[2] + i));
+
+            for (u32 lane = 0; lane < W::width; lane++) {
+                glm::mat4 &matrix = matrices[i + lane];
+                matrix[0] = glm::vec4{lanes[0][lane], lanes[1][lane], lanes[2][lane], 0.0f};
+                matrix[1] = glm::vec4{lanes[3][lane], lanes[4][lane], lanes[5][lane], 0.0f};
+                matrix[2] = glm::vec4{lanes[6][lane], lanes[7][lane], lanes[8][lane], 0.0f};
+                matrix[3] = glm::vec4{lanes[9][lane], lanes[10][lane], lanes[11][lane], 1.0f};
+            }
+        }
+
+        template<typename W>
+        void decompose_wide(const glm::mat4 *matrices, u32 i, const TransformArrays &transforms) {
+            using T = typename W::Type;
+
+            f32 lanes[9][W::width];
+            for (u32 lane = 0; lane < W::width; lane++) {
+                const glm::mat4 &matrix = matrices[i + lane];
+                for (u32 column = 0; column < 3; column++) {
+                    for (u32 row = 0; row < 3; row++) {
+                        lanes[column * 3 + row][lane] = matrix[column][row];
+                    }
+                    transforms.translation[column][i + lane] = matrix[3][column];
+                }
+            }
+
+            for (u32 column = 0; column < 3; column++) {
+                T x = W::load(lanes[column * 3 + 0]);
+                T y = W::load(lanes[column * 3 + 1]);
+                T z = W::load(lanes[column * 3 + 2]);
+
+                const T scale = W::sqrt(W::add(W::add(W::mul(x, x), W::mul(y, y)), W::mul(z, z)));
+                W::store(transforms.scale[column] + i, scale);
+                W::store(lanes[column * 3 + 0], W::div(x, scale));
+                W::store(lanes[column * 3 + 1], W::div(y, scale));
+                W::store(lanes[column * 3 + 2], W::div(z, scale));
+            }
+
+            for (u32 lane = 0; lane < W::width; lane++) {
+                const f32 column_0[3] = {lanes[0][lane], lanes[1][lane], lanes[2][lane]};
+                const f32 column_1[3] = {lanes[3][lane], lanes[4][lane], lanes[5][lane]};
+                const f32 column_2[3] = {lanes[6][lane], lanes[7][lane], lanes[8][lane]};
+                decompose_angles(column_0, column_1, column_2, transforms.rotation[0][i + lane], transforms.rotation[1][i + lane], transforms.rotation[2][i + lane]);
+            }
+        }
+#endif
+    }
+
+    void compose(const TransformArrays &transforms, u32 count, glm::mat4 *matrices) {
+        u32 i = 0;
+
+#if defined(__AVX__)
+        for (; i + Wide8::width <= count; i += Wide8::width) {
+            compose_wide<Wide8>(transforms, i, matrices);
+        }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+        for (; i + Wide4::width <= count; i += Wide4::width) {
+            compose_wide<Wide4>(transforms, i, matrices);
+        }
+#endif
+
+        for (; i < count; i++) {
+            compose_one(transforms, i, matrices[i]);
+        }
+    }
+
+    void decompose(const glm::mat4 *matrices, u32 count, const TransformArrays &transforms) {
+        u32 i = 0;
+
+#if defined(__AVX__)
+        for (; i + Wide8::width <= count; i += Wide8::width) {
+            decompose_wide<Wide8>(matrices, i, transforms);
+        }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+        for (; i + Wide4::width <= count; i += Wide4::width) {
+            decompose_wide<Wide4>(matrices, i, transforms);
+        }
+#endif
+
+        for (; i < count; i++) {
+            decompose_one(matrices[i], transforms, i);
+        }
+    }
+}
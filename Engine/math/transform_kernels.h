@@ -0,0 +1,23 @@
+#pragma once
+
+#include "../core/types.h"
+
+#include <glm/glm.hpp>
+
+// Batch versions of TransformComponent::calculate_matrix and Math::decompose_transform over
+// transforms stored one array per component. Eight transforms go through per iteration with AVX
+// (STELLAR_ENABLE_AVX2), four with SSE2 on every other x86-64 build and one at a time elsewhere.
+namespace Engine::TransformKernels {
+    struct TransformArrays {
+        f32 *translation[3];
+        f32 *rotation[3]; // euler angles in radians, like TransformComponent::rotation
+        f32 *scale[3];
+    };
+
+    // matrices[i] = translate(translation) * toMat4(quat(rotation)) * scale(scale)
+    void compose(const TransformArrays &transforms, u32 count, glm::mat4 *matrices);
+
+    // Splits affine matrices back into translation, euler angles and scale. The angles come out the
+    // same as from Math::decompose_transform and are still computed one lane at a time.
+    void decompose(const glm::mat4 *matrices, u32 count, const TransformArrays &transforms);
+}
@@ -0,0 +1,168 @@
+#include "body_store.h"
+
+#include "dynamic_aabb_tree.h"
+
+#include <utility>
+
+namespace Engine {
+    u32 BodyStore::add(entt::entity entity) {
+        auto index = static_cast<usize>(entt::to_entity(entity));
+        if (index >= sparse.size()) {
+            sparse.resize(index + 1, invalid_body);
+        }
+
+        if (sparse[index] != invalid_body) {
+            return sparse[index];
+        }
+
+        u32 body = size();
+        sparse[index] = body;
+
+        position_x.push_back(0.0f);
+        position_y.push_back(0.0f);
+        position_z.push_back(0.0f);
+        previous_position_x.push_back(0.0f);
+        previous_position_y.push_back(0.0f);
+        previous_position_z.push_back(0.0f);
+        velocity_x.push_back(0.0f);
+        velocity_y.push_back(0.0f);
+        velocity_z.push_back(0.0f);
+        inverse_mass.push_back(0.0f);
+        elasticity.push_back(0.0f);
+        radius.push_back(0.0f);
+        sleep_timers.push_back(0.0f);
+        islands.push_back(invalid_island);
+        shapes.push_back(nullptr);
+        broadphase_proxies.push_back(DynamicAABBTree::null_node);
+        entities.push_back(entity);
+
+        return body;
+    }
+
+    void BodyStore::remove(entt::entity entity) {
+        u32 body = get_index(entity);
+        if (body == invalid_body) {
+            return;
+        }
+
+        // keep the awake bodies packed at the front
+        if (body < awake_count) {
+            swap(body, awake_count - 1);
+            body = --awake_count;
+        }
+
+        swap_and_pop(body);
+        sparse[static_cast<usize>(entt::to_entity(entity))] = invalid_body;
+    }
+
+    u32 BodyStore::wake(u32 body) {
+        if (body < awake_count) {
+            return body;
+        }
+
+        sleep_timers[body] = 0.0f;
+        islands[body] = invalid_island;
+        swap(body, awake_count);
+        return awake_count++;
+    }
+
+    u32 BodyStore::remove_from_awake(u32 body) {
+        if (body >= awake_count) {
+            return body;
+        }
+
+        swap(body, --awake_count);
+        return awake_count;
+    }
+
+    void BodyStore::swap(u32 body_A, u32 body_B) {
+        if (body_A == body_B) {
+            return;
+        }
+
+        std::swap(position_x[body_A], position_x[body_B]);
+        std::swap(position_y[body_A], position_y[body_B]);
+        std::swap(position_z[body_A], position_z[body_B]);
+        std::swap(previous_position_x[body_A], previous_position_x[body_B]);
+        std::swap(previous_position_y[body_A], previous_position_y[body_B]);
+        std::swap(previous_position_z[body_A], previous_position_z[body_B]);
+        std::swap(velocity_x[body_A], velocity_x[body_B]);
+        std::swap(velocity_y[body_A], velocity_y[body_B]);
+        std::swap(velocity_z[body_A], velocity_z[body_B]);
+        std::swap(inverse_mass[body_A], inverse_mass[body_B]);
+        std::swap(elasticity[body_A], elasticity[body_B]);
+        std::swap(radius[body_A], radius[body_B]);
+        std::swap(sleep_timers[body_A], sleep_timers[body_B]);
+        std::swap(islands[body_A], islands[body_B]);
+        std::swap(shapes[body_A], shapes[body_B]);
+        std::swap(broadphase_proxies[body_A], broadphase_proxies[body_B]);
+        std::swap(entities[body_A], entities[body_B]);
+
+        sparse[static_cast<usize>(entt::to_entity(entities[body_A]))] = body_A;
+        sparse[static_cast<usize>(entt::to_entity(entities[body_B]))] = body_B;
+    }
+
+    void BodyStore::clear() {
+        position_x.clear();
+        position_y.clear();
+        position_z.clear();
+        previous_position_x.clear();
+        previous_position_y.clear();
+        previous_position_z.clear();
+        velocity_x.clear();
+        velocity_y.clear();
+        velocity_z.clear();
+        inverse_mass.clear();
+        elasticity.clear();
+        radius.clear();
+        sleep_timers.clear();
+        islands.clear();
+        shapes.clear();
+        broadphase_proxies.clear();
+        entities.clear();
+        sparse.clear();
+        awake_count = 0;
+    }
+
+    void BodyStore::swap_and_pop(u32 body) {
+        u32 last = size() - 1;
+        if (body != last) {
+            position_x[body] = position_x[last];
+            position_y[body] = position_y[last];
+            position_z[body] = position_z[last];
+            previous_position_x[body] = previous_position_x[last];
+            previous_position_y[body] = previous_position_y[last];
+            previous_position_z[body] = previous_position_z[last];
+            velocity_x[body] = velocity_x[last];
+            velocity_y[body] = velocity_y[last];
+            velocity_z[body] = velocity_z[last];
+            inverse_mass[body] = inverse_mass[last];
+            elasticity[body] = elasticity[last];
+            radius[body] = radius[last];
+            sleep_timers[body] = sleep_timers[last];
+            islands[body] = islands[last];
+            shapes[body] = shapes[last];
+            broadphase_proxies[body] = broadphase_proxies[last];
+            entities[body] = entities[last];
+            sparse[static_cast<usize>(entt::to_entity(entities[body]))] = body;
+        }
+
+        position_x.pop_back();
+        position_y.pop_back();
+        position_z.pop_back();
+        previous_position_x.pop_back();
+        previous_position_y.pop_back();
+        previous_position_z.pop_back();
+        velocity_x.pop_back();
+        velocity_y.pop_back();
+        velocity_z.pop_back();
+        inverse_mass.pop_back();
+        elasticity.pop_back();
+        radius.pop_back();
+        sleep_timers.pop_back();
+        islands.pop_back();
+        shapes.pop_back();
+        broadphase_proxies.pop_back();
+        entities.pop_back();
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../core/types.h"
+#include "shapes.h"
+
+#include <entt/entity/entity.hpp>
+#include <entt/entity/fwd.hpp>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace Engine {
+    // Structure of arrays copy of every PhysicsComponent, the simulation runs on these arrays and
+    // PhysicsSystem mirrors the results back into the ECS once per update.
+    // Awake dynamic bodies are packed into [0, awake_count), sleeping and static bodies follow them,
+    // so the per step kernels only have to walk the front of the arrays.
+    class BodyStore {
+    public:
+        static constexpr u32 invalid_body = ~0u;
+        static constexpr u32 invalid_island = ~0u;
+
+        u32 add(entt::entity entity);
+        void remove(entt::entity entity);
+        void clear();
+
+        u32 get_index(entt::entity entity) const {
+            auto index = static_cast<usize>(entt::to_entity(entity));
+            return index < sparse.size() ? sparse[index] : invalid_body;
+        }
+
+        bool contains(entt::entity entity) const { return get_index(entity) != invalid_body; }
+        u32 size() const { return static_cast<u32>(entities.size()); }
+        u32 get_awake_count() const { return awake_count; }
+        bool is_awake(u32 body) const { return body < awake_count; }
+
+        // both move the body across the awake boundary and return its new index,
+        // indices of other bodies can change as well
+        u32 wake(u32 body);
+        u32 remove_from_awake(u32 body);
+
+        glm::vec3 get_position(u32 body) const { return {position_x[body], position_y[body], position_z[body]}; }
+        glm::vec3 get_previous_position(u32 body) const { return {previous_position_x[body], previous_position_y[body], previous_position_z[body]}; }
+        glm::vec3 get_velocity(u32 body) const { return {velocity_x[body], velocity_y[body], velocity_z[body]}; }
+
+        void set_position(u32 body, const glm::vec3 &position) {
+            position_x[body] = position.x;
+            position_y[body] = position.y;
+            position_z[body] = position.z;
+        }
+
+        // teleports the body, the next interpolated transform won't blend from the old position
+        void reset_position(u32 body, const glm::vec3 &position) {
+            set_position(body, position);
+            previous_position_x[body] = position.x;
+            previous_position_y[body] = position.y;
+            previous_position_z[body] = position.z;
+        }
+
+        // sleeping and static bodies don't move, their previous position is already current
+        void save_previous_positions() {
+            std::copy_n(position_x.begin(), awake_count, previous_position_x.begin());
+            std::copy_n(position_y.begin(), awake_count, previous_position_y.begin());
+            std::copy_n(position_z.begin(), awake_count, previous_position_z.begin());
+        }
+
+        void set_velocity(u32 body, const glm::vec3 &velocity) {
+            velocity_x[body] = velocity.x;
+            velocity_y[body] = velocity.y;
+            velocity_z[body] = velocity.z;
+        }
+
+        void apply_impulse_linear(u32 body, const glm::vec3 &impulse) {
+            if (0.0f == inverse_mass[body]) {
+                return;
+            }
+
+            set_velocity(body, get_velocity(body) + impulse * inverse_mass[body]);
+        }
+
+        std::vector<f32> position_x, position_y, position_z;
+        std::vector<f32> previous_position_x, previous_position_y, previous_position_z; // state before the last fixed step
+        std::vector<f32> velocity_x, velocity_y, velocity_z;
+        std::vector<f32> inverse_mass;
+        std::vector<f32> elasticity;
+        std::vector<f32> radius; // bounding sphere radius of the shape
+        std::vector<f32> sleep_timers; // how long the body has been below the sleep velocity
+        std::vector<u32> islands; // sleeping island of the body, invalid_island while awake
+
+        std::vector<const Shape *> shapes;
+        std::vector<i32> broadphase_proxies;
+        std::vector<entt::entity> entities;
+
+    private:
+        void swap(u32 body_A, u32 body_B);
+        void swap_and_pop(u32 body);
+
+        std::vector<u32> sparse;
+        u32 awake_count = 0;
+    };
+}
@@ -0,0 +1,472 @@
+#include "builtin_physics_backend.h"
+
+#include "intersect.h"
+#include "physics_kernels.h"
+#include "../core/job_system.h"
+
+#include <algorithm>
+
+namespace Engine {
+    namespace {
+        // By entity, so an entry survives bodies moving around in the store. The cached direction
+        // belongs to the lower entity minus the higher one.
+        u64 get_pair_key(entt::entity entity_A, entt::entity entity_B) {
+            return (static_cast<u64>(entt::to_integral(entity_A)) << 32) | static_cast<u64>(entt::to_integral(entity_B));
+        }
+    }
+
+    void BuiltinPhysicsBackend::add_body(entt::entity entity) {
+        bodies.add(entity);
+    }
+
+    void BuiltinPhysicsBackend::remove_body(entt::entity entity) {
+        u32 body = bodies.get_index(entity);
+        if (body == BodyStore::invalid_body) {
+            return;
+        }
+
+        if (bodies.broadphase_proxies[body] != DynamicAABBTree::null_node) {
+            broadphase.destroy_proxy(bodies.broadphase_proxies[body]);
+        }
+        bodies.remove(entity);
+    }
+
+    void BuiltinPhysicsBackend::sync_body(entt::entity entity, const TransformComponent &tn, const PhysicsComponent &ph, bool reload) {
+        u32 body = bodies.get_index(entity);
+        if (body == BodyStore::invalid_body) {
+            return;
+        }
+
+        bool changed = false;
+        if (bodies.shapes[body] != ph.shape.get()) {
+            bodies.shapes[body] = ph.shape.get();
+            bodies.radius[body] = ph.shape ? ph.shape->get_bounding_radius() : 0.0f;
+            changed = true;
+        }
+
+        if (reload) {
+            bodies.reset_position(body, tn.translation);
+            bodies.set_velocity(body, ph.linear_velocity);
+            bodies.inverse_mass[body] = ph.inverse_mass;
+            bodies.elasticity[body] = ph.elasticity;
+            changed = true;
+        }
+
+        if (!changed) {
+            return;
+        }
+
+        // an edited body wakes up together with everything resting on it
+        if (0.0f != bodies.inverse_mass[body]) {
+            if (bodies.islands[body] != BodyStore::invalid_island) {
+                wake_island(bodies.islands[body]);
+            }
+            body = bodies.wake(bodies.get_index(entity));
+            update_proxy(body);
+            return;
+        }
+
+        body = bodies.remove_from_awake(body);
+        bodies.islands[body] = BodyStore::invalid_island;
+
+        // A static body isn't part of any island, whatever slept on it has to be woken by its bounds,
+        // both where it was and where it is now. Waking moves bodies around, so the index is looked up
+        // again after each.
+        if (bodies.broadphase_proxies[body] != DynamicAABBTree::null_node) {
+            wake_islands_touching(broadphase.get_fat_aabb(bodies.broadphase_proxies[body]));
+            body = bodies.get_index(entity);
+        }
+
+        update_proxy(body);
+
+        if (bodies.broadphase_proxies[body] != DynamicAABBTree::null_node) {
+            wake_islands_touching(broadphase.get_fat_aabb(bodies.broadphase_proxies[body]));
+        }
+    }
+
+    void BuiltinPhysicsBackend::step(const f32 &delta_time, const glm::vec3 &gravity) {
+        bodies.save_previous_positions();
+
+        PhysicsKernels::apply_gravity(bodies.velocity_x.data(), bodies.velocity_y.data(), bodies.velocity_z.data(), bodies.inverse_mass.data(), bodies.get_awake_count(), gravity, delta_time);
+
+        update_broadphase(delta_time);
+        find_candidate_pairs();
+
+        // Awake bodies touching a sleeping island wake it up. The woken bodies can touch further
+        // islands, so pairs are gathered again until nothing else wakes up.
+        u32 first_woken = bodies.get_awake_count();
+        while (wake_touched_islands()) {
+            const u32 woken_count = bodies.get_awake_count() - first_woken;
+            PhysicsKernels::apply_gravity(bodies.velocity_x.data() + first_woken, bodies.velocity_y.data() + first_woken, bodies.velocity_z.data() + first_woken, bodies.inverse_mass.data() + first_woken, woken_count, gravity, delta_time);
+
+            first_woken = bodies.get_awake_count();
+            find_candidate_pairs();
+        }
+
+        narrowphase(delta_time);
+        solve_contacts();
+
+        PhysicsKernels::integrate_positions(bodies.position_x.data(), bodies.position_y.data(), bodies.position_z.data(), bodies.velocity_x.data(), bodies.velocity_y.data(), bodies.velocity_z.data(), bodies.get_awake_count(), delta_time);
+
+        update_sleeping(delta_time);
+    }
+
+    // Sleeping and static bodies are left out, their transforms stay untouched until they move again.
+    // A body that fell asleep since the last read_back is reported once more at the pose it sleeps
+    // at, the last awake report still had it moving.
+    void BuiltinPhysicsBackend::read_back(const BodyCallback &callback) {
+        for (u32 body = 0; body < bodies.get_awake_count(); body++) {
+            callback(bodies.entities[body], bodies.get_previous_position(body), bodies.get_position(body), bodies.get_velocity(body));
+        }
+
+        for (entt::entity entity : fallen_asleep) {
+            const u32 body = bodies.get_index(entity);
+            // removed since (maybe with the index handed out again), or woken up again and reported above
+            if (body == BodyStore::invalid_body || bodies.entities[body] != entity || bodies.islands[body] == BodyStore::invalid_island) {
+                continue;
+            }
+            callback(entity, bodies.get_previous_position(body), bodies.get_position(body), bodies.get_velocity(body));
+        }
+        fallen_asleep.clear();
+    }
+
+    void BuiltinPhysicsBackend::update_proxy(u32 body) {
+        const Shape* shape = bodies.shapes[body];
+        i32& proxy = bodies.broadphase_proxies[body];
+
+        if (!shape) {
+            if (proxy != DynamicAABBTree::null_node) {
+                broadphase.destroy_proxy(proxy);
+                proxy = DynamicAABBTree::null_node;
+            }
+            return;
+        }
+
+        AABB bounds = shape->get_bounds(bodies.get_position(body));
+        if (proxy == DynamicAABBTree::null_node) {
+            proxy = broadphase.create_proxy(bounds, bodies.entities[body]);
+        } else {
+            broadphase.move_proxy(proxy, bounds, glm::vec3{0.0f});
+        }
+    }
+
+    void BuiltinPhysicsBackend::update_broadphase(const f32 &delta_time) {
+        for (u32 body = 0; body < bodies.get_awake_count(); body++) {
+            const Shape* shape = bodies.shapes[body];
+            if (!shape) {
+                continue;
+            }
+
+            // the swept bounds, contacts anywhere along this step's path have to show up as pairs
+            const glm::vec3 position = bodies.get_position(body);
+            const glm::vec3 displacement = bodies.get_velocity(body) * delta_time;
+            AABB bounds = AABB::merge(shape->get_bounds(position), shape->get_bounds(position + displacement));
+            i32& proxy = bodies.broadphase_proxies[body];
+            if (proxy == DynamicAABBTree::null_node) {
+                proxy = broadphase.create_proxy(bounds, bodies.entities[body]);
+            } else {
+                broadphase.move_proxy(proxy, bounds, displacement);
+            }
+        }
+    }
+
+    void BuiltinPhysicsBackend::find_candidate_pairs() {
+        thread_pairs.resize(JobSystem::get_thread_count());
+        for (auto& buffer : thread_pairs) {
+            buffer.clear();
+        }
+
+        // only awake bodies search, static and sleeping ones only show up as the other half of a pair
+        JobSystem::parallel_for(bodies.get_awake_count(), broadphase_batch_size, [&](u32 begin, u32 end, u32 thread_index) {
+            auto& buffer = thread_pairs[thread_index];
+            for (u32 body_A = begin; body_A < end; body_A++) {
+                const i32 proxy_A = bodies.broadphase_proxies[body_A];
+                if (proxy_A == DynamicAABBTree::null_node) {
+                    continue;
+                }
+
+                broadphase.query(broadphase.get_fat_aabb(proxy_A), [&](i32 proxy_id) {
+                    if (proxy_id == proxy_A) {
+                        return true;
+                    }
+
+                    u32 body_B = bodies.get_index(broadphase.get_entity(proxy_id));
+
+                    // pairs of awake bodies are reported from both sides, keep only one of them
+                    if (bodies.is_awake(body_B) && body_B < body_A) {
+                        return true;
+                    }
+
+                    buffer.emplace_back(body_A, body_B);
+                    return true;
+                });
+            }
+        });
+
+        candidate_pairs.clear();
+        for (auto& buffer : thread_pairs) {
+            candidate_pairs.insert(candidate_pairs.end(), buffer.begin(), buffer.end());
+        }
+
+        // resolve in a stable order that does not depend on the shape of the tree or the thread count
+        std::sort(candidate_pairs.begin(), candidate_pairs.end());
+    }
+
+    void BuiltinPhysicsBackend::narrowphase(const f32 &delta_time) {
+        thread_contacts.resize(JobSystem::get_thread_count());
+        for (auto& buffer : thread_contacts) {
+            buffer.clear();
+        }
+
+        pair_directions.resize(candidate_pairs.size());
+
+        // the support cache is only read here, every pair writes its new direction to its own slot
+        JobSystem::parallel_for(static_cast<u32>(candidate_pairs.size()), narrowphase_batch_size, [&](u32 begin, u32 end, u32 thread_index) {
+            auto& buffer = thread_contacts[thread_index];
+            for (u32 i = begin; i < end; i++) {
+                const auto [body_A, body_B] = candidate_pairs[i];
+                const entt::entity entity_A = bodies.entities[body_A];
+                const entt::entity entity_B = bodies.entities[body_B];
+                const bool is_flipped = entity_B < entity_A;
+                const u64 key = is_flipped ? get_pair_key(entity_B, entity_A) : get_pair_key(entity_A, entity_B);
+
+                glm::vec3 search_direction{0.0f};
+                auto it = support_cache.find(key);
+                if (it != support_cache.end()) {
+                    search_direction = is_flipped ? -it->second : it->second;
+                }
+
+                Contact contact;
+                if (intersect(bodies, body_A, body_B, delta_time, contact, search_direction)) {
+                    buffer.push_back(contact);
+                }
+
+                pair_directions[i] = {key, is_flipped ? -search_direction : search_direction};
+            }
+        });
+
+        contacts.clear();
+        for (auto& buffer : thread_contacts) {
+            contacts.insert(contacts.end(), buffer.begin(), buffer.end());
+        }
+
+        // sphere pairs never touch the direction, pairs that stopped overlapping in the broadphase drop out
+        next_support_cache.clear();
+        for (const auto& [key, direction] : pair_directions) {
+            if (direction != glm::vec3{0.0f}) {
+                next_support_cache[key] = direction;
+            }
+        }
+        std::swap(support_cache, next_support_cache);
+
+        // resolve the earliest impacts first, ties fall back to the pair order so the result
+        // doesn't depend on which thread found the contact
+        std::sort(contacts.begin(), contacts.end(), [](const Contact& a, const Contact& b) {
+            if (a.time_of_impact != b.time_of_impact) {
+                return a.time_of_impact < b.time_of_impact;
+            }
+            return std::make_pair(a.body_A, a.body_B) < std::make_pair(b.body_A, b.body_B);
+        });
+    }
+
+    // Contacts are grouped into batches in which no dynamic body shows up twice, so a batch can be
+    // solved in parallel. A contact lands in the batch right after the last one that touched either
+    // of its bodies, every body therefore still sees its contacts in time of impact order and the
+    // result is identical to a serial solve no matter how many threads run it.
+    void BuiltinPhysicsBackend::solve_contacts() {
+        // every dynamic body in a contact is awake at this point
+        body_batches.assign(bodies.get_awake_count(), 0);
+        contact_batches.resize(contacts.size());
+        u32 batch_count = 0;
+
+        for (usize i = 0; i < contacts.size(); i++) {
+            const u32 body_A = contacts[i].body_A;
+            const u32 body_B = contacts[i].body_B;
+            const bool is_dynamic_A = 0.0f != bodies.inverse_mass[body_A];
+            const bool is_dynamic_B = 0.0f != bodies.inverse_mass[body_B];
+
+            // body_batches holds one past the last batch the body was used in
+            u32 batch = 0;
+            if (is_dynamic_A) {
+                batch = std::max(batch, body_batches[body_A]);
+            }
+            if (is_dynamic_B) {
+                batch = std::max(batch, body_batches[body_B]);
+            }
+
+            contact_batches[i] = batch;
+            if (is_dynamic_A) {
+                body_batches[body_A] = batch + 1;
+            }
+            if (is_dynamic_B) {
+                body_batches[body_B] = batch + 1;
+            }
+
+            batch_count = std::max(batch_count, batch + 1);
+        }
+
+        batch_offsets.assign(batch_count + 1, 0);
+        for (u32 batch : contact_batches) {
+            batch_offsets[batch + 1]++;
+        }
+        for (u32 batch = 0; batch < batch_count; batch++) {
+            batch_offsets[batch + 1] += batch_offsets[batch];
+        }
+
+        solve_order.resize(contacts.size());
+        std::vector<u32> cursor(batch_offsets.begin(), batch_offsets.end() - 1);
+        for (u32 i = 0; i < static_cast<u32>(contacts.size()); i++) {
+            solve_order[cursor[contact_batches[i]]++] = i;
+        }
+
+        for (u32 batch = 0; batch < batch_count; batch++) {
+            u32 first = batch_offsets[batch];
+            u32 count = batch_offsets[batch + 1] - first;
+
+            JobSystem::parallel_for(count, solver_batch_size, [&](u32 begin, u32 end, u32) {
+                for (u32 i = begin; i < end; i++) {
+                    resolve_contact(bodies, contacts[solve_order[first + i]]);
+                }
+            });
+        }
+    }
+
+    bool BuiltinPhysicsBackend::wake_touched_islands() {
+        islands_to_wake.clear();
+        for (const auto& [body_A, body_B] : candidate_pairs) {
+            if (!bodies.is_awake(body_B) && 0.0f != bodies.inverse_mass[body_B]) {
+                islands_to_wake.push_back(bodies.islands[body_B]);
+            }
+        }
+
+        if (islands_to_wake.empty()) {
+            return false;
+        }
+
+        std::sort(islands_to_wake.begin(), islands_to_wake.end());
+        islands_to_wake.erase(std::unique(islands_to_wake.begin(), islands_to_wake.end()), islands_to_wake.end());
+
+        for (u32 island : islands_to_wake) {
+            if (island != BodyStore::invalid_island) {
+                wake_island(island);
+            }
+        }
+
+        return true;
+    }
+
+    void BuiltinPhysicsBackend::wake_island(u32 island) {
+        for (entt::entity entity : sleeping_islands[island]) {
+            // bodies can be removed or edited while they sleep
+            u32 body = bodies.get_index(entity);
+            if (body == BodyStore::invalid_body || bodies.entities[body] != entity || bodies.islands[body] != island) {
+                continue;
+            }
+
+            bodies.wake(body);
+        }
+
+        sleeping_islands[island].clear();
+        free_islands.push_back(island);
+    }
+
+    void BuiltinPhysicsBackend::wake_islands_touching(const AABB &bounds) {
+        islands_to_wake.clear();
+        broadphase.query(bounds, [&](i32 proxy) {
+            const entt::entity entity = broadphase.get_entity(proxy);
+            const u32 body = bodies.get_index(entity);
+            if (body != BodyStore::invalid_body && bodies.entities[body] == entity && bodies.islands[body] != BodyStore::invalid_island) {
+                islands_to_wake.push_back(bodies.islands[body]);
+            }
+            return true;
+        });
+
+        std::sort(islands_to_wake.begin(), islands_to_wake.end());
+        islands_to_wake.erase(std::unique(islands_to_wake.begin(), islands_to_wake.end()), islands_to_wake.end());
+
+        for (u32 island : islands_to_wake) {
+            wake_island(island);
+        }
+    }
+
+    // Bodies connected through contacts form an island. An island is put to sleep once all of its
+    // bodies stayed below sleep_velocity_threshold for time_to_sleep, a body can't fall asleep while
+    // something it rests on keeps moving.
+    void BuiltinPhysicsBackend::update_sleeping(const f32 &delta_time) {
+        const u32 awake_count = bodies.get_awake_count();
+
+        const f32 threshold_squared = sleep_velocity_threshold * sleep_velocity_threshold;
+        for (u32 body = 0; body < awake_count; body++) {
+            const glm::vec3 velocity = bodies.get_velocity(body);
+            if (glm::dot(velocity, velocity) < threshold_squared) {
+                bodies.sleep_timers[body] += delta_time;
+            } else {
+                bodies.sleep_timers[body] = 0.0f;
+            }
+        }
+
+        island_parents.resize(awake_count);
+        for (u32 body = 0; body < awake_count; body++) {
+            island_parents[body] = body;
+        }
+
+        auto find_root = [&](u32 body) {
+            while (island_parents[body] != body) {
+                island_parents[body] = island_parents[island_parents[body]];
+                body = island_parents[body];
+            }
+            return body;
+        };
+
+        // static bodies don't join islands, otherwise everything on the ground would be one island
+        for (const Contact& contact : contacts) {
+            if (0.0f == bodies.inverse_mass[contact.body_A] || 0.0f == bodies.inverse_mass[contact.body_B]) {
+                continue;
+            }
+
+            u32 root_A = find_root(contact.body_A);
+            u32 root_B = find_root(contact.body_B);
+            if (root_A != root_B) {
+                island_parents[std::max(root_A, root_B)] = std::min(root_A, root_B);
+            }
+        }
+
+        island_sleep_timers.assign(awake_count, time_to_sleep);
+        for (u32 body = 0; body < awake_count; body++) {
+            u32 root = find_root(body);
+            island_sleep_timers[root] = std::min(island_sleep_timers[root], bodies.sleep_timers[body]);
+        }
+
+        bodies_to_sleep.clear();
+        island_ids.assign(awake_count, BodyStore::invalid_island);
+        for (u32 body = 0; body < awake_count; body++) {
+            u32 root = find_root(body);
+            if (island_sleep_timers[root] < time_to_sleep) {
+                continue;
+            }
+
+            if (island_ids[root] == BodyStore::invalid_island) {
+                if (free_islands.empty()) {
+                    island_ids[root] = static_cast<u32>(sleeping_islands.size());
+                    sleeping_islands.emplace_back();
+                } else {
+                    island_ids[root] = free_islands.back();
+                    free_islands.pop_back();
+                }
+            }
+
+            sleeping_islands[island_ids[root]].push_back(bodies.entities[body]);
+            bodies_to_sleep.emplace_back(bodies.entities[body], island_ids[root]);
+        }
+
+        // moving bodies out of the awake range reorders it, so this goes by entity
+        for (const auto& [entity, island] : bodies_to_sleep) {
+            u32 body = bodies.get_index(entity);
+            bodies.set_velocity(body, glm::vec3{0.0f});
+            bodies.reset_position(body, bodies.get_position(body));
+            body = bodies.remove_from_awake(body);
+            bodies.islands[body] = island;
+            fallen_asleep.push_back(entity);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "physics_backend.h"
+#include "dynamic_aabb_tree.h"
+#include "body_store.h"
+#include "contact.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+    // In-house solver, the bodies live in a BodyStore and every stage of the step runs on the JobSystem.
+    // Resting islands are put to sleep and cost nothing until an awake body touches them.
+    class BuiltinPhysicsBackend : public PhysicsBackend {
+    public:
+        static constexpr u32 broadphase_batch_size = 256;
+        static constexpr u32 narrowphase_batch_size = 128;
+        static constexpr u32 solver_batch_size = 64;
+
+        BuiltinPhysicsBackend() = default;
+
+        f32 sleep_velocity_threshold = 0.2f;
+        f32 time_to_sleep = 0.5f;
+
+        void add_body(entt::entity entity) override;
+        void remove_body(entt::entity entity) override;
+        void sync_body(entt::entity entity, const TransformComponent &tn, const PhysicsComponent &ph, bool reload) override;
+
+        void step(const f32 &delta_time, const glm::vec3 &gravity) override;
+        void read_back(const BodyCallback &callback) override;
+
+    private:
+        void update_proxy(u32 body);
+        void update_broadphase(const f32 &delta_time);
+        void find_candidate_pairs();
+        void narrowphase(const f32 &delta_time);
+        void solve_contacts();
+
+        bool wake_touched_islands();
+        void wake_island(u32 island);
+        void wake_islands_touching(const AABB &bounds);
+        void update_sleeping(const f32 &delta_time);
+
+        BodyStore bodies;
+        DynamicAABBTree broadphase;
+
+        std::vector<std::vector<std::pair<u32, u32>>> thread_pairs;
+        std::vector<std::pair<u32, u32>> candidate_pairs;
+
+        // last GJK search direction of every convex pair, see gjk.h
+        std::unordered_map<u64, glm::vec3> support_cache;
+        std::unordered_map<u64, glm::vec3> next_support_cache;
+        std::vector<std::pair<u64, glm::vec3>> pair_directions;
+
+        std::vector<std::vector<Contact>> thread_contacts;
+        std::vector<Contact> contacts;
+
+        std::vector<u32> body_batches;
+        std::vector<u32> contact_batches;
+        std::vector<u32> batch_offsets;
+        std::vector<u32> solve_order;
+
+        std::vector<std::vector<entt::entity>> sleeping_islands;
+        std::vector<u32> free_islands;
+        std::vector<u32> islands_to_wake;
+        std::vector<u32> island_parents;
+        std::vector<f32> island_sleep_timers;
+        std::vector<u32> island_ids;
+        std::vector<std::pair<entt::entity, u32>> bodies_to_sleep;
+        std::vector<entt::entity> fallen_asleep; // since the last read_back, which consumes it
+    };
+}
@@ -1,6 +1,6 @@
 #pragma once 
 
-#include "../data/entity.h"
+#include "body_store.h"
 
 namespace Engine {
     struct Contact {
@@ -13,42 +13,45 @@ namespace Engine {
         f32 separation_distance;	// positive when non-penetrating, negative when penetrating
         f32 time_of_impact;
 
-        Entity entity_A;
-        Entity entity_B;
+        u32 body_A;
+        u32 body_B;
     };
 
-    inline void resolve_contact(Contact& contact) {
-        /*auto& ph_A = contact.entity_A.get_component<PhysicsComponent>();
-        auto& ph_B = contact.entity_B.get_component<PhysicsComponent>();
+    // Positions in the body store are relative to the start of the step, the final integration moves
+    // every body by velocity * delta_time. The bodies are moved to the time of impact here and stored
+    // back rebased onto the new velocity, so the integration still ends up in the right place.
+    inline void resolve_contact(BodyStore& bodies, Contact& contact) {
+        const u32 body_A = contact.body_A;
+        const u32 body_B = contact.body_B;
+        const f32 inverse_mass_A = bodies.inverse_mass[body_A];
+        const f32 inverse_mass_B = bodies.inverse_mass[body_B];
+        const f32 time_of_impact = contact.time_of_impact;
 
-        ph_A.linear_velocity = { 0.0f, 0.0f, 0.0f };
-        ph_B.linear_velocity = { 0.0f, 0.0f, 0.0f };
+        glm::vec3 pos_A = bodies.get_position(body_A) + bodies.get_velocity(body_A) * time_of_impact;
+        glm::vec3 pos_B = bodies.get_position(body_B) + bodies.get_velocity(body_B) * time_of_impact;
 
-        f32 tA = ph_A.inverse_mass / ( ph_A.inverse_mass + ph_B.inverse_mass);
-        f32 tB = ph_B.inverse_mass / ( ph_A.inverse_mass + ph_B.inverse_mass);
-
-        glm::vec3 ds = contact.pos_world_space_B - contact.pos_world_space_A;
-        contact.entity_A.get_component<TransformComponent>().translation += ds * tA;
-        contact.entity_B.get_component<TransformComponent>().translation -= ds * tB;*/
-
-        auto& ph_A = contact.entity_A.get_component<PhysicsComponent>();
-        auto& ph_B = contact.entity_B.get_component<PhysicsComponent>();
-
-        f32 elasticity = ph_A.elasticity * ph_B.elasticity;
+        f32 elasticity = bodies.elasticity[body_A] * bodies.elasticity[body_B];
 
         glm::vec3 n = contact.normal;
-        glm::vec3 vab = ph_A.linear_velocity - ph_B.linear_velocity;
-        f32 impulse_J = -(1.0f + elasticity) * glm::dot(vab, n) / (ph_A.inverse_mass + ph_B.inverse_mass);
+        glm::vec3 vab = bodies.get_velocity(body_A) - bodies.get_velocity(body_B);
+        f32 impulse_J = -(1.0f + elasticity) * glm::dot(vab, n) / (inverse_mass_A + inverse_mass_B);
         glm::vec3 vec_impulse_J = n * impulse_J;
 
-        ph_A.apply_impulse_linear(vec_impulse_J * 1.0f);
-        ph_B.apply_impulse_linear(vec_impulse_J * -1.0f);
+        bodies.apply_impulse_linear(body_A, vec_impulse_J * 1.0f);
+        bodies.apply_impulse_linear(body_B, vec_impulse_J * -1.0f);
 
-        f32 tA = ph_A.inverse_mass / ( ph_A.inverse_mass + ph_B.inverse_mass);
-        f32 tB = ph_B.inverse_mass / ( ph_A.inverse_mass + ph_B.inverse_mass);
+        f32 tA = inverse_mass_A / (inverse_mass_A + inverse_mass_B);
+        f32 tB = inverse_mass_B / (inverse_mass_A + inverse_mass_B);
 
+        // static bodies are never written, contacts sharing one can be solved on different threads
         glm::vec3 ds = contact.pos_world_space_B - contact.pos_world_space_A;
-        contact.entity_A.get_component<TransformComponent>().translation += ds * tA;
-        contact.entity_B.get_component<TransformComponent>().translation -= ds * tB;
-    };
-}
\ No newline at end of file
+        if (0.0f != inverse_mass_A) {
+            pos_A += ds * tA;
+            bodies.set_position(body_A, pos_A - bodies.get_velocity(body_A) * time_of_impact);
+        }
+        if (0.0f != inverse_mass_B) {
+            pos_B -= ds * tB;
+            bodies.set_position(body_B, pos_B - bodies.get_velocity(body_B) * time_of_impact);
+        }
+    }
+}
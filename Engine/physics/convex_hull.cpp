@@ -0,0 +1,259 @@
+#include "convex_hull.h"
+
+#include "../graphics/model.h"
+#include "../math/aabb.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace Engine {
+    namespace {
+        struct Face {
+            u32 a, b, c;
+            glm::vec3 normal;
+            f32 distance;
+            std::vector<u32> outside; // points in front of this face that aren't assigned to another one
+            bool is_alive = true;
+        };
+
+        Face make_face(const std::vector<glm::vec3> &points, u32 a, u32 b, u32 c) {
+            Face face{a, b, c, {}, 0.0f, {}, true};
+            face.normal = glm::normalize(glm::cross(points[b] - points[a], points[c] - points[a]));
+            face.distance = glm::dot(face.normal, points[a]);
+            return face;
+        }
+
+        f32 signed_distance(const Face &face, const glm::vec3 &point) {
+            return glm::dot(face.normal, point) - face.distance;
+        }
+
+        u32 find_farthest_in_direction(const std::vector<glm::vec3> &points, const glm::vec3 &direction) {
+            u32 best = 0;
+            f32 best_distance = glm::dot(points[0], direction);
+            for (u32 i = 1; i < static_cast<u32>(points.size()); i++) {
+                f32 distance = glm::dot(points[i], direction);
+                if (distance > best_distance) {
+                    best_distance = distance;
+                    best = i;
+                }
+            }
+            return best;
+        }
+    }
+
+    ConvexHull build_convex_hull(const std::vector<glm::vec3> &points, const f32 &tolerance) {
+        if (points.size() < 4) {
+            throw std::runtime_error("convex hull needs at least 4 points");
+        }
+
+        AABB bounds;
+        for (const auto &point : points) {
+            bounds.expand_to_include(point);
+        }
+        const f32 epsilon = tolerance * glm::length(bounds.max - bounds.min);
+
+        // the starting tetrahedron is spanned by points far apart from each other
+        u32 i0 = find_farthest_in_direction(points, glm::vec3{1.0f, 0.0f, 0.0f});
+
+        u32 i1 = i0;
+        f32 best_distance = 0.0f;
+        for (u32 i = 0; i < static_cast<u32>(points.size()); i++) {
+            glm::vec3 d = points[i] - points[i0];
+            if (glm::dot(d, d) > best_distance) {
+                best_distance = glm::dot(d, d);
+                i1 = i;
+            }
+        }
+
+        u32 i2 = i0;
+        best_distance = 0.0f;
+        const glm::vec3 line = glm::normalize(points[i1] - points[i0]);
+        for (u32 i = 0; i < static_cast<u32>(points.size()); i++) {
+            glm::vec3 d = points[i] - points[i0];
+            glm::vec3 perpendicular = d - line * glm::dot(d, line);
+            if (glm::dot(perpendicular, perpendicular) > best_distance) {
+                best_distance = glm::dot(perpendicular, perpendicular);
+                i2 = i;
+            }
+        }
+
+        u32 i3 = i0;
+        best_distance = 0.0f;
+        const glm::vec3 plane_normal = glm::cross(points[i1] - points[i0], points[i2] - points[i0]);
+        if (glm::dot(plane_normal, plane_normal) > 0.0f) {
+            const glm::vec3 normal = glm::normalize(plane_normal);
+            for (u32 i = 0; i < static_cast<u32>(points.size()); i++) {
+                f32 distance = std::abs(glm::dot(points[i] - points[i0], normal));
+                if (distance > best_distance) {
+                    best_distance = distance;
+                    i3 = i;
+                }
+            }
+        }
+
+        if (best_distance <= epsilon) {
+            throw std::runtime_error("convex hull points don't span a volume");
+        }
+
+        std::vector<Face> faces;
+
+        // directed edge -> face on its left, the face across an edge sits at the reversed edge
+        std::unordered_map<u64, usize> edge_faces;
+        auto get_edge_key = [](u32 a, u32 b) { return (static_cast<u64>(a) << 32) | static_cast<u64>(b); };
+        auto add_face = [&](u32 a, u32 b, u32 c) {
+            const usize index = faces.size();
+            faces.push_back(make_face(points, a, b, c));
+            edge_faces[get_edge_key(a, b)] = index;
+            edge_faces[get_edge_key(b, c)] = index;
+            edge_faces[get_edge_key(c, a)] = index;
+        };
+
+        const u32 tetrahedron[4][4] = {{i0, i1, i2, i3}, {i0, i3, i1, i2}, {i1, i3, i2, i0}, {i2, i3, i0, i1}};
+        for (const auto &t : tetrahedron) {
+            // the fourth vertex has to end up behind the face
+            if (signed_distance(make_face(points, t[0], t[1], t[2]), points[t[3]]) > 0.0f) {
+                add_face(t[0], t[2], t[1]);
+            } else {
+                add_face(t[0], t[1], t[2]);
+            }
+        }
+
+        for (u32 i = 0; i < static_cast<u32>(points.size()); i++) {
+            if (i == i0 || i == i1 || i == i2 || i == i3) {
+                continue;
+            }
+
+            for (auto &face : faces) {
+                if (signed_distance(face, points[i]) > epsilon) {
+                    face.outside.push_back(i);
+                    break;
+                }
+            }
+        }
+
+        std::vector<usize> visible;
+        std::vector<usize> stack;
+        std::vector<u32> visit_stamps;
+        std::vector<std::pair<u32, u32>> horizon;
+        std::vector<u32> orphans;
+        u32 stamp = 0;
+
+        // new faces go to the back, so a single pass handles them as well
+        for (usize f = 0; f < faces.size(); f++) {
+            if (!faces[f].is_alive || faces[f].outside.empty()) {
+                continue;
+            }
+
+            u32 eye = faces[f].outside[0];
+            f32 eye_distance = signed_distance(faces[f], points[eye]);
+            for (u32 i : faces[f].outside) {
+                f32 distance = signed_distance(faces[f], points[i]);
+                if (distance > eye_distance) {
+                    eye_distance = distance;
+                    eye = i;
+                }
+            }
+
+            // Flood the faces the eye can see from the one it belongs to. Going by adjacency keeps the
+            // visible region connected even where rounding left the hull slightly concave, and the
+            // edges to faces that can't see the eye form a single horizon loop.
+            stamp++;
+            visit_stamps.resize(faces.size(), 0);
+            visible.clear();
+            horizon.clear();
+            stack.assign(1, f);
+            visit_stamps[f] = stamp;
+            while (!stack.empty()) {
+                const usize g = stack.back();
+                stack.pop_back();
+                visible.push_back(g);
+
+                const Face &face = faces[g];
+                for (const auto &[a, b] : {std::make_pair(face.a, face.b), std::make_pair(face.b, face.c), std::make_pair(face.c, face.a)}) {
+                    const usize neighbour = edge_faces.at(get_edge_key(b, a));
+                    if (visit_stamps[neighbour] == stamp) {
+                        continue;
+                    }
+
+                    if (signed_distance(faces[neighbour], points[eye]) > 0.0f) {
+                        visit_stamps[neighbour] = stamp;
+                        stack.push_back(neighbour);
+                    } else {
+                        horizon.emplace_back(a, b);
+                    }
+                }
+            }
+
+            orphans.clear();
+            for (usize g : visible) {
+                Face &face = faces[g];
+                for (u32 i : face.outside) {
+                    if (i != eye) {
+                        orphans.push_back(i);
+                    }
+                }
+                face.outside.clear();
+                face.outside.shrink_to_fit();
+                face.is_alive = false;
+
+                edge_faces.erase(get_edge_key(face.a, face.b));
+                edge_faces.erase(get_edge_key(face.b, face.c));
+                edge_faces.erase(get_edge_key(face.c, face.a));
+            }
+
+            // the horizon edges keep the winding of the faces they came from
+            const usize first_new_face = faces.size();
+            for (const auto &[a, b] : horizon) {
+                add_face(a, b, eye);
+            }
+
+            for (u32 i : orphans) {
+                for (usize g = first_new_face; g < faces.size(); g++) {
+                    if (signed_distance(faces[g], points[i]) > epsilon) {
+                        faces[g].outside.push_back(i);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // the hull points keep the order they had in the input, building a hull from a hull gives
+        // back the same points in the same order
+        std::vector<u32> remap(points.size(), ~0u);
+        for (const auto &face : faces) {
+            if (face.is_alive) {
+                remap[face.a] = remap[face.b] = remap[face.c] = 0;
+            }
+        }
+
+        ConvexHull hull;
+        for (u32 i = 0; i < static_cast<u32>(points.size()); i++) {
+            if (remap[i] != ~0u) {
+                remap[i] = static_cast<u32>(hull.points.size());
+                hull.points.push_back(points[i]);
+            }
+        }
+
+        for (const auto &face : faces) {
+            if (face.is_alive) {
+                hull.indices.push_back(remap[face.a]);
+                hull.indices.push_back(remap[face.b]);
+                hull.indices.push_back(remap[face.c]);
+            }
+        }
+
+        return hull;
+    }
+
+    ConvexHull build_convex_hull(const Model &model, const f32 &tolerance) {
+        std::vector<glm::vec3> points;
+        points.reserve(model.get_vertex_count());
+        for (u32 i = 0; i < model.get_vertex_count(); i++) {
+            points.push_back(model.get_vertices()[i].position);
+        }
+
+        return build_convex_hull(points, tolerance);
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../core/types.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace Engine {
+    class Model;
+
+    struct ConvexHull {
+        std::vector<glm::vec3> points;
+        std::vector<u32> indices; // triangles, counter clockwise seen from outside
+    };
+
+    // Quickhull. Points closer to the hull than tolerance times the size of the point cloud count as
+    // inside, which keeps nearly flat faces of scanned or subdivided meshes from adding vertices.
+    // Throws when the points don't span a volume.
+    ConvexHull build_convex_hull(const std::vector<glm::vec3> &points, const f32 &tolerance = 0.0001f);
+
+    // hull around the vertices of every primitive, in model space
+    ConvexHull build_convex_hull(const Model &model, const f32 &tolerance = 0.0001f);
+}
@@ -0,0 +1,316 @@
+#include "dynamic_aabb_tree.h"
+
+#include <algorithm>
+
+namespace Engine {
+    i32 DynamicAABBTree::create_proxy(const AABB &aabb, entt::entity entity) {
+        i32 proxy_id = allocate_node();
+
+        Node &node = node_at(proxy_id);
+        node.aabb = aabb;
+        node.aabb.expand(aabb_margin);
+        node.entity = entity;
+        node.height = 0;
+
+        insert_leaf(proxy_id);
+        proxy_count++;
+
+        return proxy_id;
+    }
+
+    void DynamicAABBTree::destroy_proxy(i32 proxy_id) {
+        assert(node_at(proxy_id).is_leaf());
+
+        remove_leaf(proxy_id);
+        free_node(proxy_id);
+        proxy_count--;
+    }
+
+    bool DynamicAABBTree::move_proxy(i32 proxy_id, const AABB &aabb, const glm::vec3 &displacement) {
+        assert(node_at(proxy_id).is_leaf());
+
+        AABB fat_aabb = aabb;
+        fat_aabb.expand(aabb_margin);
+
+        // extend the fat box in the direction of travel so the next few frames stay inside it
+        glm::vec3 d = displacement_multiplier * displacement;
+        for (glm::length_t i = 0; i < 3; i++) {
+            if (d[i] < 0.0f) {
+                fat_aabb.min[i] += d[i];
+            } else {
+                fat_aabb.max[i] += d[i];
+            }
+        }
+
+        const AABB &tree_aabb = node_at(proxy_id).aabb;
+        if (tree_aabb.contains(aabb)) {
+            // the body slowed down, keep the box unless it got way too big
+            AABB huge_aabb = fat_aabb;
+            huge_aabb.expand(4.0f * aabb_margin);
+            if (huge_aabb.contains(tree_aabb)) {
+                return false;
+            }
+        }
+
+        remove_leaf(proxy_id);
+        node_at(proxy_id).aabb = fat_aabb;
+        insert_leaf(proxy_id);
+
+        return true;
+    }
+
+    void DynamicAABBTree::clear() {
+        nodes.clear();
+        root = null_node;
+        free_list = null_node;
+        proxy_count = 0;
+    }
+
+    i32 DynamicAABBTree::allocate_node() {
+        if (free_list == null_node) {
+            nodes.emplace_back();
+            return static_cast<i32>(nodes.size() - 1);
+        }
+
+        i32 node_id = free_list;
+        Node &node = node_at(node_id);
+        free_list = node.parent;
+        node = Node{};
+        return node_id;
+    }
+
+    void DynamicAABBTree::free_node(i32 node_id) {
+        Node &node = node_at(node_id);
+        node = Node{};
+        node.parent = free_list;
+        free_list = node_id;
+    }
+
+    void DynamicAABBTree::insert_leaf(i32 leaf) {
+        if (root == null_node) {
+            root = leaf;
+            node_at(root).parent = null_node;
+            return;
+        }
+
+        // find the best sibling using the surface area heuristic
+        const AABB leaf_aabb = node_at(leaf).aabb;
+        i32 index = root;
+        while (!node_at(index).is_leaf()) {
+            const Node &node = node_at(index);
+            i32 child_1 = node.child_1;
+            i32 child_2 = node.child_2;
+
+            f32 area = node.aabb.surface_area();
+            f32 combined_area = AABB::merge(node.aabb, leaf_aabb).surface_area();
+
+            // cost of creating a new parent for this node and the new leaf
+            f32 cost = 2.0f * combined_area;
+
+            // minimum cost of pushing the leaf further down the tree
+            f32 inheritance_cost = 2.0f * (combined_area - area);
+
+            auto descend_cost = [&](i32 child) {
+                const Node &child_node = node_at(child);
+                f32 merged_area = AABB::merge(leaf_aabb, child_node.aabb).surface_area();
+                if (child_node.is_leaf()) {
+                    return merged_area + inheritance_cost;
+                }
+                return (merged_area - child_node.aabb.surface_area()) + inheritance_cost;
+            };
+
+            f32 cost_1 = descend_cost(child_1);
+            f32 cost_2 = descend_cost(child_2);
+
+            if (cost < cost_1 && cost < cost_2) {
+                break;
+            }
+
+            index = cost_1 < cost_2 ? child_1 : child_2;
+        }
+
+        i32 sibling = index;
+
+        // allocate_node can grow the vector, so no references are held across it
+        i32 old_parent = node_at(sibling).parent;
+        i32 new_parent = allocate_node();
+        node_at(new_parent).parent = old_parent;
+        node_at(new_parent).aabb = AABB::merge(leaf_aabb, node_at(sibling).aabb);
+        node_at(new_parent).height = node_at(sibling).height + 1;
+        node_at(new_parent).child_1 = sibling;
+        node_at(new_parent).child_2 = leaf;
+        node_at(sibling).parent = new_parent;
+        node_at(leaf).parent = new_parent;
+
+        if (old_parent != null_node) {
+            if (node_at(old_parent).child_1 == sibling) {
+                node_at(old_parent).child_1 = new_parent;
+            } else {
+                node_at(old_parent).child_2 = new_parent;
+            }
+        } else {
+            root = new_parent;
+        }
+
+        // refit and rebalance the ancestors
+        index = node_at(leaf).parent;
+        while (index != null_node) {
+            index = balance(index);
+
+            Node &node = node_at(index);
+            const Node &child_1 = node_at(node.child_1);
+            const Node &child_2 = node_at(node.child_2);
+
+            node.height = 1 + std::max(child_1.height, child_2.height);
+            node.aabb = AABB::merge(child_1.aabb, child_2.aabb);
+
+            index = node.parent;
+        }
+    }
+
+    void DynamicAABBTree::remove_leaf(i32 leaf) {
+        if (leaf == root) {
+            root = null_node;
+            return;
+        }
+
+        i32 parent = node_at(leaf).parent;
+        i32 grand_parent = node_at(parent).parent;
+        i32 sibling = node_at(parent).child_1 == leaf ? node_at(parent).child_2 : node_at(parent).child_1;
+
+        if (grand_parent == null_node) {
+            root = sibling;
+            node_at(sibling).parent = null_node;
+            free_node(parent);
+            return;
+        }
+
+        // destroy the parent and connect the sibling to the grand parent
+        if (node_at(grand_parent).child_1 == parent) {
+            node_at(grand_parent).child_1 = sibling;
+        } else {
+            node_at(grand_parent).child_2 = sibling;
+        }
+        node_at(sibling).parent = grand_parent;
+        free_node(parent);
+
+        i32 index = grand_parent;
+        while (index != null_node) {
+            index = balance(index);
+
+            Node &node = node_at(index);
+            const Node &child_1 = node_at(node.child_1);
+            const Node &child_2 = node_at(node.child_2);
+
+            node.aabb = AABB::merge(child_1.aabb, child_2.aabb);
+            node.height = 1 + std::max(child_1.height, child_2.height);
+
+            index = node.parent;
+        }
+    }
+
+    // Performs a left or right rotation if node A is imbalanced, returns the new root of the subtree.
+    i32 DynamicAABBTree::balance(i32 i_A) {
+        Node &A = node_at(i_A);
+        if (A.is_leaf() || A.height < 2) {
+            return i_A;
+        }
+
+        i32 i_B = A.child_1;
+        i32 i_C = A.child_2;
+        Node &B = node_at(i_B);
+        Node &C = node_at(i_C);
+
+        i32 balance_factor = C.height - B.height;
+
+        // rotate C up
+        if (balance_factor > 1) {
+            i32 i_F = C.child_1;
+            i32 i_G = C.child_2;
+            Node &F = node_at(i_F);
+            Node &G = node_at(i_G);
+
+            C.child_1 = i_A;
+            C.parent = A.parent;
+            A.parent = i_C;
+
+            if (C.parent != null_node) {
+                if (node_at(C.parent).child_1 == i_A) {
+                    node_at(C.parent).child_1 = i_C;
+                } else {
+                    node_at(C.parent).child_2 = i_C;
+                }
+            } else {
+                root = i_C;
+            }
+
+            if (F.height > G.height) {
+                C.child_2 = i_F;
+                A.child_2 = i_G;
+                G.parent = i_A;
+                A.aabb = AABB::merge(B.aabb, G.aabb);
+                C.aabb = AABB::merge(A.aabb, F.aabb);
+
+                A.height = 1 + std::max(B.height, G.height);
+                C.height = 1 + std::max(A.height, F.height);
+            } else {
+                C.child_2 = i_G;
+                A.child_2 = i_F;
+                F.parent = i_A;
+                A.aabb = AABB::merge(B.aabb, F.aabb);
+                C.aabb = AABB::merge(A.aabb, G.aabb);
+
+                A.height = 1 + std::max(B.height, F.height);
+                C.height = 1 + std::max(A.height, G.height);
+            }
+
+            return i_C;
+        }
+
+        // rotate B up
+        if (balance_factor < -1) {
+            i32 i_D = B.child_1;
+            i32 i_E = B.child_2;
+            Node &D = node_at(i_D);
+            Node &E = node_at(i_E);
+
+            B.child_1 = i_A;
+            B.parent = A.parent;
+            A.parent = i_B;
+
+            if (B.parent != null_node) {
+                if (node_at(B.parent).child_1 == i_A) {
+                    node_at(B.parent).child_1 = i_B;
+                } else {
+                    node_at(B.parent).child_2 = i_B;
+                }
+            } else {
+                root = i_B;
+            }
+
+            if (D.height > E.height) {
+                B.child_2 = i_D;
+                A.child_1 = i_E;
+                E.parent = i_A;
+                A.aabb = AABB::merge(C.aabb, E.aabb);
+                B.aabb = AABB::merge(A.aabb, D.aabb);
+
+                A.height = 1 + std::max(C.height, E.height);
+                B.height = 1 + std::max(A.height, D.height);
+            } else {
+                B.child_2 = i_E;
+                A.child_1 = i_D;
+                D.parent = i_A;
+                A.aabb = AABB::merge(C.aabb, D.aabb);
+                B.aabb = AABB::merge(A.aabb, E.aabb);
+
+                A.height = 1 + std::max(C.height, D.height);
+                B.height = 1 + std::max(A.height, E.height);
+            }
+
+            return i_B;
+        }
+
+        return i_A;
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "../math/aabb.h"
+#include "../core/types.h"
+
+#include <entt/entity/entity.hpp>
+#include <entt/entity/fwd.hpp>
+
+#include <cassert>
+#include <vector>
+
+namespace Engine {
+    // Bounding volume hierarchy over fattened AABBs, leaves are only reinserted once
+    // the tight bounds leave the fat ones, so slow moving bodies almost never touch the tree.
+    class DynamicAABBTree {
+    public:
+        static constexpr i32 null_node = -1;
+        static constexpr f32 aabb_margin = 0.1f;
+        static constexpr f32 displacement_multiplier = 2.0f;
+
+        DynamicAABBTree() = default;
+
+        i32 create_proxy(const AABB &aabb, entt::entity entity);
+        void destroy_proxy(i32 proxy_id);
+
+        // returns true when the proxy had to be reinserted
+        bool move_proxy(i32 proxy_id, const AABB &aabb, const glm::vec3 &displacement);
+
+        entt::entity get_entity(i32 proxy_id) const { return nodes[static_cast<usize>(proxy_id)].entity; }
+        const AABB &get_fat_aabb(i32 proxy_id) const { return nodes[static_cast<usize>(proxy_id)].aabb; }
+
+        i32 get_height() const { return root == null_node ? 0 : nodes[static_cast<usize>(root)].height; }
+        i32 get_proxy_count() const { return proxy_count; }
+
+        void clear();
+
+        // callback(i32 proxy_id) -> bool, returning false stops the query
+        template<typename Callback>
+        void query(const AABB &aabb, Callback &&callback) const {
+            if (root == null_node) {
+                return;
+            }
+
+            i32 stack[max_stack_size];
+            i32 stack_size = 0;
+            stack[stack_size++] = root;
+
+            while (stack_size > 0) {
+                const i32 node_id = stack[--stack_size];
+                const Node &node = nodes[static_cast<usize>(node_id)];
+
+                if (!node.aabb.overlaps(aabb)) {
+                    continue;
+                }
+
+                if (node.is_leaf()) {
+                    if (!callback(node_id)) {
+                        return;
+                    }
+                } else {
+                    assert(stack_size + 2 <= max_stack_size && "DynamicAABBTree is too deep");
+                    stack[stack_size++] = node.child_1;
+                    stack[stack_size++] = node.child_2;
+                }
+            }
+        }
+
+        // callback(i32 proxy_id, f32 max_distance) -> f32, the returned distance clips the rest of the ray
+        // so only closer proxies are visited afterwards, returning 0 stops the query.
+        // A non zero radius grows every box by it, which turns the ray into a sphere cast.
+        template<typename Callback>
+        void raycast(const glm::vec3 &origin, const glm::vec3 &direction, f32 max_distance, Callback &&callback, f32 radius = 0.0f) const {
+            if (root == null_node) {
+                return;
+            }
+
+            const glm::vec3 inverse_direction = 1.0f / direction;
+
+            i32 stack[max_stack_size];
+            i32 stack_size = 0;
+            stack[stack_size++] = root;
+
+            while (stack_size > 0) {
+                const i32 node_id = stack[--stack_size];
+                const Node &node = nodes[static_cast<usize>(node_id)];
+
+                AABB aabb = node.aabb;
+                aabb.expand(radius);
+
+                f32 t_entry;
+                if (!aabb.ray_intersects(origin, inverse_direction, max_distance, t_entry)) {
+                    continue;
+                }
+
+                if (node.is_leaf()) {
+                    max_distance = callback(node_id, max_distance);
+                    if (max_distance <= 0.0f) {
+                        return;
+                    }
+                } else {
+                    assert(stack_size + 2 <= max_stack_size && "DynamicAABBTree is too deep");
+                    stack[stack_size++] = node.child_1;
+                    stack[stack_size++] = node.child_2;
+                }
+            }
+        }
+
+    private:
+        static constexpr i32 max_stack_size = 256;
+
+        struct Node {
+            AABB aabb;
+            entt::entity entity{entt::null};
+            i32 parent = null_node; // next free node while the node sits in the free list
+            i32 child_1 = null_node;
+            i32 child_2 = null_node;
+            i32 height = -1; // -1 marks a free node
+
+            bool is_leaf() const { return child_1 == null_node; }
+        };
+
+        i32 allocate_node();
+        void free_node(i32 node_id);
+
+        void insert_leaf(i32 leaf);
+        void remove_leaf(i32 leaf);
+        i32 balance(i32 node_id);
+
+        Node &node_at(i32 node_id) { return nodes[static_cast<usize>(node_id)]; }
+
+        std::vector<Node> nodes;
+        i32 root = null_node;
+        i32 free_list = null_node;
+        i32 proxy_count = 0;
+    };
+}
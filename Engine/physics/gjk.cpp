@@ -0,0 +1,621 @@
+#include "gjk.h"
+
+#include "shapes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace Engine::GJK {
+    namespace {
+        constexpr u32 max_gjk_iterations = 32;
+        constexpr u32 max_epa_iterations = 64;
+
+        struct Point {
+            glm::vec3 xyz{0.0f}; // pt_A - pt_B, a point of the Minkowski difference
+            glm::vec3 pt_A{0.0f};
+            glm::vec3 pt_B{0.0f};
+        };
+
+        struct Triangle {
+            u32 a, b, c;
+        };
+
+        struct Edge {
+            u32 a, b;
+
+            bool operator==(const Edge &other) const {
+                return (a == other.a && b == other.b) || (a == other.b && b == other.a);
+            }
+        };
+
+        struct Shapes {
+            const Shape &shape_A;
+            const glm::vec3 &pos_A;
+            const Shape &shape_B;
+            const glm::vec3 &pos_B;
+        };
+
+        Point support(const Shapes &shapes, glm::vec3 direction, const f32 &bias) {
+            direction = glm::normalize(direction);
+
+            Point point;
+            point.pt_A = shapes.shape_A.support(direction, shapes.pos_A, bias);
+            point.pt_B = shapes.shape_B.support(-direction, shapes.pos_B, bias);
+            point.xyz = point.pt_A - point.pt_B;
+            return point;
+        }
+
+        glm::vec3 initial_direction(const glm::vec3 &search_direction) {
+            if (glm::dot(search_direction, search_direction) > 1e-12f) {
+                return search_direction;
+            }
+            return glm::vec3{1.0f, 1.0f, 1.0f};
+        }
+
+        bool compare_signs(f32 a, f32 b) {
+            return (a > 0.0f && b > 0.0f) || (a < 0.0f && b < 0.0f);
+        }
+
+        f32 length_squared(const glm::vec3 &v) {
+            return glm::dot(v, v);
+        }
+
+        // The signed volume functions return the barycentric coordinates of the point of the simplex
+        // closest to the origin. Each projects onto the axis or plane where the simplex is largest,
+        // which keeps them stable for thin simplices.
+        glm::vec2 signed_volume_1d(const glm::vec3 &s1, const glm::vec3 &s2) {
+            const glm::vec3 ab = s2 - s1;
+            const glm::vec3 ap = -s1;
+            const glm::vec3 p0 = s1 + ab * glm::dot(ab, ap) / length_squared(ab);
+
+            i32 index = 0;
+            f32 mu_max = 0.0f;
+            for (i32 i = 0; i < 3; i++) {
+                f32 mu = s2[i] - s1[i];
+                if (mu * mu > mu_max * mu_max) {
+                    mu_max = mu;
+                    index = i;
+                }
+            }
+
+            const f32 a = s1[index];
+            const f32 b = s2[index];
+            const f32 p = p0[index];
+
+            const f32 c1 = p - a;
+            const f32 c2 = b - p;
+
+            // the projection lies inside the segment
+            if ((p > a && p < b) || (p > b && p < a)) {
+                return glm::vec2{c2 / mu_max, c1 / mu_max};
+            }
+
+            // outside on the side of a
+            if ((a <= b && p <= a) || (a >= b && p >= a)) {
+                return glm::vec2{1.0f, 0.0f};
+            }
+
+            return glm::vec2{0.0f, 1.0f};
+        }
+
+        glm::vec3 signed_volume_2d(const glm::vec3 &s1, const glm::vec3 &s2, const glm::vec3 &s3) {
+            const glm::vec3 normal = glm::cross(s2 - s1, s3 - s1);
+            const glm::vec3 p0 = normal * glm::dot(s1, normal) / length_squared(normal);
+
+            i32 index = 0;
+            f32 area_max = 0.0f;
+            for (i32 i = 0; i < 3; i++) {
+                i32 j = (i + 1) % 3;
+                i32 k = (i + 2) % 3;
+
+                glm::vec2 a = glm::vec2{s1[j], s1[k]};
+                glm::vec2 b = glm::vec2{s2[j], s2[k]};
+                glm::vec2 c = glm::vec2{s3[j], s3[k]};
+                glm::vec2 ab = b - a;
+                glm::vec2 ac = c - a;
+
+                f32 area = ab.x * ac.y - ab.y * ac.x;
+                if (area * area > area_max * area_max) {
+                    index = i;
+                    area_max = area;
+                }
+            }
+
+            const i32 x = (index + 1) % 3;
+            const i32 y = (index + 2) % 3;
+            const glm::vec2 s[3] = {glm::vec2{s1[x], s1[y]}, glm::vec2{s2[x], s2[y]}, glm::vec2{s3[x], s3[y]}};
+            const glm::vec2 p = glm::vec2{p0[x], p0[y]};
+
+            glm::vec3 areas;
+            for (i32 i = 0; i < 3; i++) {
+                i32 j = (i + 1) % 3;
+                i32 k = (i + 2) % 3;
+
+                glm::vec2 ab = s[j] - p;
+                glm::vec2 ac = s[k] - p;
+                areas[i] = ab.x * ac.y - ab.y * ac.x;
+            }
+
+            // the projected origin lies inside the triangle
+            if (compare_signs(area_max, areas[0]) && compare_signs(area_max, areas[1]) && compare_signs(area_max, areas[2])) {
+                return areas / area_max;
+            }
+
+            // otherwise it's closest to one of the edges it isn't strictly inside of, a zero area
+            // (the origin on the line through an edge) has to count too or no edge is tried at all
+            const glm::vec3 edge_points[3] = {s1, s2, s3};
+            glm::vec3 lambdas = glm::vec3{1.0f, 0.0f, 0.0f};
+            f32 distance = 1e10f;
+            for (i32 i = 0; i < 3; i++) {
+                i32 k = (i + 1) % 3;
+                i32 l = (i + 2) % 3;
+
+                if (!compare_signs(area_max, areas[i])) {
+                    glm::vec2 lambda_edge = signed_volume_1d(edge_points[k], edge_points[l]);
+                    glm::vec3 point = edge_points[k] * lambda_edge[0] + edge_points[l] * lambda_edge[1];
+                    if (length_squared(point) < distance) {
+                        distance = length_squared(point);
+                        lambdas = glm::vec3{0.0f};
+                        lambdas[k] = lambda_edge[0];
+                        lambdas[l] = lambda_edge[1];
+                    }
+                }
+            }
+
+            return lambdas;
+        }
+
+        f32 triple_product(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c) {
+            return glm::dot(a, glm::cross(b, c));
+        }
+
+        glm::vec4 signed_volume_3d(const glm::vec3 &s1, const glm::vec3 &s2, const glm::vec3 &s3, const glm::vec3 &s4) {
+            // cofactors of the row of ones in | s1 s2 s3 s4 ; 1 1 1 1 |
+            const glm::vec4 c4 = {
+                -triple_product(s2, s3, s4),
+                triple_product(s1, s3, s4),
+                -triple_product(s1, s2, s4),
+                triple_product(s1, s2, s3),
+            };
+
+            const f32 det_m = c4[0] + c4[1] + c4[2] + c4[3];
+
+            // the origin lies inside the tetrahedron
+            if (compare_signs(det_m, c4[0]) && compare_signs(det_m, c4[1]) && compare_signs(det_m, c4[2]) && compare_signs(det_m, c4[3])) {
+                return c4 * (1.0f / det_m);
+            }
+
+            // otherwise it's closest to one of the faces
+            const glm::vec3 face_points[4] = {s1, s2, s3, s4};
+            glm::vec4 lambdas = glm::vec4{1.0f, 0.0f, 0.0f, 0.0f};
+            f32 distance = 1e10f;
+            for (i32 i = 0; i < 4; i++) {
+                i32 j = (i + 1) % 4;
+                i32 k = (i + 2) % 4;
+
+                glm::vec3 lambda_face = signed_volume_2d(face_points[i], face_points[j], face_points[k]);
+                glm::vec3 point = face_points[i] * lambda_face[0] + face_points[j] * lambda_face[1] + face_points[k] * lambda_face[2];
+                if (length_squared(point) < distance) {
+                    distance = length_squared(point);
+                    lambdas = glm::vec4{0.0f};
+                    lambdas[i] = lambda_face[0];
+                    lambdas[j] = lambda_face[1];
+                    lambdas[k] = lambda_face[2];
+                }
+            }
+
+            return lambdas;
+        }
+
+        // Finds the point of the simplex closest to the origin, new_direction points from it to the
+        // origin. Returns true when the simplex contains the origin.
+        bool simplex_signed_volumes(const Point *points, u32 count, glm::vec3 &new_direction, glm::vec4 &lambdas) {
+            constexpr f32 epsilon = 0.0001f * 0.0001f;
+            lambdas = glm::vec4{0.0f};
+
+            glm::vec3 v{0.0f};
+            switch (count) {
+                case 2: {
+                    glm::vec2 l = signed_volume_1d(points[0].xyz, points[1].xyz);
+                    v = points[0].xyz * l[0] + points[1].xyz * l[1];
+                    lambdas = glm::vec4{l[0], l[1], 0.0f, 0.0f};
+                    break;
+                }
+                case 3: {
+                    glm::vec3 l = signed_volume_2d(points[0].xyz, points[1].xyz, points[2].xyz);
+                    v = points[0].xyz * l[0] + points[1].xyz * l[1] + points[2].xyz * l[2];
+                    lambdas = glm::vec4{l[0], l[1], l[2], 0.0f};
+                    break;
+                }
+                case 4: {
+                    lambdas = signed_volume_3d(points[0].xyz, points[1].xyz, points[2].xyz, points[3].xyz);
+                    v = points[0].xyz * lambdas[0] + points[1].xyz * lambdas[1] + points[2].xyz * lambdas[2] + points[3].xyz * lambdas[3];
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            new_direction = -v;
+            return length_squared(v) < epsilon;
+        }
+
+        bool has_point(const Point *points, u32 count, const Point &point) {
+            constexpr f32 precision = 1e-6f;
+            for (u32 i = 0; i < count; i++) {
+                if (length_squared(points[i].xyz - point.xyz) < precision * precision) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // drops the points that don't take part in the closest point and moves the rest to the front
+        u32 keep_supporting_points(Point *points, glm::vec4 &lambdas) {
+            Point kept_points[4];
+            glm::vec4 kept_lambdas{0.0f};
+            u32 count = 0;
+            for (i32 i = 0; i < 4; i++) {
+                if (0.0f != lambdas[i]) {
+                    kept_points[count] = points[i];
+                    kept_lambdas[static_cast<i32>(count)] = lambdas[i];
+                    count++;
+                }
+            }
+
+            for (u32 i = 0; i < 4; i++) {
+                points[i] = kept_points[i];
+            }
+            lambdas = kept_lambdas;
+            return count;
+        }
+
+        glm::vec3 triangle_normal(const Triangle &triangle, const std::vector<Point> &points) {
+            const glm::vec3 &a = points[triangle.a].xyz;
+            const glm::vec3 &b = points[triangle.b].xyz;
+            const glm::vec3 &c = points[triangle.c].xyz;
+            return glm::normalize(glm::cross(b - a, c - a));
+        }
+
+        f32 signed_distance_to_triangle(const Triangle &triangle, const glm::vec3 &point, const std::vector<Point> &points) {
+            return glm::dot(triangle_normal(triangle, points), point - points[triangle.a].xyz);
+        }
+
+        usize closest_triangle(const std::vector<Triangle> &triangles, const std::vector<Point> &points) {
+            f32 min_distance = 1e10f;
+            usize index = 0;
+            for (usize i = 0; i < triangles.size(); i++) {
+                f32 distance = signed_distance_to_triangle(triangles[i], glm::vec3{0.0f}, points);
+                if (distance * distance < min_distance) {
+                    min_distance = distance * distance;
+                    index = i;
+                }
+            }
+            return index;
+        }
+
+        bool polytope_has_point(const glm::vec3 &w, const std::vector<Triangle> &triangles, const std::vector<Point> &points) {
+            constexpr f32 epsilon = 0.001f * 0.001f;
+            for (const auto &triangle : triangles) {
+                if (length_squared(w - points[triangle.a].xyz) < epsilon || length_squared(w - points[triangle.b].xyz) < epsilon || length_squared(w - points[triangle.c].xyz) < epsilon) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Starting polytope for EPA, it has to enclose the origin. That's the tetrahedron GJK ended with,
+        // unless the shapes barely touch along large flat faces and it came out flat. Then a double
+        // pyramid is built over the face the origin projects into, its tips found with the bias.
+        void build_polytope(const Shapes &shapes, const f32 &bias, Point *simplex, std::vector<Point> &points, std::vector<Triangle> &triangles) {
+            f32 size = 0.0f;
+            for (u32 i = 1; i < 4; i++) {
+                size = std::max(size, glm::length(simplex[i].xyz - simplex[0].xyz));
+            }
+
+            const u32 faces[4][4] = {{0, 1, 2, 3}, {1, 2, 3, 0}, {2, 3, 0, 1}, {3, 0, 1, 2}};
+            u32 base = 0;
+            f32 base_area = -1.0f;
+            for (u32 i = 0; i < 4; i++) {
+                f32 area = glm::length(glm::cross(simplex[faces[i][1]].xyz - simplex[faces[i][0]].xyz, simplex[faces[i][2]].xyz - simplex[faces[i][0]].xyz));
+                if (area > base_area) {
+                    base_area = area;
+                    base = i;
+                }
+            }
+
+            const glm::vec3 &a = simplex[faces[base][0]].xyz;
+            const glm::vec3 normal = glm::normalize(glm::cross(simplex[faces[base][1]].xyz - a, simplex[faces[base][2]].xyz - a));
+            const f32 height = std::abs(glm::dot(simplex[faces[base][3]].xyz - a, normal));
+
+            if (height > bias + size * 1e-5f) {
+                // grow the tetrahedron by the bias, it then still encloses the origin when the shapes
+                // only just touch
+                glm::vec3 center = (simplex[0].xyz + simplex[1].xyz + simplex[2].xyz + simplex[3].xyz) * 0.25f;
+                for (u32 i = 0; i < 4; i++) {
+                    glm::vec3 direction = simplex[i].xyz - center;
+                    if (length_squared(direction) > 0.0f) {
+                        direction = glm::normalize(direction);
+                    }
+                    simplex[i].pt_A += direction * bias;
+                    simplex[i].pt_B -= direction * bias;
+                    simplex[i].xyz = simplex[i].pt_A - simplex[i].pt_B;
+                    points.push_back(simplex[i]);
+                }
+
+                for (u32 i = 0; i < 4; i++) {
+                    Triangle triangle{i, (i + 1) % 4, (i + 2) % 4};
+
+                    // the unused point has to be behind the triangle
+                    u32 unused = (i + 3) % 4;
+                    if (signed_distance_to_triangle(triangle, points[unused].xyz, points) > 0.0f) {
+                        std::swap(triangle.a, triangle.b);
+                    }
+                    triangles.push_back(triangle);
+                }
+                return;
+            }
+
+            // the face of the flat tetrahedron the origin lies over
+            for (u32 i = 0; i < 4; i++) {
+                glm::vec3 lambdas = signed_volume_2d(simplex[faces[i][0]].xyz, simplex[faces[i][1]].xyz, simplex[faces[i][2]].xyz);
+                if (lambdas.x > 0.0f && lambdas.y > 0.0f && lambdas.z > 0.0f) {
+                    base = i;
+                    break;
+                }
+            }
+
+            for (u32 i = 0; i < 3; i++) {
+                points.push_back(simplex[faces[base][i]]);
+            }
+            points.push_back(support(shapes, normal, bias));
+            points.push_back(support(shapes, -normal, bias));
+
+            const Triangle pyramid[6] = {{0, 1, 3}, {1, 2, 3}, {2, 0, 3}, {1, 0, 4}, {2, 1, 4}, {0, 2, 4}};
+            const glm::vec3 center = (points[0].xyz + points[1].xyz + points[2].xyz + points[3].xyz + points[4].xyz) * 0.2f;
+            for (Triangle triangle : pyramid) {
+                if (signed_distance_to_triangle(triangle, center, points) > 0.0f) {
+                    std::swap(triangle.a, triangle.b);
+                }
+                triangles.push_back(triangle);
+            }
+        }
+
+        // Expands the polytope along the Minkowski difference until the face closest to the origin
+        // can't be pushed out any further, that face gives the penetration depth and points.
+        void epa_expand(const Shapes &shapes, const f32 &bias, std::vector<Point> &points, std::vector<Triangle> &triangles, glm::vec3 &pt_on_A, glm::vec3 &pt_on_B) {
+            std::vector<Edge> dangling_edges;
+
+            glm::vec3 center{0.0f};
+            for (const auto &point : points) {
+                center += point.xyz;
+            }
+            center /= static_cast<f32>(points.size());
+
+            for (u32 iteration = 0; iteration < max_epa_iterations; iteration++) {
+                const usize index = closest_triangle(triangles, points);
+                const glm::vec3 normal = triangle_normal(triangles[index], points);
+                const Point new_point = support(shapes, normal, bias);
+
+                // nothing left to expand into
+                if (polytope_has_point(new_point.xyz, triangles, points)) {
+                    break;
+                }
+                if (signed_distance_to_triangle(triangles[index], new_point.xyz, points) <= 0.0f) {
+                    break;
+                }
+
+                const u32 new_index = static_cast<u32>(points.size());
+                points.push_back(new_point);
+
+                // remove the triangles facing the new point
+                auto removed = std::remove_if(triangles.begin(), triangles.end(), [&](const Triangle &triangle) {
+                    return signed_distance_to_triangle(triangle, new_point.xyz, points) > 0.0f;
+                });
+                if (removed == triangles.end()) {
+                    break;
+                }
+                triangles.erase(removed, triangles.end());
+
+                // edges used by a single remaining triangle border the hole
+                dangling_edges.clear();
+                for (usize i = 0; i < triangles.size(); i++) {
+                    const Triangle &triangle = triangles[i];
+                    const Edge edges[3] = {{triangle.a, triangle.b}, {triangle.b, triangle.c}, {triangle.c, triangle.a}};
+                    u32 counts[3] = {0, 0, 0};
+
+                    for (usize j = 0; j < triangles.size(); j++) {
+                        if (j == i) {
+                            continue;
+                        }
+
+                        const Triangle &other = triangles[j];
+                        const Edge other_edges[3] = {{other.a, other.b}, {other.b, other.c}, {other.c, other.a}};
+                        for (u32 k = 0; k < 3; k++) {
+                            if (edges[k] == other_edges[0] || edges[k] == other_edges[1] || edges[k] == other_edges[2]) {
+                                counts[k]++;
+                            }
+                        }
+                    }
+
+                    for (u32 k = 0; k < 3; k++) {
+                        if (0 == counts[k]) {
+                            dangling_edges.push_back(edges[k]);
+                        }
+                    }
+                }
+
+                if (dangling_edges.empty()) {
+                    break;
+                }
+
+                for (const auto &edge : dangling_edges) {
+                    Triangle triangle{new_index, edge.b, edge.a};
+
+                    // facing away from the center
+                    if (signed_distance_to_triangle(triangle, center, points) > 0.0f) {
+                        std::swap(triangle.b, triangle.c);
+                    }
+                    triangles.push_back(triangle);
+                }
+            }
+
+            // Closest point of the closest triangle to the origin. Large flat faces, like a small box
+            // resting on a wide floor, leave the polytope slightly concave, so this goes by the actual
+            // distance to each triangle and never extrapolates past its edges.
+            const Triangle *closest = &triangles[0];
+            glm::vec3 lambdas{1.0f, 0.0f, 0.0f};
+            f32 min_distance = 1e10f;
+            for (const auto &triangle : triangles) {
+                const glm::vec3 &a = points[triangle.a].xyz;
+                const glm::vec3 &b = points[triangle.b].xyz;
+                const glm::vec3 &c = points[triangle.c].xyz;
+
+                glm::vec3 triangle_lambdas = signed_volume_2d(a, b, c);
+                f32 distance = length_squared(a * triangle_lambdas[0] + b * triangle_lambdas[1] + c * triangle_lambdas[2]);
+                if (distance < min_distance) {
+                    min_distance = distance;
+                    lambdas = triangle_lambdas;
+                    closest = &triangle;
+                }
+            }
+
+            const Triangle &triangle = *closest;
+
+            pt_on_A = points[triangle.a].pt_A * lambdas[0] + points[triangle.b].pt_A * lambdas[1] + points[triangle.c].pt_A * lambdas[2];
+            pt_on_B = points[triangle.a].pt_B * lambdas[0] + points[triangle.b].pt_B * lambdas[1] + points[triangle.c].pt_B * lambdas[2];
+        }
+
+        glm::vec3 any_orthogonal(const glm::vec3 &v) {
+            const glm::vec3 axis = std::abs(v.x) < 0.57f ? glm::vec3{1.0f, 0.0f, 0.0f} : glm::vec3{0.0f, 1.0f, 0.0f};
+            return glm::cross(v, axis);
+        }
+    }
+
+    bool intersect(const Shape &shape_A, const glm::vec3 &pos_A, const Shape &shape_B, const glm::vec3 &pos_B, const f32 &bias, glm::vec3 &pt_on_A, glm::vec3 &pt_on_B, glm::vec3 &search_direction) {
+        const Shapes shapes{shape_A, pos_A, shape_B, pos_B};
+        const glm::vec3 start_direction = initial_direction(search_direction);
+
+        Point simplex[4];
+        u32 count = 1;
+        simplex[0] = support(shapes, start_direction, 0.0f);
+
+        f32 closest_distance = 1e10f;
+        bool contains_origin = false;
+        glm::vec3 new_direction = -simplex[0].xyz;
+        for (u32 iteration = 0; iteration < max_gjk_iterations && !contains_origin; iteration++) {
+            if (length_squared(new_direction) < 1e-12f) {
+                // the support point is the origin itself, the shapes are touching
+                contains_origin = true;
+                break;
+            }
+
+            const Point new_point = support(shapes, new_direction, 0.0f);
+
+            // can't expand any further
+            if (has_point(simplex, count, new_point)) {
+                break;
+            }
+
+            simplex[count++] = new_point;
+
+            // the new point didn't get past the origin, so the origin is outside of the difference
+            if (glm::dot(new_direction, new_point.xyz) < 0.0f) {
+                break;
+            }
+
+            glm::vec4 lambdas;
+            contains_origin = simplex_signed_volumes(simplex, count, new_direction, lambdas);
+            if (contains_origin) {
+                break;
+            }
+
+            // no progress towards the origin
+            f32 distance = length_squared(new_direction);
+            if (distance >= closest_distance) {
+                break;
+            }
+            closest_distance = distance;
+
+            count = keep_supporting_points(simplex, lambdas);
+            contains_origin = 4 == count;
+        }
+
+        search_direction = new_direction;
+        if (!contains_origin) {
+            return false;
+        }
+
+        // EPA needs a full tetrahedron
+        if (1 == count) {
+            glm::vec3 direction = length_squared(simplex[0].xyz) > 1e-12f ? -simplex[0].xyz : -start_direction;
+            simplex[count++] = support(shapes, direction, 0.0f);
+        }
+        if (2 == count) {
+            simplex[count++] = support(shapes, any_orthogonal(simplex[1].xyz - simplex[0].xyz), 0.0f);
+        }
+        if (3 == count) {
+            glm::vec3 ab = simplex[1].xyz - simplex[0].xyz;
+            glm::vec3 ac = simplex[2].xyz - simplex[0].xyz;
+            glm::vec3 normal = glm::cross(ab, ac);
+            simplex[count++] = support(shapes, length_squared(normal) > 1e-12f ? normal : any_orthogonal(ab), 0.0f);
+        }
+
+        std::vector<Point> points;
+        std::vector<Triangle> triangles;
+        build_polytope(shapes, bias, simplex, points, triangles);
+        epa_expand(shapes, bias, points, triangles, pt_on_A, pt_on_B);
+        return true;
+    }
+
+    void closest_points(const Shape &shape_A, const glm::vec3 &pos_A, const Shape &shape_B, const glm::vec3 &pos_B, glm::vec3 &pt_on_A, glm::vec3 &pt_on_B, glm::vec3 &search_direction) {
+        const Shapes shapes{shape_A, pos_A, shape_B, pos_B};
+
+        Point simplex[4];
+        u32 count = 1;
+        simplex[0] = support(shapes, initial_direction(search_direction), 0.0f);
+
+        f32 closest_distance = 1e10f;
+        glm::vec4 lambdas = glm::vec4{1.0f, 0.0f, 0.0f, 0.0f};
+        glm::vec3 new_direction = -simplex[0].xyz;
+        for (u32 iteration = 0; iteration < max_gjk_iterations && count < 4; iteration++) {
+            if (length_squared(new_direction) < 1e-12f) {
+                break;
+            }
+
+            const Point new_point = support(shapes, new_direction, 0.0f);
+            if (has_point(simplex, count, new_point)) {
+                break;
+            }
+
+            simplex[count++] = new_point;
+
+            glm::vec3 direction;
+            glm::vec4 new_lambdas;
+            simplex_signed_volumes(simplex, count, direction, new_lambdas);
+
+            // no progress towards the origin, keep the previous simplex
+            f32 distance = length_squared(direction);
+            if (distance >= closest_distance) {
+                count--;
+                break;
+            }
+            closest_distance = distance;
+
+            new_direction = direction;
+            lambdas = new_lambdas;
+            count = keep_supporting_points(simplex, lambdas);
+        }
+
+        search_direction = new_direction;
+
+        pt_on_A = glm::vec3{0.0f};
+        pt_on_B = glm::vec3{0.0f};
+        for (u32 i = 0; i < count; i++) {
+            pt_on_A += simplex[i].pt_A * lambdas[static_cast<i32>(i)];
+            pt_on_B += simplex[i].pt_B * lambdas[static_cast<i32>(i)];
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../core/types.h"
+
+#include <glm/glm.hpp>
+
+// GJK and EPA on the Minkowski difference of two convex shapes, the shapes only have to provide
+// Shape::support(). Bodies don't rotate, so a shape is placed by its position alone.
+//
+// search_direction warm starts GJK and returns the direction it ended up with. Callers keep it per
+// pair between steps, for resting or slowly moving pairs GJK then starts next to the answer and
+// usually finishes after one or two support calls. A zero vector starts from scratch.
+namespace Engine {
+    class Shape;
+}
+
+namespace Engine::GJK {
+    // True when the shapes, grown by bias, overlap. EPA then fills in the deepest points of each shape
+    // inside the other one, still including the bias.
+    bool intersect(const Shape &shape_A, const glm::vec3 &pos_A, const Shape &shape_B, const glm::vec3 &pos_B, const f32 &bias, glm::vec3 &pt_on_A, glm::vec3 &pt_on_B, glm::vec3 &search_direction);
+
+    // closest points of two separated shapes
+    void closest_points(const Shape &shape_A, const glm::vec3 &pos_A, const Shape &shape_B, const glm::vec3 &pos_B, glm::vec3 &pt_on_A, glm::vec3 &pt_on_B, glm::vec3 &search_direction);
+}
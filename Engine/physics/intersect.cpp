@@ -1,34 +1,178 @@
 #include "intersect.h"
+#include "gjk.h"
 #include <glm/ext/quaternion_geometric.hpp>
 
 namespace Engine {
-    bool intersect(Entity& entity_A, Entity& entity_B, Contact& contact) {
-        contact.entity_A = entity_A;
-        contact.entity_B = entity_B;
+    bool ray_sphere(const glm::vec3& ray_start, const glm::vec3& ray_direction, const glm::vec3& sphere_center, const f32& sphere_radius, f32& t1, f32& t2) {
+        const glm::vec3 m = sphere_center - ray_start;
+        const f32 a = glm::dot(ray_direction, ray_direction);
+        const f32 b = glm::dot(m, ray_direction);
+        const f32 c = glm::dot(m, m) - sphere_radius * sphere_radius;
 
-        auto& ph_A = entity_A.get_component<PhysicsComponent>();
-        auto& ph_B = entity_B.get_component<PhysicsComponent>();
+        const f32 delta = b * b - a * c;
+        if (delta < 0.0f) {
+            return false;
+        }
 
-        if (ph_A.shape->get_type() == Shape::SPHERE && ph_B.shape->get_type() == Shape::SPHERE) {
-            glm::vec3 ab = entity_A.get_component<TransformComponent>().translation - entity_B.get_component<TransformComponent>().translation;
+        const f32 inverse_a = 1.0f / a;
+        const f32 delta_root = glm::sqrt(delta);
+        t1 = inverse_a * (b - delta_root);
+        t2 = inverse_a * (b + delta_root);
 
-            contact.normal = glm::normalize(ab);
+        return true;
+    }
 
-            Sphere* sphere_A = reinterpret_cast<Sphere*>(ph_A.shape.get());
-            Sphere* sphere_B = reinterpret_cast<Sphere*>(ph_B.shape.get());
+    // Runs the motion of A relative to B as a ray against a sphere with the summed radius, this way
+    // small fast spheres can't step over each other between two frames.
+    static bool sphere_sphere_dynamic(const BodyStore& bodies, u32 body_A, u32 body_B, const f32& delta_time, Contact& contact) {
+        const glm::vec3 pos_A = bodies.get_position(body_A);
+        const glm::vec3 pos_B = bodies.get_position(body_B);
+        const glm::vec3 velocity_A = bodies.get_velocity(body_A);
+        const glm::vec3 velocity_B = bodies.get_velocity(body_B);
+        const f32 radius_A = bodies.radius[body_A];
+        const f32 radius_B = bodies.radius[body_B];
+        const f32 radius_ab = radius_A + radius_B;
 
-            contact.pos_world_space_A = entity_A.get_component<TransformComponent>().translation + contact.normal * sphere_A->radius;
-            contact.pos_world_space_B = entity_B.get_component<TransformComponent>().translation - contact.normal * sphere_B->radius;
+        const glm::vec3 ray_direction = (velocity_A - velocity_B) * delta_time;
 
-            f32 radius_ab = sphere_A->radius + sphere_B->radius;
-            f32 length_squared = glm::length(ab) * glm::length(ab);
-            if (length_squared <= (radius_ab * radius_ab)) {
-                return true;
+        f32 t1 = 0.0f;
+        f32 t2 = 0.0f;
+        if (glm::dot(ray_direction, ray_direction) < 0.001f * 0.001f) {
+            // barely moving relative to each other, a static overlap test is enough
+            glm::vec3 ab = pos_B - pos_A;
+            f32 radius = radius_ab + 0.001f;
+            if (glm::dot(ab, ab) > radius * radius) {
+                return false;
             }
+        } else if (!ray_sphere(pos_A, ray_direction, pos_B, radius_ab, t1, t2)) {
+            return false;
+        }
 
+        // ray parameters to seconds
+        t1 *= delta_time;
+        t2 *= delta_time;
+
+        // the bodies are moving apart
+        if (t2 < 0.0f) {
+            return false;
+        }
+
+        const f32 time_of_impact = t1 < 0.0f ? 0.0f : t1;
+        if (time_of_impact > delta_time) {
             return false;
         }
 
-        return false;
+        const glm::vec3 impact_pos_A = pos_A + velocity_A * time_of_impact;
+        const glm::vec3 impact_pos_B = pos_B + velocity_B * time_of_impact;
+        const glm::vec3 ab = impact_pos_B - impact_pos_A;
+
+        contact.normal = glm::normalize(ab);
+        contact.pos_world_space_A = impact_pos_A + contact.normal * radius_A;
+        contact.pos_world_space_B = impact_pos_B - contact.normal * radius_B;
+        contact.separation_distance = glm::length(ab) - radius_ab;
+        contact.time_of_impact = time_of_impact;
+
+        return true;
+    }
+
+    // Overlap at the given positions, contact points and separation come from EPA.
+    static bool convex_convex_static(const Shape& shape_A, const glm::vec3& pos_A, const Shape& shape_B, const glm::vec3& pos_B, Contact& contact, glm::vec3& search_direction) {
+        const f32 bias = 0.001f;
+
+        glm::vec3 pt_on_A;
+        glm::vec3 pt_on_B;
+        if (!GJK::intersect(shape_A, pos_A, shape_B, pos_B, bias, pt_on_A, pt_on_B, search_direction)) {
+            return false;
+        }
+
+        // the deepest points lie inside the other shape, so A to B runs from pt_on_B to pt_on_A
+        glm::vec3 normal = pt_on_A - pt_on_B;
+        if (glm::dot(normal, normal) > 1e-12f) {
+            normal = glm::normalize(normal);
+        } else {
+            normal = glm::normalize(pos_B - pos_A);
+        }
+
+        // both shapes were grown by the bias
+        pt_on_A -= normal * bias;
+        pt_on_B += normal * bias;
+
+        contact.normal = normal;
+        contact.pos_world_space_A = pt_on_A;
+        contact.pos_world_space_B = pt_on_B;
+        contact.separation_distance = -glm::length(pt_on_A - pt_on_B);
+
+        return true;
+    }
+
+    // Conservative advancement, both bodies are moved forward by the time it takes to close the
+    // current gap at their closing speed. That never overshoots, so thin boxes can't tunnel either.
+    // Closer than linear_slop counts as touching. Grazing hits close in slower with every iteration,
+    // running out of them while still closing reports the contact where the bodies got to.
+    static bool convex_convex_dynamic(const BodyStore& bodies, u32 body_A, u32 body_B, const f32& delta_time, Contact& contact, glm::vec3& search_direction) {
+        const u32 max_iterations = 20;
+        const f32 linear_slop = 0.005f;
+
+        const Shape& shape_A = *bodies.shapes[body_A];
+        const Shape& shape_B = *bodies.shapes[body_B];
+        glm::vec3 pos_A = bodies.get_position(body_A);
+        glm::vec3 pos_B = bodies.get_position(body_B);
+        const glm::vec3 velocity_A = bodies.get_velocity(body_A);
+        const glm::vec3 velocity_B = bodies.get_velocity(body_B);
+
+        f32 time_of_impact = 0.0f;
+        for (u32 iteration = 0;; iteration++) {
+            if (convex_convex_static(shape_A, pos_A, shape_B, pos_B, contact, search_direction)) {
+                contact.time_of_impact = time_of_impact;
+                return true;
+            }
+
+            glm::vec3 pt_on_A;
+            glm::vec3 pt_on_B;
+            GJK::closest_points(shape_A, pos_A, shape_B, pos_B, pt_on_A, pt_on_B, search_direction);
+
+            const glm::vec3 gap = pt_on_B - pt_on_A;
+            const f32 separation = glm::length(gap);
+            const glm::vec3 normal = separation > 1e-6f ? gap / separation : glm::normalize(pos_B - pos_A);
+
+            // a separating direction they don't close along, they never meet
+            const f32 closing_speed = glm::dot(velocity_A - velocity_B, normal);
+            if (closing_speed <= 0.0f && separation > linear_slop) {
+                return false;
+            }
+
+            if (separation <= linear_slop || iteration == max_iterations) {
+                contact.normal = normal;
+                contact.pos_world_space_A = pt_on_A;
+                contact.pos_world_space_B = pt_on_B;
+                contact.separation_distance = separation;
+                contact.time_of_impact = time_of_impact;
+                return true;
+            }
+
+            const f32 time_to_go = separation / closing_speed;
+            if (time_of_impact + time_to_go > delta_time) {
+                return false;
+            }
+
+            time_of_impact += time_to_go;
+            pos_A += velocity_A * time_to_go;
+            pos_B += velocity_B * time_to_go;
+        }
+    }
+
+    bool intersect(const BodyStore& bodies, u32 body_A, u32 body_B, const f32& delta_time, Contact& contact, glm::vec3& search_direction) {
+        contact.body_A = body_A;
+        contact.body_B = body_B;
+        contact.time_of_impact = 0.0f;
+
+        const Shape* shape_A = bodies.shapes[body_A];
+        const Shape* shape_B = bodies.shapes[body_B];
+
+        if (shape_A->get_type() == Shape::SPHERE && shape_B->get_type() == Shape::SPHERE) {
+            return sphere_sphere_dynamic(bodies, body_A, body_B, delta_time, contact);
+        }
+
+        return convex_convex_dynamic(bodies, body_A, body_B, delta_time, contact, search_direction);
     }
-}
\ No newline at end of file
+}
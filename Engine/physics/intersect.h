@@ -1,9 +1,15 @@
 #pragma once
 
-#include "../data/entity.h"
+#include "body_store.h"
 
 #include "contact.h"
 
 namespace Engine {
-    bool intersect(Entity& entity_A, Entity& entity_B, Contact& contact);
-}
\ No newline at end of file
+    // Sweeps both bodies over delta_time, on a hit the contact is filled in at the time of impact.
+    // Bodies that already overlap report a time of impact of zero. Pairs that aren't two spheres go
+    // through GJK/EPA, search_direction is its warm start for the pair (see gjk.h).
+    bool intersect(const BodyStore& bodies, u32 body_A, u32 body_B, const f32& delta_time, Contact& contact, glm::vec3& search_direction);
+
+    // Entry and exit parameters of the ray start + t * direction against the sphere, t1 <= t2.
+    bool ray_sphere(const glm::vec3& ray_start, const glm::vec3& ray_direction, const glm::vec3& sphere_center, const f32& sphere_radius, f32& t1, f32& t2);
+}
@@ -0,0 +1,362 @@
+#ifdef STELLAR_ENABLE_JOLT
+
+// Jolt.h has to come before any other Jolt header
+#include <Jolt/Jolt.h>
+
+#include <Jolt/RegisterTypes.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Core/TempAllocator.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Physics/PhysicsSettings.h>
+#include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Body/BodyLock.h>
+
+#include "jolt_physics_backend.h"
+
+#include "../core/job_system.h"
+
+#include <entt/entity/entity.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Engine {
+    namespace {
+        namespace ObjectLayers {
+            static constexpr JPH::ObjectLayer NON_MOVING = 0;
+            static constexpr JPH::ObjectLayer MOVING = 1;
+            static constexpr JPH::ObjectLayer COUNT = 2;
+        }
+
+        namespace BroadPhaseLayers {
+            static constexpr JPH::BroadPhaseLayer NON_MOVING{0};
+            static constexpr JPH::BroadPhaseLayer MOVING{1};
+            static constexpr JPH::uint COUNT = 2;
+        }
+
+        // static bodies get their own tree which is only rebuilt when they change
+        class BroadPhaseLayerInterface final : public JPH::BroadPhaseLayerInterface {
+        public:
+            JPH::uint GetNumBroadPhaseLayers() const override { return BroadPhaseLayers::COUNT; }
+
+            JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer layer) const override {
+                return layer == ObjectLayers::NON_MOVING ? BroadPhaseLayers::NON_MOVING : BroadPhaseLayers::MOVING;
+            }
+
+#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
+            const char *GetBroadPhaseLayerName(JPH::BroadPhaseLayer layer) const override {
+                return layer == BroadPhaseLayers::NON_MOVING ? "NON_MOVING" : "MOVING";
+            }
+#endif
+        };
+
+        class ObjectVsBroadPhaseLayerFilter final : public JPH::ObjectVsBroadPhaseLayerFilter {
+        public:
+            bool ShouldCollide(JPH::ObjectLayer layer, JPH::BroadPhaseLayer broadphase_layer) const override {
+                return layer == ObjectLayers::MOVING || broadphase_layer == BroadPhaseLayers::MOVING;
+            }
+        };
+
+        class ObjectLayerPairFilter final : public JPH::ObjectLayerPairFilter {
+        public:
+            bool ShouldCollide(JPH::ObjectLayer layer_A, JPH::ObjectLayer layer_B) const override {
+                return layer_A == ObjectLayers::MOVING || layer_B == ObjectLayers::MOVING;
+            }
+        };
+
+        // Jolt keeps references to these for the lifetime of the physics system
+        const BroadPhaseLayerInterface broadphase_layer_interface{};
+        const ObjectVsBroadPhaseLayerFilter object_vs_broadphase_layer_filter{};
+        const ObjectLayerPairFilter object_layer_pair_filter{};
+
+        // the allocator, factory and type registry are global in Jolt
+        u32 instance_count = 0;
+
+        JPH::Vec3 to_jolt(const glm::vec3 &v) { return JPH::Vec3{v.x, v.y, v.z}; }
+        glm::vec3 to_glm(const JPH::Vec3 &v) { return glm::vec3{v.GetX(), v.GetY(), v.GetZ()}; }
+
+        // euler angles in radians, composed in the same order as glm::quat(rotation)
+        JPH::Quat to_jolt_rotation(const glm::vec3 &rotation) { return JPH::Quat::sEulerAngles(to_jolt(rotation)); }
+
+        // Runs Jolt's jobs on the engine JobSystem, so physics shares its threads instead of bringing
+        // a second pool. Barriers come from JobSystemWithBarrier, the thread waiting on one runs its
+        // jobs too, a job only ever executes once.
+        class JoltJobSystem final : public JPH::JobSystemWithBarrier {
+        public:
+            JoltJobSystem() : JPH::JobSystemWithBarrier(JPH::cMaxPhysicsBarriers) {
+                jobs.Init(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsJobs);
+            }
+
+            ~JoltJobSystem() override {
+                // the queued jobs still hold a reference to their Jolt job
+                Engine::JobSystem::wait(counter);
+            }
+
+            int GetMaxConcurrency() const override { return static_cast<int>(Engine::JobSystem::get_thread_count()); }
+
+            JobHandle CreateJob(const char *name, JPH::ColorArg color, const JobFunction &function, JPH::uint32 dependency_count) override {
+                JPH::uint32 index = jobs.ConstructObject(name, color, this, function, dependency_count);
+                if (index == Jobs::cInvalidObjectIndex) {
+                    throw std::runtime_error("Jolt ran out of jobs");
+                }
+
+                Job *job = &jobs.Get(index);
+                JobHandle handle{job};
+                if (dependency_count == 0) {
+                    QueueJob(job);
+                }
+                return handle;
+            }
+
+        protected:
+            void QueueJob(Job *job) override {
+                job->AddRef();
+                Engine::JobSystem::run(counter, [job](u32) {
+                    job->Execute();
+                    job->Release();
+                });
+            }
+
+            void QueueJobs(Job **queued_jobs, JPH::uint count) override {
+                for (JPH::uint i = 0; i < count; i++) {
+                    QueueJob(queued_jobs[i]);
+                }
+            }
+
+            void FreeJob(Job *job) override { jobs.DestructObject(job); }
+
+        private:
+            using Jobs = JPH::FixedSizeFreeList<Job>;
+
+            Jobs jobs;
+            JobCounter counter;
+        };
+
+        JPH::ShapeRefC create_shape(const Shape *shape) {
+            switch (shape->get_type()) {
+                case Shape::SPHERE:
+                    return new JPH::SphereShape(static_cast<const Sphere *>(shape)->radius);
+                case Shape::BOX: {
+                    // the convex radius rounds the corners and can't be larger than the box
+                    const glm::vec3 &half_extents = static_cast<const Box *>(shape)->half_extents;
+                    f32 convex_radius = std::min(JPH::cDefaultConvexRadius, std::min(half_extents.x, std::min(half_extents.y, half_extents.z)));
+                    return new JPH::BoxShape(to_jolt(half_extents), convex_radius);
+                }
+                case Shape::CONVEX: {
+                    JPH::Array<JPH::Vec3> points;
+                    for (const auto &point : static_cast<const Convex *>(shape)->points) {
+                        points.push_back(to_jolt(point));
+                    }
+
+                    JPH::ShapeSettings::ShapeResult result = JPH::ConvexHullShapeSettings(points).Create();
+                    if (result.HasError()) {
+                        return nullptr;
+                    }
+                    return result.Get();
+                }
+                default:
+                    return nullptr;
+            }
+        }
+    }
+
+    JoltPhysicsBackend::JoltPhysicsBackend() {
+        if (instance_count++ == 0) {
+            JPH::RegisterDefaultAllocator();
+            JPH::Factory::sInstance = new JPH::Factory();
+            JPH::RegisterTypes();
+        }
+
+        temp_allocator = std::make_unique<JPH::TempAllocatorImpl>(temp_allocator_size);
+
+        job_system = std::make_unique<JoltJobSystem>();
+
+        physics_system = std::make_unique<JPH::PhysicsSystem>();
+        physics_system->Init(max_bodies, 0, max_body_pairs, max_contact_constraints, broadphase_layer_interface, object_vs_broadphase_layer_filter, object_layer_pair_filter);
+    }
+
+    JoltPhysicsBackend::~JoltPhysicsBackend() {
+        for (auto& [entity, body] : bodies) {
+            destroy_body(body);
+        }
+        bodies.clear();
+
+        physics_system.reset();
+        job_system.reset();
+        temp_allocator.reset();
+
+        if (--instance_count == 0) {
+            JPH::UnregisterTypes();
+            delete JPH::Factory::sInstance;
+            JPH::Factory::sInstance = nullptr;
+        }
+    }
+
+    void JoltPhysicsBackend::add_body(entt::entity entity) {
+        // the Jolt body is created on the first sync, the component is empty at this point
+        bodies.try_emplace(entity);
+    }
+
+    void JoltPhysicsBackend::remove_body(entt::entity entity) {
+        auto it = bodies.find(entity);
+        if (it == bodies.end()) {
+            return;
+        }
+
+        destroy_body(it->second);
+        bodies.erase(it);
+    }
+
+    void JoltPhysicsBackend::sync_body(entt::entity entity, const TransformComponent &tn, const PhysicsComponent &ph, bool reload) {
+        auto it = bodies.find(entity);
+        if (it == bodies.end()) {
+            return;
+        }
+
+        Body &body = it->second;
+        const bool is_dynamic = 0.0f != ph.inverse_mass;
+
+        // shape and motion type can't be changed in place, build a new body
+        if (body.shape != ph.shape.get() || (reload && body.is_dynamic != is_dynamic)) {
+            destroy_body(body);
+            create_body(entity, body, tn, ph);
+            return;
+        }
+
+        if (!reload || body.id == ~0u) {
+            return;
+        }
+
+        JPH::BodyID id{body.id};
+        {
+            JPH::BodyLockWrite lock{physics_system->GetBodyLockInterface(), id};
+            if (lock.Succeeded()) {
+                JPH::Body &jolt_body = lock.GetBody();
+                jolt_body.SetRestitution(ph.elasticity);
+                if (is_dynamic) {
+                    jolt_body.GetMotionProperties()->SetInverseMass(ph.inverse_mass);
+                }
+            }
+        }
+
+        JPH::BodyInterface &body_interface = physics_system->GetBodyInterface();
+        body_interface.SetPositionAndRotation(id, JPH::RVec3{tn.translation.x, tn.translation.y, tn.translation.z}, to_jolt_rotation(tn.rotation), JPH::EActivation::Activate);
+        if (is_dynamic) {
+            body_interface.SetLinearVelocity(id, to_jolt(ph.linear_velocity));
+        }
+
+        body.previous_position = tn.translation;
+        body.position = tn.translation;
+        body.linear_velocity = ph.linear_velocity;
+    }
+
+    void JoltPhysicsBackend::step(const f32 &delta_time, const glm::vec3 &gravity) {
+        if (optimize_broadphase) {
+            physics_system->OptimizeBroadPhase();
+            optimize_broadphase = false;
+        }
+
+        for (auto& [entity, body] : bodies) {
+            body.previous_position = body.position;
+        }
+
+        physics_system->SetGravity(to_jolt(gravity));
+        physics_system->Update(delta_time, 1, temp_allocator.get(), job_system.get());
+
+        // between updates nothing else touches the bodies, skip the locking
+        const JPH::BodyInterface &body_interface = physics_system->GetBodyInterfaceNoLock();
+        for (auto& [entity, body] : bodies) {
+            if (!body.is_dynamic || body.id == ~0u) {
+                continue;
+            }
+
+            JPH::BodyID id{body.id};
+            const bool is_awake = body_interface.IsActive(id);
+
+            // a body that fell asleep during this step still moved in it
+            if (is_awake || body.is_awake) {
+                JPH::RVec3 position = body_interface.GetPosition(id);
+                body.position = glm::vec3{static_cast<f32>(position.GetX()), static_cast<f32>(position.GetY()), static_cast<f32>(position.GetZ())};
+                body.linear_velocity = to_glm(body_interface.GetLinearVelocity(id));
+            }
+
+            body.is_awake = is_awake;
+        }
+    }
+
+    void JoltPhysicsBackend::read_back(const BodyCallback &callback) {
+        for (auto& [entity, body] : bodies) {
+            if (!body.is_dynamic || body.id == ~0u) {
+                continue;
+            }
+
+            if (body.is_awake || body.previous_position != body.position) {
+                callback(entity, body.previous_position, body.position, body.linear_velocity);
+            }
+        }
+    }
+
+    // Only the translation is simulated, the same as the built-in backend. Bodies start out with the
+    // rotation of their transform and dynamic ones have their rotation locked, so there is no
+    // orientation to write back.
+    void JoltPhysicsBackend::create_body(entt::entity entity, Body &body, const TransformComponent &tn, const PhysicsComponent &ph) {
+        body.shape = ph.shape.get();
+        body.is_dynamic = 0.0f != ph.inverse_mass;
+        body.is_awake = body.is_dynamic;
+        body.previous_position = tn.translation;
+        body.position = tn.translation;
+        body.linear_velocity = ph.linear_velocity;
+
+        if (!body.shape) {
+            return;
+        }
+
+        JPH::ShapeRefC shape = create_shape(body.shape);
+        if (!shape) {
+            return;
+        }
+
+        JPH::BodyCreationSettings settings{shape, JPH::RVec3{tn.translation.x, tn.translation.y, tn.translation.z}, to_jolt_rotation(tn.rotation),
+                                           body.is_dynamic ? JPH::EMotionType::Dynamic : JPH::EMotionType::Static,
+                                           body.is_dynamic ? ObjectLayers::MOVING : ObjectLayers::NON_MOVING};
+        settings.mRestitution = ph.elasticity;
+        settings.mUserData = static_cast<JPH::uint64>(entt::to_integral(entity));
+        settings.mAllowSleeping = true;
+
+        if (body.is_dynamic) {
+            settings.mLinearVelocity = to_jolt(ph.linear_velocity);
+            settings.mAllowedDOFs = JPH::EAllowedDOFs::TranslationX | JPH::EAllowedDOFs::TranslationY | JPH::EAllowedDOFs::TranslationZ;
+            settings.mOverrideMassProperties = JPH::EOverrideMassProperties::CalculateInertia;
+            settings.mMassPropertiesOverride.mMass = 1.0f / ph.inverse_mass;
+        }
+
+        JPH::BodyID id = physics_system->GetBodyInterface().CreateAndAddBody(settings, body.is_dynamic ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
+        if (id.IsInvalid()) {
+            throw std::runtime_error("Jolt ran out of bodies");
+        }
+
+        body.id = id.GetIndexAndSequenceNumber();
+        optimize_broadphase = true;
+    }
+
+    void JoltPhysicsBackend::destroy_body(Body &body) {
+        if (body.id == ~0u) {
+            return;
+        }
+
+        JPH::BodyInterface &body_interface = physics_system->GetBodyInterface();
+        JPH::BodyID id{body.id};
+        body_interface.RemoveBody(id);
+        body_interface.DestroyBody(id);
+
+        body.id = ~0u;
+        body.shape = nullptr;
+    }
+}
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifdef STELLAR_ENABLE_JOLT
+
+#include "physics_backend.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace JPH {
+    class PhysicsSystem;
+    class TempAllocator;
+    class JobSystem;
+}
+
+namespace Engine {
+    // Backend running on Jolt Physics, its jobs run on the engine JobSystem.
+    // Static and dynamic bodies sit in separate broadphase layers and resting bodies go to sleep,
+    // sleeping bodies are not reported back so their transforms are left alone.
+    class JoltPhysicsBackend : public PhysicsBackend {
+    public:
+        static constexpr u32 max_bodies = 65536;
+        static constexpr u32 max_body_pairs = 65536;
+        static constexpr u32 max_contact_constraints = 10240;
+        static constexpr usize temp_allocator_size = 10 * 1024 * 1024;
+
+        JoltPhysicsBackend();
+        ~JoltPhysicsBackend() override;
+
+        JoltPhysicsBackend(const JoltPhysicsBackend &) = delete;
+        JoltPhysicsBackend &operator=(const JoltPhysicsBackend &) = delete;
+
+        void add_body(entt::entity entity) override;
+        void remove_body(entt::entity entity) override;
+        void sync_body(entt::entity entity, const TransformComponent &tn, const PhysicsComponent &ph, bool reload) override;
+
+        void step(const f32 &delta_time, const glm::vec3 &gravity) override;
+        void read_back(const BodyCallback &callback) override;
+
+    private:
+        struct Body {
+            u32 id = ~0u; // JPH::BodyID index and sequence number, ~0u while the body has no Jolt body
+            const Shape* shape = nullptr;
+            bool is_dynamic = false;
+            bool is_awake = false;
+            glm::vec3 previous_position = {0.0f, 0.0f, 0.0f};
+            glm::vec3 position = {0.0f, 0.0f, 0.0f};
+            glm::vec3 linear_velocity = {0.0f, 0.0f, 0.0f};
+        };
+
+        void create_body(entt::entity entity, Body &body, const TransformComponent &tn, const PhysicsComponent &ph);
+        void destroy_body(Body &body);
+
+        std::unique_ptr<JPH::TempAllocator> temp_allocator;
+        std::unique_ptr<JPH::JobSystem> job_system;
+        std::unique_ptr<JPH::PhysicsSystem> physics_system;
+
+        std::unordered_map<entt::entity, Body> bodies;
+        bool optimize_broadphase = false;
+    };
+}
+
+#endif
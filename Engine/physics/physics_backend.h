@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../core/types.h"
+#include "../data/components.h"
+
+#include <entt/entity/fwd.hpp>
+#include <glm/glm.hpp>
+
+#include <functional>
+
+namespace Engine {
+    // The simulation behind PhysicsSystem. PhysicsSystem owns the ECS side (component hooks,
+    // fixed stepping and interpolation), a backend only knows about bodies keyed by entity.
+    class PhysicsBackend {
+    public:
+        // callback(entity, previous_position, position, linear_velocity)
+        using BodyCallback = std::function<void(entt::entity, const glm::vec3 &, const glm::vec3 &, const glm::vec3 &)>;
+
+        virtual ~PhysicsBackend() = default;
+
+        virtual void add_body(entt::entity entity) = 0;
+        virtual void remove_body(entt::entity entity) = 0;
+
+        // Called for every body before stepping. Shape changes are picked up every time, reload
+        // additionally copies the transform and motion state over (teleport, new or edited body).
+        virtual void sync_body(entt::entity entity, const TransformComponent &tn, const PhysicsComponent &ph, bool reload) = 0;
+
+        // one fixed step, the positions from before the step are kept for interpolation
+        virtual void step(const f32 &delta_time, const glm::vec3 &gravity) = 0;
+
+        // reports every dynamic body that moved in the last step, a body that stopped moving is
+        // reported once more with the pose it came to rest at
+        virtual void read_back(const BodyCallback &callback) = 0;
+    };
+}
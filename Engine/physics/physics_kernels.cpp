@@ -0,0 +1,83 @@
+#include "physics_kernels.h"
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace Engine::PhysicsKernels {
+    void apply_gravity(f32 *velocity_x, f32 *velocity_y, f32 *velocity_z, const f32 *inverse_mass, u32 count, const glm::vec3 &gravity, f32 delta_time) {
+        const glm::vec3 dv = gravity * delta_time;
+        u32 i = 0;
+
+#if defined(__AVX__)
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 dv_x = _mm256_set1_ps(dv.x);
+        const __m256 dv_y = _mm256_set1_ps(dv.y);
+        const __m256 dv_z = _mm256_set1_ps(dv.z);
+        for (; i + 8 <= count; i += 8) {
+            // static bodies (inverse mass of zero) are masked out
+            __m256 dynamic = _mm256_cmp_ps(_mm256_loadu_ps(inverse_mass + i), zero, _CMP_NEQ_OQ);
+            _mm256_storeu_ps(velocity_x + i, _mm256_add_ps(_mm256_loadu_ps(velocity_x + i), _mm256_and_ps(dynamic, dv_x)));
+            _mm256_storeu_ps(velocity_y + i, _mm256_add_ps(_mm256_loadu_ps(velocity_y + i), _mm256_and_ps(dynamic, dv_y)));
+            _mm256_storeu_ps(velocity_z + i, _mm256_add_ps(_mm256_loadu_ps(velocity_z + i), _mm256_and_ps(dynamic, dv_z)));
+        }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+        const __m128 zero_4 = _mm_setzero_ps();
+        const __m128 dv_x_4 = _mm_set1_ps(dv.x);
+        const __m128 dv_y_4 = _mm_set1_ps(dv.y);
+        const __m128 dv_z_4 = _mm_set1_ps(dv.z);
+        for (; i + 4 <= count; i += 4) {
+            __m128 dynamic = _mm_cmpneq_ps(_mm_loadu_ps(inverse_mass + i), zero_4);
+            _mm_storeu_ps(velocity_x + i, _mm_add_ps(_mm_loadu_ps(velocity_x + i), _mm_and_ps(dynamic, dv_x_4)));
+            _mm_storeu_ps(velocity_y + i, _mm_add_ps(_mm_loadu_ps(velocity_y + i), _mm_and_ps(dynamic, dv_y_4)));
+            _mm_storeu_ps(velocity_z + i, _mm_add_ps(_mm_loadu_ps(velocity_z + i), _mm_and_ps(dynamic, dv_z_4)));
+        }
+#endif
+
+        for (; i < count; i++) {
+            if (0.0f == inverse_mass[i]) {
+                continue;
+            }
+
+            velocity_x[i] += dv.x;
+            velocity_y[i] += dv.y;
+            velocity_z[i] += dv.z;
+        }
+    }
+
+    void integrate_positions(f32 *position_x, f32 *position_y, f32 *position_z, const f32 *velocity_x, const f32 *velocity_y, const f32 *velocity_z, u32 count, f32 delta_time) {
+        u32 i = 0;
+
+#if defined(__AVX__)
+        const __m256 dt = _mm256_set1_ps(delta_time);
+        for (; i + 8 <= count; i += 8) {
+#if defined(__FMA__)
+            _mm256_storeu_ps(position_x + i, _mm256_fmadd_ps(_mm256_loadu_ps(velocity_x + i), dt, _mm256_loadu_ps(position_x + i)));
+            _mm256_storeu_ps(position_y + i, _mm256_fmadd_ps(_mm256_loadu_ps(velocity_y + i), dt, _mm256_loadu_ps(position_y + i)));
+            _mm256_storeu_ps(position_z + i, _mm256_fmadd_ps(_mm256_loadu_ps(velocity_z + i), dt, _mm256_loadu_ps(position_z + i)));
+#else
+            _mm256_storeu_ps(position_x + i, _mm256_add_ps(_mm256_loadu_ps(position_x + i), _mm256_mul_ps(_mm256_loadu_ps(velocity_x + i), dt)));
+            _mm256_storeu_ps(position_y + i, _mm256_add_ps(_mm256_loadu_ps(position_y + i), _mm256_mul_ps(_mm256_loadu_ps(velocity_y + i), dt)));
+            _mm256_storeu_ps(position_z + i, _mm256_add_ps(_mm256_loadu_ps(position_z + i), _mm256_mul_ps(_mm256_loadu_ps(velocity_z + i), dt)));
+#endif
+        }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+        const __m128 dt_4 = _mm_set1_ps(delta_time);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(position_x + i, _mm_add_ps(_mm_loadu_ps(position_x + i), _mm_mul_ps(_mm_loadu_ps(velocity_x + i), dt_4)));
+            _mm_storeu_ps(position_y + i, _mm_add_ps(_mm_loadu_ps(position_y + i), _mm_mul_ps(_mm_loadu_ps(velocity_y + i), dt_4)));
+            _mm_storeu_ps(position_z + i, _mm_add_ps(_mm_loadu_ps(position_z + i), _mm_mul_ps(_mm_loadu_ps(velocity_z + i), dt_4)));
+        }
+#endif
+
+        for (; i < count; i++) {
+            position_x[i] += velocity_x[i] * delta_time;
+            position_y[i] += velocity_y[i] * delta_time;
+            position_z[i] += velocity_z[i] * delta_time;
+        }
+    }
+}
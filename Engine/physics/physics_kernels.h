@@ -0,0 +1,15 @@
+#pragma once
+
+#include "../core/types.h"
+
+#include <glm/glm.hpp>
+
+// Wide kernels over the BodyStore arrays. AVX is used when the engine is compiled with it
+// (STELLAR_ENABLE_AVX2), SSE2 on every other x86-64 build and plain loops elsewhere.
+namespace Engine::PhysicsKernels {
+    // velocity += gravity * delta_time for every body with a non zero inverse mass
+    void apply_gravity(f32 *velocity_x, f32 *velocity_y, f32 *velocity_z, const f32 *inverse_mass, u32 count, const glm::vec3 &gravity, f32 delta_time);
+
+    // position += velocity * delta_time
+    void integrate_positions(f32 *position_x, f32 *position_y, f32 *position_z, const f32 *velocity_x, const f32 *velocity_y, const f32 *velocity_z, u32 count, f32 delta_time);
+}
@@ -0,0 +1,253 @@
+#include "physics_recording.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Engine {
+    PhysicsRecorder::PhysicsRecorder(const std::string &path) : file{path, std::ios::binary | std::ios::trunc} {
+        if (!file) {
+            throw std::runtime_error("failed to open physics recording: " + path);
+        }
+
+        file.write(PhysicsRecording::magic, sizeof(PhysicsRecording::magic));
+        write(PhysicsRecording::version);
+    }
+
+    void PhysicsRecorder::add_body(entt::entity entity) {
+        write(PhysicsRecording::ADD_BODY);
+        write(entt::to_integral(entity));
+    }
+
+    void PhysicsRecorder::remove_body(entt::entity entity) {
+        write(PhysicsRecording::REMOVE_BODY);
+        write(entt::to_integral(entity));
+        shapes.erase(entity);
+    }
+
+    void PhysicsRecorder::sync_body(entt::entity entity, const TransformComponent &tn, const PhysicsComponent &ph, bool reload) {
+        auto it = shapes.find(entity);
+        const bool shape_changed = it == shapes.end() || it->second != ph.shape.get();
+        if (!reload && !shape_changed) {
+            return;
+        }
+        shapes[entity] = ph.shape.get();
+
+        write(PhysicsRecording::SYNC_BODY);
+        write(entt::to_integral(entity));
+        write(static_cast<u8>(reload));
+        write(tn.translation);
+        write(ph.linear_velocity);
+        write(ph.inverse_mass);
+        write(ph.elasticity);
+        write(static_cast<u8>(shape_changed));
+        if (shape_changed) {
+            write_shape(ph.shape.get());
+        }
+    }
+
+    void PhysicsRecorder::step(const f32 &delta_time, const glm::vec3 &gravity) {
+        write(PhysicsRecording::STEP);
+        write(delta_time);
+        write(gravity);
+    }
+
+    void PhysicsRecorder::write_shape(const Shape *shape) {
+        if (!shape) {
+            write(PhysicsRecording::no_shape);
+            return;
+        }
+
+        write(static_cast<u8>(shape->get_type()));
+        switch (shape->get_type()) {
+            case Shape::SPHERE:
+                write(static_cast<const Sphere *>(shape)->radius);
+                break;
+            case Shape::BOX:
+                write(static_cast<const Box *>(shape)->half_extents);
+                break;
+            case Shape::CONVEX: {
+                const auto &points = static_cast<const Convex *>(shape)->points;
+                write(static_cast<u32>(points.size()));
+                file.write(reinterpret_cast<const char *>(points.data()), static_cast<std::streamsize>(points.size() * sizeof(glm::vec3)));
+                break;
+            }
+        }
+    }
+
+    namespace {
+        class RecordReader {
+        public:
+            RecordReader(const std::vector<char> &_data, usize _cursor) : data{_data}, cursor{_cursor} {}
+
+            bool is_done() const { return cursor == data.size(); }
+
+            template<typename T>
+            T read() {
+                T value;
+                read_bytes(&value, sizeof(T));
+                return value;
+            }
+
+            void read_bytes(void *destination, usize size) {
+                if (data.size() - cursor < size) {
+                    throw std::runtime_error("physics recording is truncated");
+                }
+                std::memcpy(destination, data.data() + cursor, size);
+                cursor += size;
+            }
+
+        private:
+            const std::vector<char> &data;
+            usize cursor;
+        };
+
+        std::unique_ptr<Shape> read_shape(RecordReader &reader) {
+            const u8 type = reader.read<u8>();
+            switch (type) {
+                case PhysicsRecording::no_shape:
+                    return nullptr;
+                case Shape::SPHERE:
+                    return std::make_unique<Sphere>(reader.read<f32>());
+                case Shape::BOX:
+                    return std::make_unique<Box>(reader.read<glm::vec3>());
+                case Shape::CONVEX: {
+                    // the hull keeps the order of its input, so the support functions break ties the same way
+                    std::vector<glm::vec3> points(reader.read<u32>());
+                    reader.read_bytes(points.data(), points.size() * sizeof(glm::vec3));
+                    return std::make_unique<Convex>(points);
+                }
+                default:
+                    throw std::runtime_error("unknown shape in physics recording");
+            }
+        }
+    }
+
+    PhysicsReplay::PhysicsReplay(const std::string &path) {
+        std::ifstream file{path, std::ios::binary};
+        if (!file) {
+            throw std::runtime_error("failed to open physics recording: " + path);
+        }
+
+        const std::vector<char> data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        if (data.size() < sizeof(PhysicsRecording::magic) || !std::equal(std::begin(PhysicsRecording::magic), std::end(PhysicsRecording::magic), data.begin())) {
+            throw std::runtime_error("not a physics recording: " + path);
+        }
+
+        RecordReader reader{data, sizeof(PhysicsRecording::magic)};
+        if (reader.read<u32>() != PhysicsRecording::version) {
+            throw std::runtime_error("unsupported physics recording version: " + path);
+        }
+
+        while (!reader.is_done()) {
+            Record record;
+            record.type = static_cast<PhysicsRecording::RecordType>(reader.read<u8>());
+
+            switch (record.type) {
+                case PhysicsRecording::ADD_BODY:
+                case PhysicsRecording::REMOVE_BODY:
+                    record.entity = static_cast<entt::entity>(reader.read<std::underlying_type_t<entt::entity>>());
+                    break;
+                case PhysicsRecording::SYNC_BODY:
+                    record.entity = static_cast<entt::entity>(reader.read<std::underlying_type_t<entt::entity>>());
+                    record.reload = 0 != reader.read<u8>();
+                    record.translation = reader.read<glm::vec3>();
+                    record.linear_velocity = reader.read<glm::vec3>();
+                    record.inverse_mass = reader.read<f32>();
+                    record.elasticity = reader.read<f32>();
+                    record.shape_changed = 0 != reader.read<u8>();
+                    if (record.shape_changed) {
+                        record.shape = read_shape(reader);
+                    }
+                    break;
+                case PhysicsRecording::STEP:
+                    record.delta_time = reader.read<f32>();
+                    record.gravity = reader.read<glm::vec3>();
+                    step_count++;
+                    break;
+                default:
+                    throw std::runtime_error("corrupt physics recording: " + path);
+            }
+
+            records.push_back(std::move(record));
+        }
+    }
+
+    bool PhysicsReplay::next_step(PhysicsBackend &backend, f32 &delta_time, glm::vec3 &gravity) {
+        while (next_record < records.size()) {
+            Record &record = records[next_record++];
+
+            switch (record.type) {
+                case PhysicsRecording::ADD_BODY:
+                    bodies[record.entity];
+                    backend.add_body(record.entity);
+                    break;
+                case PhysicsRecording::REMOVE_BODY:
+                    backend.remove_body(record.entity);
+                    bodies.erase(record.entity);
+                    break;
+                case PhysicsRecording::SYNC_BODY: {
+                    Body &body = bodies[record.entity];
+                    body.tn.translation = record.translation;
+                    body.ph.linear_velocity = record.linear_velocity;
+                    body.ph.inverse_mass = record.inverse_mass;
+                    body.ph.elasticity = record.elasticity;
+
+                    // the backend lets go of the old shape in this call, it has to outlive it
+                    std::shared_ptr<const Shape> old_shape;
+                    if (record.shape_changed) {
+                        old_shape = std::move(body.ph.shape);
+                        body.ph.shape = std::move(record.shape);
+                    }
+                    backend.sync_body(record.entity, body.tn, body.ph, record.reload);
+                    break;
+                }
+                case PhysicsRecording::STEP:
+                    delta_time = record.delta_time;
+                    gravity = record.gravity;
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    void PhysicsReplay::read_back(PhysicsBackend &backend) {
+        backend.read_back([&](entt::entity entity, const glm::vec3 &, const glm::vec3 &position, const glm::vec3 &linear_velocity) {
+            auto it = bodies.find(entity);
+            if (it != bodies.end()) {
+                it->second.tn.translation = position;
+                it->second.ph.linear_velocity = linear_velocity;
+            }
+        });
+    }
+
+    u64 PhysicsReplay::get_checksum() const {
+        std::vector<entt::entity> entities;
+        entities.reserve(bodies.size());
+        for (const auto &[entity, body] : bodies) {
+            entities.push_back(entity);
+        }
+        std::sort(entities.begin(), entities.end());
+
+        u64 hash = 14695981039346656037ull;
+        auto hash_bytes = [&](const void *bytes, usize size) {
+            for (usize i = 0; i < size; i++) {
+                hash ^= static_cast<const u8 *>(bytes)[i];
+                hash *= 1099511628211ull;
+            }
+        };
+
+        for (entt::entity entity : entities) {
+            const Body &body = bodies.at(entity);
+            const auto id = entt::to_integral(entity);
+            hash_bytes(&id, sizeof(id));
+            hash_bytes(&body.tn.translation, sizeof(glm::vec3));
+            hash_bytes(&body.ph.linear_velocity, sizeof(glm::vec3));
+        }
+
+        return hash;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "../core/types.h"
+#include "../data/components.h"
+#include "physics_backend.h"
+
+#include <entt/entity/entity.hpp>
+#include <glm/glm.hpp>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+    // A recording is the list of calls a PhysicsBackend got from PhysicsSystem: bodies added and
+    // removed, the state they were (re)loaded with and every fixed step. The backends only depend
+    // on these calls and their order, so feeding them to a fresh backend reruns the simulation
+    // without a scene, a window or a frame time.
+    //
+    // File layout, little endian: "SPRC", u32 version, then records of a u8 type and its payload.
+    namespace PhysicsRecording {
+        constexpr char magic[4] = {'S', 'P', 'R', 'C'};
+        constexpr u32 version = 1;
+
+        enum RecordType : u8 {
+            ADD_BODY = 0,    // u32 entity
+            REMOVE_BODY = 1, // u32 entity
+            SYNC_BODY = 2,   // u32 entity, u8 reload, vec3 translation, vec3 linear_velocity, f32 inverse_mass, f32 elasticity, u8 shape_changed [, shape]
+            STEP = 3,        // f32 delta_time, vec3 gravity
+        };
+
+        // shape: u8 type or no_shape, then f32 radius (SPHERE), vec3 half_extents (BOX) or u32 count + count * vec3 (CONVEX)
+        constexpr u8 no_shape = 0xFF;
+    }
+
+    class PhysicsRecorder {
+    public:
+        // throws when the file can't be opened
+        explicit PhysicsRecorder(const std::string &path);
+
+        PhysicsRecorder(const PhysicsRecorder &) = delete;
+        PhysicsRecorder &operator=(const PhysicsRecorder &) = delete;
+
+        void add_body(entt::entity entity);
+        void remove_body(entt::entity entity);
+
+        // only syncs that change something in the backend are written, a reload or a new shape
+        void sync_body(entt::entity entity, const TransformComponent &tn, const PhysicsComponent &ph, bool reload);
+
+        void step(const f32 &delta_time, const glm::vec3 &gravity);
+
+    private:
+        void write_shape(const Shape *shape);
+
+        template<typename T>
+        void write(const T &value) { file.write(reinterpret_cast<const char *>(&value), sizeof(T)); }
+
+        std::ofstream file;
+        std::unordered_map<entt::entity, const Shape *> shapes;
+    };
+
+    // Plays a recording back into any backend, once. The replay owns the components the backend
+    // sees, including the shapes, and mirrors the read back state like PhysicsSystem does for the scene.
+    class PhysicsReplay {
+    public:
+        // reads and checks the whole file up front, throws when it isn't a valid recording
+        explicit PhysicsReplay(const std::string &path);
+
+        PhysicsReplay(const PhysicsReplay &) = delete;
+        PhysicsReplay &operator=(const PhysicsReplay &) = delete;
+
+        // Applies the records up to the next step to the backend and returns that step's input,
+        // the caller runs the step itself so it can time it. False once the recording is exhausted.
+        bool next_step(PhysicsBackend &backend, f32 &delta_time, glm::vec3 &gravity);
+
+        // copies the bodies the backend reports back into the mirrored components
+        void read_back(PhysicsBackend &backend);
+
+        // FNV-1a over entity, translation and velocity of every body in entity order
+        u64 get_checksum() const;
+
+        u32 get_step_count() const { return step_count; }
+        u32 get_body_count() const { return static_cast<u32>(bodies.size()); }
+
+    private:
+        struct Record {
+            PhysicsRecording::RecordType type;
+            entt::entity entity{entt::null};
+            bool reload = false;
+            glm::vec3 translation{0.0f};
+            glm::vec3 linear_velocity{0.0f};
+            f32 inverse_mass = 0.0f;
+            f32 elasticity = 0.0f;
+            bool shape_changed = false;
+            std::unique_ptr<Shape> shape; // moved into the body when the record is applied
+            f32 delta_time = 0.0f;
+            glm::vec3 gravity{0.0f};
+        };
+
+        struct Body {
+            TransformComponent tn;
+            PhysicsComponent ph;
+        };
+
+        std::vector<Record> records;
+        usize next_record = 0;
+        u32 step_count = 0;
+
+        // node based, the backend keeps pointers to the shapes
+        std::unordered_map<entt::entity, Body> bodies;
+    };
+}
@@ -2,71 +2,138 @@
 
 #include "../data/entity.h"
 
-#include "contact.h"
-#include "intersect.h"
+#include "builtin_physics_backend.h"
+
+#include <algorithm>
 
 namespace Engine {
-    void PhysicsSystem::update(const f32 &detla_time) {
-        scene->registry.each([&](auto entityID) {
-            Entity entity = {entityID, scene.get()};
-            if (!entity)
-                return;
+    PhysicsSystem::PhysicsSystem(std::shared_ptr<Scene> _scene, std::unique_ptr<PhysicsBackend> _backend) : scene{std::move(_scene)}, backend{std::move(_backend)} {
+        if (!backend) {
+            backend = std::make_unique<BuiltinPhysicsBackend>();
+        }
 
-            if (entity.has_component<PhysicsComponent>()) {
-                auto& ph = entity.get_component<PhysicsComponent>();
-                f32 mass = 1.0f / ph.inverse_mass;
-                glm::vec3 impulse_gravity = glm::vec3{ 0.0f, -10.0f, 0.0f } * mass * detla_time;
-                ph.apply_impulse_linear(impulse_gravity);
-            }
+        auto& registry = scene->registry;
+        registry.on_construct<PhysicsComponent>().connect<&PhysicsSystem::on_physics_component_construct>(*this);
+        registry.on_destroy<PhysicsComponent>().connect<&PhysicsSystem::on_physics_component_destroy>(*this);
+
+        registry.view<PhysicsComponent>().each([&](auto entity, PhysicsComponent&) {
+            backend->add_body(entity);
+            added_bodies.push_back(entity);
         });
+    }
 
-        scene->registry.each([&](auto entityID_A) {
-            Entity entity_A = {entityID_A, scene.get()};
-            if (!entity_A)
-                return;
+    PhysicsSystem::~PhysicsSystem() {
+        auto& registry = scene->registry;
+        registry.on_construct<PhysicsComponent>().disconnect<&PhysicsSystem::on_physics_component_construct>(*this);
+        registry.on_destroy<PhysicsComponent>().disconnect<&PhysicsSystem::on_physics_component_destroy>(*this);
+    }
 
-            if(!entity_A.has_component<PhysicsComponent>()) {
-                return;
+    void PhysicsSystem::on_physics_component_construct(entt::registry &, entt::entity entity) {
+        // the component is usually filled in after add_component, sync_bodies picks the data up
+        backend->add_body(entity);
+        added_bodies.push_back(entity);
+
+        if (recorder) {
+            recorder->add_body(entity);
+        }
+    }
+
+    void PhysicsSystem::on_physics_component_destroy(entt::registry &, entt::entity entity) {
+        backend->remove_body(entity);
+
+        if (recorder) {
+            recorder->remove_body(entity);
+        }
+    }
+
+    void PhysicsSystem::start_recording(const std::string &path) {
+        recorder = std::make_unique<PhysicsRecorder>(path);
+
+        scene->registry.view<PhysicsComponent>().each([&](auto entity, PhysicsComponent&) {
+            recorder->add_body(entity);
+            added_bodies.push_back(entity);
+        });
+    }
+
+    void PhysicsSystem::update(const f32 &frame_time) {
+        sync_bodies();
+
+        accumulator += frame_time;
+
+        u32 steps = 0;
+        while (accumulator >= fixed_time_step && steps < max_steps_per_update) {
+            if (recorder) {
+                recorder->step(fixed_time_step, gravity);
             }
+            backend->step(fixed_time_step, gravity);
+
+            accumulator -= fixed_time_step;
+            steps++;
+        }
 
-            scene->registry.each([&](auto entityID_B) {
-                Entity entity_B = {entityID_B, scene.get()};
-                if (!entity_B)
-                    return;
+        // after a stall drop the time we couldn't simulate instead of trying to catch up next frame
+        accumulator = std::min(accumulator, fixed_time_step);
 
-                if(!entity_B.has_component<PhysicsComponent>()) {
-                    return;
-                }
+        write_back(get_interpolation_alpha());
+    }
 
-                if(entity_A.get_UUID() == entity_B.get_UUID()) {
-                    return;
-                }
+    // The backend owns the simulated state. Bodies that were moved outside of physics (editor,
+    // scripts, deserialization) are reloaded from their components. Whether a script ran before or
+    // after the last update_transforms, its translation differs from the one physics last synced.
+    void PhysicsSystem::sync_bodies() {
+        auto& registry = scene->registry;
 
-                auto& ph_A = entity_A.get_component<PhysicsComponent>();
-                auto& ph_B = entity_B.get_component<PhysicsComponent>();
+        for (auto entity : added_bodies) {
+            if (!registry.valid(entity)) {
+                continue;
+            }
 
-                if (0.0f == ph_A.inverse_mass && 0.0f == ph_B.inverse_mass) {
-                    return;
-                }
-                Contact contact;
+            auto* tn = registry.try_get<TransformComponent>(entity);
+            auto* ph = registry.try_get<PhysicsComponent>(entity);
+            if (tn && ph) {
+                sync_body(entity, *tn, *ph, true);
+            }
+        }
+        added_bodies.clear();
 
-                if(intersect(entity_A, entity_B, contact)) {
-                    resolve_contact(contact);
-                }
-            });
+        scene->group<PhysicsComponent>(entt::get<TransformComponent>).each([&](auto entity, PhysicsComponent& ph, TransformComponent& tn) {
+            sync_body(entity, tn, ph, tn.translation != ph.synced_translation);
         });
+    }
 
-        scene->registry.each([&](auto entityID) {
-            Entity entity = {entityID, scene.get()};
-            if (!entity)
+    void PhysicsSystem::sync_body(entt::entity entity, const TransformComponent &tn, PhysicsComponent &ph, bool reload) {
+        if (recorder) {
+            recorder->sync_body(entity, tn, ph, reload);
+        }
+        backend->sync_body(entity, tn, ph, reload);
+
+        if (reload) {
+            ph.synced_translation = tn.translation;
+        }
+    }
+
+    void PhysicsSystem::write_back(const f32 &alpha) {
+        auto& registry = scene->registry;
+
+        backend->read_back([&](entt::entity entity, const glm::vec3& previous_position, const glm::vec3& position, const glm::vec3& linear_velocity) {
+            auto* tn = registry.try_get<TransformComponent>(entity);
+            if (!tn) {
                 return;
+            }
+
+            // the velocity changes even when the body ends up where it was (bouncing, or a step
+            // that cancelled out)
+            auto& ph = registry.get<PhysicsComponent>(entity);
+            ph.linear_velocity = linear_velocity;
 
-            if (entity.has_component<PhysicsComponent>()) {
-                auto& tn = entity.get_component<TransformComponent>();
-                auto& ph = entity.get_component<PhysicsComponent>();
-                tn.translation += ph.linear_velocity * detla_time;
-                tn.is_dirty = true;
+            glm::vec3 translation = previous_position + (position - previous_position) * alpha;
+            if (translation == tn->translation) {
+                return;
             }
+
+            tn->translation = translation;
+            tn->is_dirty = true;
+            ph.synced_translation = translation;
         });
     }
-}
\ No newline at end of file
+}
@@ -1,16 +1,55 @@
 #pragma once
 
 #include "../data/scene.h"
+#include "physics_backend.h"
+#include "physics_recording.h"
+
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Engine {
     class PhysicsSystem {
     public:
-        PhysicsSystem(std::shared_ptr<Scene> _scene) : scene{_scene} {}
+        // without a backend the built-in solver is used
+        PhysicsSystem(std::shared_ptr<Scene> _scene, std::unique_ptr<PhysicsBackend> _backend = nullptr);
+        ~PhysicsSystem();
+
+        PhysicsSystem(const PhysicsSystem &) = delete;
+        PhysicsSystem &operator=(const PhysicsSystem &) = delete;
+
+        // Advances the simulation by frame_time using fixed steps, transforms are interpolated
+        // between the last two steps so rendering doesn't have to run at the physics rate.
+        void update(const f32& frame_time);
+
+        // Writes everything the backend gets fed from now on to a file that PhysicsReplay can run
+        // headless. Every body is reloaded from its components first, so the recording starts from
+        // a state the replay can rebuild. Recording from the start of a play session reproduces it
+        // bit for bit, a later start can order the bodies differently inside a fresh backend.
+        void start_recording(const std::string& path);
+        void stop_recording() { recorder.reset(); }
+        bool is_recording() const { return recorder != nullptr; }
 
-        void update(const f32& detla_time);
+        f32 get_interpolation_alpha() const { return accumulator / fixed_time_step; }
+        PhysicsBackend& get_backend() { return *backend; }
+
+        glm::vec3 gravity = {0.0f, -10.0f, 0.0f};
+        f32 fixed_time_step = 1.0f / 60.0f;
+        u32 max_steps_per_update = 4; // caps the cost of a frame after a stall
 
     private:
+        void sync_bodies();
+        void sync_body(entt::entity entity, const TransformComponent& tn, PhysicsComponent& ph, bool reload);
+        void write_back(const f32& alpha);
+
+        void on_physics_component_construct(entt::registry &registry, entt::entity entity);
+        void on_physics_component_destroy(entt::registry &registry, entt::entity entity);
+
         std::shared_ptr<Scene> scene;
+        std::unique_ptr<PhysicsBackend> backend;
+        f32 accumulator = 0.0f;
+
+        std::vector<entt::entity> added_bodies;
+        std::unique_ptr<PhysicsRecorder> recorder;
     };
-}
\ No newline at end of file
+}
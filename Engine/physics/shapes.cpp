@@ -0,0 +1,48 @@
+#include "shapes.h"
+
+#include "convex_hull.h"
+
+namespace Engine {
+    Box::Box(const glm::vec3& _half_extents) : half_extents{_half_extents} {
+        center_mass = { 0.0f, 0.0f, 0.0f };
+    }
+
+    glm::vec3 Box::support(const glm::vec3& direction, const glm::vec3& position, const f32& bias) const {
+        glm::vec3 corner = {
+            direction.x < 0.0f ? -half_extents.x : half_extents.x,
+            direction.y < 0.0f ? -half_extents.y : half_extents.y,
+            direction.z < 0.0f ? -half_extents.z : half_extents.z,
+        };
+
+        return position + corner + glm::normalize(direction) * bias;
+    }
+
+    Convex::Convex(const std::vector<glm::vec3>& _points) {
+        points = build_convex_hull(_points).points;
+
+        // the vertex average is close enough while bodies don't rotate
+        center_mass = { 0.0f, 0.0f, 0.0f };
+        for (const auto& point : points) {
+            bounds.expand_to_include(point);
+            bounding_radius = glm::max(bounding_radius, glm::length(point));
+            center_mass += point;
+        }
+        center_mass /= static_cast<f32>(points.size());
+    }
+
+    Convex::Convex(const Model& model) : Convex{build_convex_hull(model).points} {}
+
+    glm::vec3 Convex::support(const glm::vec3& direction, const glm::vec3& position, const f32& bias) const {
+        glm::vec3 best_point = points[0];
+        f32 best_distance = glm::dot(direction, points[0]);
+        for (usize i = 1; i < points.size(); i++) {
+            f32 distance = glm::dot(direction, points[i]);
+            if (distance > best_distance) {
+                best_distance = distance;
+                best_point = points[i];
+            }
+        }
+
+        return position + best_point + glm::normalize(direction) * bias;
+    }
+}
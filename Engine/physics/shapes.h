@@ -2,8 +2,13 @@
 
 #include <glm/glm.hpp>
 #include "../core/types.h"
+#include "../math/aabb.h"
+
+#include <vector>
 
 namespace Engine {
+    class Model;
+
     class Shape {
     public:
         enum ShapeType {
@@ -17,6 +22,14 @@ namespace Engine {
 
         virtual glm::vec3 get_center_mass() const { return center_mass;}
         virtual ShapeType get_type() const = 0;
+        virtual AABB get_bounds(const glm::vec3& position) const = 0;
+
+        // distance of the farthest point from the origin of the shape
+        virtual f32 get_bounding_radius() const = 0;
+
+        // Farthest point of the shape in the given direction, pushed out by bias along it.
+        // This is all the GJK/EPA narrowphase needs to know about a shape.
+        virtual glm::vec3 support(const glm::vec3& direction, const glm::vec3& position, const f32& bias) const = 0;
 
     protected:
 	    glm::vec3 center_mass;
@@ -26,9 +39,40 @@ namespace Engine {
     class Sphere : public Shape {
     public:
         explicit Sphere(const f32& _radius) : radius{_radius} { center_mass = { 0.0f, 0.0f, 0.0f }; }
-        
+
         ShapeType get_type() const override { return ShapeType::SPHERE; }
+        AABB get_bounds(const glm::vec3& position) const override { return AABB{position - glm::vec3{radius}, position + glm::vec3{radius}}; }
+        f32 get_bounding_radius() const override { return radius; }
+        glm::vec3 support(const glm::vec3& direction, const glm::vec3& position, const f32& bias) const override { return position + glm::normalize(direction) * (radius + bias); }
     public:
         f32 radius;
     };
-}
\ No newline at end of file
+
+    class Box : public Shape {
+    public:
+        explicit Box(const glm::vec3& _half_extents);
+
+        ShapeType get_type() const override { return ShapeType::BOX; }
+        AABB get_bounds(const glm::vec3& position) const override { return AABB{position - half_extents, position + half_extents}; }
+        f32 get_bounding_radius() const override { return glm::length(half_extents); }
+        glm::vec3 support(const glm::vec3& direction, const glm::vec3& position, const f32& bias) const override;
+    public:
+        glm::vec3 half_extents;
+    };
+
+    // Convex hull around a point cloud, the points don't have to be a hull already.
+    class Convex : public Shape {
+    public:
+        explicit Convex(const std::vector<glm::vec3>& _points);
+        explicit Convex(const Model& model);
+
+        ShapeType get_type() const override { return ShapeType::CONVEX; }
+        AABB get_bounds(const glm::vec3& position) const override { return AABB{position + bounds.min, position + bounds.max}; }
+        f32 get_bounding_radius() const override { return bounding_radius; }
+        glm::vec3 support(const glm::vec3& direction, const glm::vec3& position, const f32& bias) const override;
+    public:
+        std::vector<glm::vec3> points; // hull vertices only
+        AABB bounds;
+        f32 bounding_radius = 0.0f;
+    };
+}
@@ -1,12 +1,16 @@
 #pragma once
 
+#include "../data/command_buffer.h"
 #include "../data/scene.h"
+#include "../data/scene_query.h"
+#include "script_access.h"
 
 namespace Engine {
     class NativeScript {
     public:
 
-        NativeScript(entt::entity entity, std::shared_ptr<Scene> scene) : handle(entity), registry(scene->registry) {}
+        NativeScript(entt::entity entity, Scene &scene) : handle(entity), registry(scene.registry), query(scene.get_query()), commands(scene.get_commands()) {}
+        NativeScript(entt::entity entity, const std::shared_ptr<Scene> &scene) : NativeScript(entity, *scene) {}
         virtual ~NativeScript() = default;
 
         virtual void start() = 0;
@@ -14,9 +18,20 @@ namespace Engine {
         virtual void update(const float &deltaTime) = 0;
         virtual void on_event() = 0;
 
+        // Components update() touches, once per script type. Scripts run in parallel with others that
+        // don't touch the same components, the default runs the script alone. update() must not change
+        // the registry structure, that goes through commands.
+        virtual void declare_access(ScriptAccess &access) const { access.exclusive(); }
+
+        // A new instance of the script for entity in scene, used when a scene is copied. Scripts that
+        // don't override it are left out of copies.
+        virtual std::shared_ptr<NativeScript> clone(entt::entity, Scene &) const { return nullptr; }
+
     protected:
         entt::entity handle;
         entt::registry &registry;
+        const SceneQuery &query;
+        CommandBuffer &commands;
 
     };
 }
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "script_access.h"
+
+#include <atomic>
+#include <stdexcept>
+
+namespace Engine {
+    u64 ScriptAccess::next_component_bit() {
+        static std::atomic<u32> next_index{0};
+
+        const u32 index = next_index.fetch_add(1);
+        if (index >= 64) {
+            throw std::runtime_error("script access can track at most 64 component types");
+        }
+        return 1ull << index;
+    }
+
+    bool ScriptAccess::conflicts_with(const ScriptAccess &other) const {
+        if (is_exclusive || other.is_exclusive) {
+            return true;
+        }
+
+        // a write to any entity overlaps with every access to that component, a read of any entity
+        // only with writes
+        const u64 all = own_read | own_write | any_read | any_write;
+        const u64 other_all = other.own_read | other.own_write | other.any_read | other.any_write;
+        return (any_write & other_all) || (other.any_write & all) || (any_read & other.own_write) || (other.any_read & own_write);
+    }
+}
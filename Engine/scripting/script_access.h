@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../core/types.h"
+
+namespace Engine {
+    // Which components a script type touches during update(), the ScriptScheduler runs two script
+    // types side by side only when their access can't overlap. Access to the script's own entity
+    // never overlaps between two scripts (an entity has one script), access to any other entity is
+    // checked per component type. A script that doesn't declare anything is exclusive and runs alone.
+    class ScriptAccess {
+    public:
+        // components of the script's own entity
+        template<typename T>
+        ScriptAccess &read() { own_read |= get_component_bit<T>(); return *this; }
+        template<typename T>
+        ScriptAccess &write() { own_write |= get_component_bit<T>(); return *this; }
+
+        // components of any entity, through the registry or the SceneQuery
+        template<typename T>
+        ScriptAccess &read_any() { any_read |= get_component_bit<T>(); return *this; }
+        template<typename T>
+        ScriptAccess &write_any() { any_write |= get_component_bit<T>(); return *this; }
+
+        // runs on its own, for scripts that touch things outside the registry
+        ScriptAccess &exclusive() { is_exclusive = true; return *this; }
+
+        bool conflicts_with(const ScriptAccess &other) const;
+
+        // instances of the type can't run next to each other
+        bool conflicts_with_itself() const { return conflicts_with(*this); }
+
+    private:
+        // bit per component type, handed out on first use
+        static u64 next_component_bit();
+
+        template<typename T>
+        static u64 get_component_bit() {
+            static const u64 bit = next_component_bit();
+            return bit;
+        }
+
+        u64 own_read = 0;
+        u64 own_write = 0;
+        u64 any_read = 0;
+        u64 any_write = 0;
+        bool is_exclusive = false;
+    };
+}
@@ -0,0 +1,128 @@
+#include "script_scheduler.h"
+#include "native_script.h"
+
+#include "../core/job_system.h"
+#include "../data/command_buffer.h"
+#include "../data/components.h"
+#include "../data/scene.h"
+
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace Engine {
+    ScriptScheduler::ScriptScheduler(Scene &_scene) : scene{_scene} {
+        auto &registry = scene.registry;
+        registry.on_construct<ScriptComponent>().connect<&ScriptScheduler::on_scripts_changed>(*this);
+        registry.on_update<ScriptComponent>().connect<&ScriptScheduler::on_scripts_changed>(*this);
+        registry.on_destroy<ScriptComponent>().connect<&ScriptScheduler::on_scripts_changed>(*this);
+    }
+
+    ScriptScheduler::~ScriptScheduler() {
+        auto &registry = scene.registry;
+        registry.on_construct<ScriptComponent>().disconnect<&ScriptScheduler::on_scripts_changed>(*this);
+        registry.on_update<ScriptComponent>().disconnect<&ScriptScheduler::on_scripts_changed>(*this);
+        registry.on_destroy<ScriptComponent>().disconnect<&ScriptScheduler::on_scripts_changed>(*this);
+    }
+
+    void ScriptScheduler::on_scripts_changed(entt::registry &, entt::entity) {
+        is_dirty = true;
+    }
+
+    void ScriptScheduler::rebuild() {
+        std::vector<TypeGroup> groups;
+        std::unordered_map<std::type_index, usize> group_indices;
+
+        scene.view<ScriptComponent>().each([&](auto, ScriptComponent &sc) {
+            if (!sc.script) {
+                return;
+            }
+
+            const std::type_index type = typeid(*sc.script);
+            auto it = group_indices.find(type);
+            if (it == group_indices.end()) {
+                // the access is declared per type, the first instance speaks for all of them
+                ScriptAccess access;
+                sc.script->declare_access(access);
+                it = group_indices.emplace(type, groups.size()).first;
+                groups.push_back({access, {}});
+            }
+            groups[it->second].scripts.push_back(sc.script.get());
+        });
+
+        // first fit, a type joins the earliest phase it doesn't conflict with
+        struct PhaseGroups {
+            std::vector<usize> groups;
+            bool is_parallel;
+        };
+        std::vector<PhaseGroups> phase_groups;
+        for (usize g = 0; g < groups.size(); g++) {
+            const ScriptAccess &access = groups[g].access;
+            if (access.conflicts_with_itself()) {
+                phase_groups.push_back({{g}, false});
+                continue;
+            }
+
+            bool placed = false;
+            for (auto &phase : phase_groups) {
+                if (!phase.is_parallel) {
+                    continue;
+                }
+
+                bool fits = true;
+                for (usize other : phase.groups) {
+                    if (access.conflicts_with(groups[other].access)) {
+                        fits = false;
+                        break;
+                    }
+                }
+                if (fits) {
+                    phase.groups.push_back(g);
+                    placed = true;
+                    break;
+                }
+            }
+            if (!placed) {
+                phase_groups.push_back({{g}, true});
+            }
+        }
+
+        scripts.clear();
+        phases.clear();
+        for (const auto &phase : phase_groups) {
+            const u32 begin = static_cast<u32>(scripts.size());
+            for (usize g : phase.groups) {
+                scripts.insert(scripts.end(), groups[g].scripts.begin(), groups[g].scripts.end());
+            }
+            phases.push_back({begin, static_cast<u32>(scripts.size()), phase.is_parallel});
+        }
+    }
+
+    void ScriptScheduler::update(const f32 &delta_time) {
+        if (is_dirty) {
+            rebuild();
+            is_dirty = false;
+        }
+
+        CommandBuffer &commands = scene.get_commands();
+        commands.set_lane_count(JobSystem::get_thread_count());
+
+        for (const Phase &phase : phases) {
+            // the position in scripts orders the commands, the same as running everything serially
+            auto run = [&](u32 begin, u32 end, u32 thread_index) {
+                for (u32 i = phase.begin + begin; i < phase.begin + end; i++) {
+                    CommandBuffer::begin_recording(thread_index, i);
+                    scripts[i]->update(delta_time);
+                }
+                CommandBuffer::end_recording();
+            };
+
+            const u32 count = phase.end - phase.begin;
+            if (phase.is_parallel) {
+                JobSystem::parallel_for(count, 0, run);
+            } else {
+                run(0, count, 0);
+            }
+        }
+    }
+}
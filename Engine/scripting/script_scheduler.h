@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../core/types.h"
+#include "script_access.h"
+
+#include <entt/entt.hpp>
+
+#include <vector>
+
+namespace Engine {
+    class Scene;
+    class NativeScript;
+
+    // Runs the update() of every ScriptComponent. Scripts are grouped by their concrete type, the
+    // groups are packed into phases of types whose declared access doesn't overlap and each phase is
+    // split across the JobSystem. Phases run one after another, in the order the types first show
+    // up. A type whose instances conflict with each other gets a phase of its own and runs serially.
+    // The schedule is rebuilt when a ScriptComponent is added, replaced or removed.
+    class ScriptScheduler {
+    public:
+        explicit ScriptScheduler(Scene &_scene);
+        ~ScriptScheduler();
+
+        ScriptScheduler(const ScriptScheduler &) = delete;
+        ScriptScheduler &operator=(const ScriptScheduler &) = delete;
+
+        void update(const f32 &delta_time);
+
+    private:
+        struct TypeGroup {
+            ScriptAccess access;
+            std::vector<NativeScript *> scripts;
+        };
+
+        struct Phase {
+            u32 begin, end; // range in scripts
+            bool is_parallel;
+        };
+
+        void rebuild();
+        void on_scripts_changed(entt::registry &registry, entt::entity entity);
+
+        Scene &scene;
+        bool is_dirty = true;
+
+        std::vector<NativeScript *> scripts; // grouped by type and sorted by phase
+        std::vector<Phase> phases;
+    };
+}
@@ -4,8 +4,7 @@
 
 namespace Engine {
     struct PushConstantData {
-        glm::mat4 model_matrix{1.0f};
-        glm::mat4 normal_matrix{1.0f};
+        u32 transform_index = 0; // into the TransformBuffer
     };
 
     DeferredRenderingSystem::DeferredRenderingSystem(std::shared_ptr<Device> _device, i32 _width, i32 _height) : device{_device}, width{_width}, height{_height} {
@@ -356,31 +355,24 @@ namespace Engine {
     void DeferredRenderingSystem::start(FrameInfo &frame_info, const std::shared_ptr<Scene> &scene) {
         renderpass->start(framebuffer, frame_info.command_buffer);
 
+        auto models = scene->group<ModelComponent>(entt::get<TransformComponent>);
+
         // deferred pass
         deferred_pipeline->bind(frame_info.command_buffer);
-        scene->registry.each([&](auto entityID) {
-            Entity entity = {entityID, scene.get()};
-            if (!entity)
+        models.each([&](auto, ModelComponent &model_component, TransformComponent &) {
+            if (model_component.transparent) {
                 return;
+            }
 
-            if (entity.has_component<ModelComponent>()) {
-                if(entity.get_component<ModelComponent>().transparent) {
-                    return;
-                }
-
-                auto transform_component = entity.get_component<TransformComponent>();
-
-                PushConstantData push = {
-                        .model_matrix = transform_component.calculate_matrix(),
-                        .normal_matrix = transform_component.calculate_normal_matrix()
-                };
+            PushConstantData push = {
+                    .transform_index = model_component.transform_index
+            };
 
-                vkCmdPushConstants(frame_info.command_buffer, vk_deferred_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData), &push);
+            vkCmdPushConstants(frame_info.command_buffer, vk_deferred_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData), &push);
 
-                auto model = entity.get_component<ModelComponent>().model;
-                model->bind(frame_info.command_buffer);
-                model->draw(frame_info, vk_deferred_pipeline_layout);
-            }
+            auto& model = model_component.model;
+            model->bind(frame_info.command_buffer);
+            model->draw(frame_info, vk_deferred_pipeline_layout);
         });
 
         // composition
@@ -394,29 +386,20 @@ namespace Engine {
         // forward pass
         renderpass->next_subpass(frame_info.command_buffer);
         forward_pass_pipeline->bind(frame_info.command_buffer);
-        scene->registry.each([&](auto entityID) {
-            Entity entity = {entityID, scene.get()};
-            if (!entity)
+        models.each([&](auto, ModelComponent &model_component, TransformComponent &) {
+            if (!model_component.transparent) {
                 return;
+            }
 
-            if (entity.has_component<ModelComponent>()) {
-                if(!entity.get_component<ModelComponent>().transparent) {
-                    return;
-                }
-
-                auto transform_component = entity.get_component<TransformComponent>();
-
-                PushConstantData push = {
-                        .model_matrix = transform_component.calculate_matrix(),
-                        .normal_matrix = transform_component.calculate_normal_matrix()
-                };
+            PushConstantData push = {
+                    .transform_index = model_component.transform_index
+            };
 
-                vkCmdPushConstants(frame_info.command_buffer, vk_forward_pass_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData), &push);
+            vkCmdPushConstants(frame_info.command_buffer, vk_forward_pass_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData), &push);
 
-                auto model = entity.get_component<ModelComponent>().model;
-                model->bind(frame_info.command_buffer);
-                model->draw(frame_info, vk_forward_pass_pipeline_layout);
-            }
+            auto& model = model_component.model;
+            model->bind(frame_info.command_buffer);
+            model->draw(frame_info, vk_forward_pass_pipeline_layout);
         });
     }
 
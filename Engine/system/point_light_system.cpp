@@ -65,22 +65,14 @@ namespace Engine {
 
         vkCmdBindDescriptorSets(frame_info.command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_pipeline_layout, 0, 1, &frame_info.vk_global_descriptor_set, 0, nullptr);
 
-        scene->registry.each([&](auto entityID) {
-            Entity entity = {entityID, scene.get()};
-            if (!entity)
-                return;
-
-            if (entity.has_component<PointLightComponent>()) {
-                auto transform_component = entity.get_component<TransformComponent>();
-
-                PushConstantData push = {
-                        .position = glm::vec4(transform_component.translation, 1.0),
-                        .color = glm::vec4(entity.get_component<PointLightComponent>().color, 1.0)
-                };
-
-                vkCmdPushConstants(frame_info.command_buffer, vk_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData), &push);
-                vkCmdDraw(frame_info.command_buffer, 6, 1, 0, 0);
-            }
+        scene->group<PointLightComponent>(entt::get<TransformComponent>).each([&](auto, PointLightComponent &light, TransformComponent &transform_component) {
+            PushConstantData push = {
+                    .position = glm::vec4(transform_component.translation, 1.0),
+                    .color = glm::vec4(light.color, 1.0)
+            };
+
+            vkCmdPushConstants(frame_info.command_buffer, vk_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData), &push);
+            vkCmdDraw(frame_info.command_buffer, 6, 1, 0, 0);
         });
     }
 }
\ No newline at end of file
@@ -5,8 +5,7 @@
 
 namespace Engine {
     struct PushConstantData {
-        glm::mat4 model_matrix{1.0f};
-        glm::mat4 normal_matrix{1.0f};
+        u32 transform_index = 0; // into the TransformBuffer
     };
 
     ShadowSystem::ShadowSystem(std::shared_ptr<Device> _device) : device{std::move(_device)} {
@@ -68,25 +67,16 @@ namespace Engine {
         vkCmdSetDepthBias(frame_info.command_buffer, 1.25f, 0.0f, 1.75f);
 
         pipeline->bind(frame_info.command_buffer);
-        scene->registry.each([&](auto entityID) {
-            Entity entity = {entityID, scene.get()};
-            if (!entity)
-                return;
+        scene->group<ModelComponent>(entt::get<TransformComponent>).each([&](auto, ModelComponent &model_component, TransformComponent &) {
+            PushConstantData push = {
+                    .transform_index = model_component.transform_index
+            };
 
-            if (entity.has_component<ModelComponent>()) {
-                auto transform_component = entity.get_component<TransformComponent>();
+            vkCmdPushConstants(frame_info.command_buffer, vk_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData), &push);
 
-                PushConstantData push = {
-                        .model_matrix = transform_component.calculate_matrix(),
-                        .normal_matrix = transform_component.calculate_normal_matrix()
-                };
-
-                vkCmdPushConstants(frame_info.command_buffer, vk_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData), &push);
-
-                auto model = entity.get_component<ModelComponent>().model;
-                model->bind(frame_info.command_buffer);
-                model->draw(frame_info, vk_pipeline_layout);
-            }
+            auto& model = model_component.model;
+            model->bind(frame_info.command_buffer);
+            model->draw(frame_info, vk_pipeline_layout);
         });
 
         renderpass->end(frame_info.command_buffer);
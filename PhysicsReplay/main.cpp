@@ -0,0 +1,163 @@
+// Runs a recording made with PhysicsSystem::start_recording without a window and reports how long
+// the steps took and a checksum of the final state. Two runs of the same recording on the same
+// backend have to end up with the same checksum, whatever the thread count.
+//
+// PhysicsReplay <recording> [--backend builtin|jolt] [--threads N] [--expect CHECKSUM]
+
+#include "../Engine/core/job_system.h"
+#include "../Engine/physics/builtin_physics_backend.h"
+#include "../Engine/physics/jolt_physics_backend.h"
+#include "../Engine/physics/physics_recording.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+    struct Options {
+        std::string path;
+        std::string backend = "builtin";
+        u32 thread_count = 0; // 0 uses every hardware thread
+        bool has_expected_checksum = false;
+        u64 expected_checksum = 0;
+    };
+
+    Options parse_options(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (argument == "--backend" && has_value) {
+                options.backend = argv[++i];
+            } else if (argument == "--threads" && has_value) {
+                options.thread_count = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--expect" && has_value) {
+                options.has_expected_checksum = true;
+                options.expected_checksum = std::strtoull(argv[++i], nullptr, 16);
+            } else if (options.path.empty() && argument.rfind("--", 0) != 0) {
+                options.path = argument;
+            } else {
+                throw std::runtime_error("unknown argument: " + argument);
+            }
+        }
+
+        if (options.path.empty()) {
+            throw std::runtime_error("usage: PhysicsReplay <recording> [--backend builtin|jolt] [--threads N] [--expect CHECKSUM]");
+        }
+        return options;
+    }
+
+    std::unique_ptr<PhysicsBackend> create_backend(const std::string &name) {
+        if (name == "builtin") {
+            return std::make_unique<BuiltinPhysicsBackend>();
+        }
+#ifdef STELLAR_ENABLE_JOLT
+        if (name == "jolt") {
+            return std::make_unique<JoltPhysicsBackend>();
+        }
+#endif
+        throw std::runtime_error("unknown physics backend: " + name);
+    }
+
+    void print_timings(std::vector<f64> step_times) {
+        if (step_times.empty()) {
+            return;
+        }
+
+        std::sort(step_times.begin(), step_times.end());
+        auto percentile = [&](f64 p) { return step_times[static_cast<usize>(p * static_cast<f64>(step_times.size() - 1))]; };
+
+        f64 total = 0.0;
+        for (f64 time : step_times) {
+            total += time;
+        }
+
+        std::printf("step time (us): min %.1f  median %.1f  p95 %.1f  p99 %.1f  max %.1f  total %.3f ms\n",
+                    step_times.front(), percentile(0.5), percentile(0.95), percentile(0.99), step_times.back(), total / 1000.0);
+
+        // power of two buckets, < 2 us, < 4 us, ...
+        std::vector<u32> buckets;
+        for (f64 time : step_times) {
+            usize bucket = 0;
+            while (time >= static_cast<f64>(2ull << bucket)) {
+                bucket++;
+            }
+            if (bucket >= buckets.size()) {
+                buckets.resize(bucket + 1, 0);
+            }
+            buckets[bucket]++;
+        }
+
+        const u32 max_count = *std::max_element(buckets.begin(), buckets.end());
+        usize first_bucket = 0;
+        while (buckets[first_bucket] == 0) {
+            first_bucket++;
+        }
+
+        for (usize bucket = first_bucket; bucket < buckets.size(); bucket++) {
+            const u32 width = static_cast<u32>(50ull * buckets[bucket] / max_count);
+            std::printf("< %8llu us %8u %s\n", 2ull << bucket, buckets[bucket], std::string(width, '#').c_str());
+        }
+    }
+
+    int run(const Options &options) {
+        PhysicsReplay replay{options.path};
+        std::unique_ptr<PhysicsBackend> backend = create_backend(options.backend);
+
+        std::vector<f64> step_times;
+        step_times.reserve(replay.get_step_count());
+
+        f32 delta_time = 0.0f;
+        glm::vec3 gravity{0.0f};
+        while (replay.next_step(*backend, delta_time, gravity)) {
+            auto start = std::chrono::steady_clock::now();
+            backend->step(delta_time, gravity);
+            auto end = std::chrono::steady_clock::now();
+
+            step_times.push_back(std::chrono::duration<f64, std::micro>(end - start).count());
+            replay.read_back(*backend);
+        }
+
+        const u64 checksum = replay.get_checksum();
+        std::printf("%s: %u steps, %u bodies, backend %s, %u threads\n", options.path.c_str(), replay.get_step_count(),
+                    replay.get_body_count(), options.backend.c_str(), JobSystem::get_thread_count());
+        print_timings(std::move(step_times));
+        std::printf("checksum %016" PRIx64 "\n", checksum);
+
+        if (options.has_expected_checksum && checksum != options.expected_checksum) {
+            std::printf("checksum mismatch, expected %016" PRIx64 "\n", options.expected_checksum);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    int result = 0;
+
+    try {
+        Options options = parse_options(argc, argv);
+        // the calling thread takes part, a single thread needs no workers at all
+        if (options.thread_count != 1) {
+            JobSystem::init(options.thread_count > 1 ? options.thread_count - 1 : 0);
+        }
+        result = run(options);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        result = -1;
+    }
+
+    JobSystem::shutdown();
+    return result;
+}
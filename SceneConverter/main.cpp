@@ -0,0 +1,149 @@
+// Converts scenes between the YAML and the binary format, the format is picked by the extension
+// (.sscene is binary, anything else YAML). Models aren't loaded, only their paths are carried over.
+// With --repeat N the load and the save run N times on fresh scenes and the timings are reported,
+// which makes it a quick benchmark of both formats on a given scene.
+//
+// SceneConverter <input> <output> [--repeat N]
+//
+// With a .smesh output the input is a glTF that gets cooked into a mesh (see cooked_mesh.h) instead,
+// the timings then compare cooking it (parsing and writing) with loading the cooked mesh.
+
+#include "../Engine/data/scene.h"
+#include "../Engine/data/scene_serializer.h"
+#include "../Engine/graphics/cooked_mesh.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+    struct Options {
+        std::string input;
+        std::string output;
+        u32 repeat = 1;
+    };
+
+    Options parse_options(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (argument == "--repeat" && has_value) {
+                options.repeat = std::max(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+            } else if (options.input.empty() && argument.rfind("--", 0) != 0) {
+                options.input = argument;
+            } else if (options.output.empty() && argument.rfind("--", 0) != 0) {
+                options.output = argument;
+            } else {
+                throw std::runtime_error("unknown argument: " + argument);
+            }
+        }
+
+        if (options.output.empty()) {
+            throw std::runtime_error("usage: SceneConverter <input> <output> [--repeat N]");
+        }
+        return options;
+    }
+
+    bool has_extension(const std::string &path, const std::string &extension) {
+        return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+    }
+
+    bool is_binary(const std::string &path) {
+        return has_extension(path, ".sscene");
+    }
+
+    // milliseconds of the fastest and the median run
+    void print_timings(const char *name, std::vector<f64> times) {
+        std::sort(times.begin(), times.end());
+        std::printf("%-5s min %.3f ms  median %.3f ms\n", name, times.front(), times[times.size() / 2]);
+    }
+
+    int cook_mesh(const Options &options) {
+        std::vector<f64> cook_times;
+        for (u32 i = 0; i < options.repeat; i++) {
+            auto start = std::chrono::steady_clock::now();
+            Model::cook(options.input, options.output);
+            auto end = std::chrono::steady_clock::now();
+            cook_times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+
+        // the copy stands in for the one into the staging buffers, mapping alone doesn't read anything
+        std::vector<f64> load_times;
+        std::vector<u8> staging;
+        Model::Data data;
+        for (u32 i = 0; i < options.repeat; i++) {
+            auto start = std::chrono::steady_clock::now();
+            data = read_cooked_mesh(options.output);
+            const usize vertex_bytes = data.vertex_count * sizeof(Model::Vertex);
+            staging.resize(vertex_bytes + data.index_count * sizeof(u32));
+            std::memcpy(staging.data(), data.vertices, vertex_bytes);
+            std::memcpy(staging.data() + vertex_bytes, data.indices, data.index_count * sizeof(u32));
+            auto end = std::chrono::steady_clock::now();
+            load_times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+
+        std::printf("%u vertices, %u indices, %zu primitives, %s -> %s\n", data.vertex_count, data.index_count, data.primitives.size(), options.input.c_str(), options.output.c_str());
+        print_timings("cook", cook_times);
+        print_timings("smesh", load_times);
+        return 0;
+    }
+
+    int run(const Options &options) {
+        if (has_extension(options.output, ".smesh")) {
+            return cook_mesh(options);
+        }
+
+        std::vector<f64> load_times;
+        std::shared_ptr<Scene> scene;
+        for (u32 i = 0; i < options.repeat; i++) {
+            scene = std::make_shared<Scene>();
+            SceneSerializer serializer{scene};
+
+            auto start = std::chrono::steady_clock::now();
+            const bool loaded = is_binary(options.input) ? serializer.deserialize_binary(nullptr, options.input) : serializer.deserialize(nullptr, options.input);
+            auto end = std::chrono::steady_clock::now();
+            if (!loaded) {
+                throw std::runtime_error("failed to load scene: " + options.input);
+            }
+            load_times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+
+        std::vector<f64> save_times;
+        SceneSerializer serializer{scene};
+        for (u32 i = 0; i < options.repeat; i++) {
+            auto start = std::chrono::steady_clock::now();
+            if (is_binary(options.output)) {
+                serializer.serialize_binary(options.output);
+            } else {
+                serializer.serialize(options.output);
+            }
+            auto end = std::chrono::steady_clock::now();
+            save_times.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+        }
+
+        std::printf("%zu entities, %s -> %s\n", scene->view<IDComponent>().size(), options.input.c_str(), options.output.c_str());
+        print_timings("load", load_times);
+        print_timings("save", save_times);
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        return run(parse_options(argc, argv));
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+}
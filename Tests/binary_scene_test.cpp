@@ -0,0 +1,43 @@
+// The reader rejects component chunks that reference an entity twice, the loader emplaces them
+// without checking.
+
+#include "check.h"
+
+#include "../Engine/data/binary_scene.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+using namespace Engine;
+
+namespace {
+    bool can_read(const std::string &path) {
+        try {
+            BinarySceneReader reader{path};
+            return true;
+        }
+        catch (std::runtime_error &) {
+            return false;
+        }
+    }
+}
+
+int main() {
+    const std::string path = "binary_scene_test.sscene";
+
+    BinarySceneWriter writer;
+    const u32 entity = writer.add_entity(1, SceneFormat::no_parent, "entity", SceneFormat::Transform{});
+    writer.add_point_light(entity, {1.0f, 1.0f, 1.0f}, 1.0f);
+    writer.add_model(entity, "model.gltf", false);
+    writer.write(path);
+    // one entry per chunk is fine
+    CHECK(can_read(path));
+
+    writer.add_point_light(entity, {1.0f, 1.0f, 1.0f}, 1.0f);
+    writer.write(path);
+    CHECK(!can_read(path));
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,61 @@
+// A fast convex hull crossing a thin static box within one step has to be caught at the box, also
+// when it comes in at an angle over the edge of the box.
+
+#include "check.h"
+
+#include "../Engine/physics/contact.h"
+#include "../Engine/physics/intersect.h"
+#include "../Engine/physics/shapes.h"
+
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+    constexpr f32 delta_time = 1.0f / 60.0f;
+    constexpr f32 half_size = 0.5f;
+    constexpr f32 box_half_height = 0.02f;
+
+    // the hull comes down from y = 3 and would end up 3 units below the box without the contact
+    void check_caught(const Shape &hull, const Shape &box, const glm::vec3 &start, const glm::vec3 &velocity) {
+        BodyStore bodies;
+        const u32 body_A = bodies.add(static_cast<entt::entity>(0));
+        const u32 body_B = bodies.add(static_cast<entt::entity>(1));
+        bodies.shapes[body_A] = &hull;
+        bodies.shapes[body_B] = &box;
+        bodies.inverse_mass[body_A] = 1.0f;
+        bodies.reset_position(body_A, start);
+        bodies.set_velocity(body_A, velocity);
+        bodies.reset_position(body_B, glm::vec3{0.0f});
+
+        Contact contact;
+        glm::vec3 search_direction{0.0f};
+        CHECK(intersect(bodies, body_A, body_B, delta_time, contact, search_direction));
+        CHECK(contact.time_of_impact > 0.0f && contact.time_of_impact < delta_time);
+        CHECK(contact.normal.y < -0.9f);
+
+        // at the time of impact the hull rests on top of the box, not inside or below it
+        const f32 bottom = start.y + velocity.y * contact.time_of_impact - half_size;
+        CHECK(bottom > box_half_height - 0.01f && bottom < box_half_height + 0.01f);
+
+        resolve_contact(bodies, contact);
+        const glm::vec3 end = bodies.get_position(body_A) + bodies.get_velocity(body_A) * delta_time;
+        CHECK(end.y - half_size > 0.0f);
+    }
+}
+
+int main() {
+    std::vector<glm::vec3> points;
+    for (u32 i = 0; i < 8; i++) {
+        points.push_back(glm::vec3{(i & 1) ? half_size : -half_size, (i & 2) ? half_size : -half_size, (i & 4) ? half_size : -half_size});
+    }
+
+    const Convex hull{points};
+    const Box box{glm::vec3{4.0f, box_half_height, 4.0f}};
+
+    check_caught(hull, box, glm::vec3{0.0f, 3.0f, 0.0f}, glm::vec3{0.0f, -360.0f, 0.0f});
+    // the closest points start out between corners, the triangle GJK ends on is degenerate
+    check_caught(hull, box, glm::vec3{-4.5f, 3.0f, 0.0f}, glm::vec3{60.0f, -360.0f, 0.0f});
+
+    return 0;
+}
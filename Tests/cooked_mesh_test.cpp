@@ -0,0 +1,66 @@
+// Cooked meshes round trip, and an index past the vertices of its primitive is rejected on load.
+
+#include "check.h"
+
+#include "../Engine/graphics/cooked_mesh.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+    bool can_read(const std::string &path) {
+        try {
+            read_cooked_mesh(path);
+            return true;
+        }
+        catch (std::runtime_error &) {
+            return false;
+        }
+    }
+}
+
+int main() {
+    const std::string path = "cooked_mesh_test.smesh";
+
+    // two primitives of three vertices, the indices of each start at 0
+    std::vector<Model::Vertex> vertices(6);
+    for (u32 i = 0; i < 6; i++) {
+        vertices[i].position = {static_cast<f32>(i), 0.0f, 0.0f};
+    }
+    std::vector<u32> indices = {0, 1, 2, 2, 1, 0};
+
+    Model::Data data;
+    data.vertices = vertices.data();
+    data.vertex_count = static_cast<u32>(vertices.size());
+    data.indices = indices.data();
+    data.index_count = static_cast<u32>(indices.size());
+    data.bounds = AABB{{0.0f, 0.0f, 0.0f}, {5.0f, 0.0f, 0.0f}};
+
+    Model::Data::Primitive primitive{};
+    primitive.indexCount = 3;
+    primitive.vertexCount = 3;
+    data.primitives.push_back(primitive);
+    primitive.firstIndex = 3;
+    primitive.firstVertex = 3;
+    data.primitives.push_back(primitive);
+
+    write_cooked_mesh(path, data, MeshFormat::Source{1, 1});
+    {
+        // keeps the file mapped, it can't be replaced on every platform until this is gone
+        const Model::Data cooked = read_cooked_mesh(path);
+        CHECK(cooked.vertex_count == 6 && cooked.index_count == 6 && cooked.primitives.size() == 2);
+        CHECK(cooked.vertices[5].position.x == 5.0f && cooked.indices[3] == 2);
+    }
+
+    // in range of the whole mesh, but not of the second primitive
+    indices[4] = 3;
+    write_cooked_mesh(path, data, MeshFormat::Source{1, 1});
+    CHECK(!can_read(path));
+
+    std::remove(path.c_str());
+    return 0;
+}
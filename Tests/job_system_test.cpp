@@ -0,0 +1,57 @@
+// A parallel_for batch owns its thread index until it returns, also when it waits on jobs or runs
+// a parallel_for of its own in the meantime.
+
+#include "check.h"
+
+#include "../Engine/core/job_system.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+    constexpr u32 count = 2000;
+    constexpr u32 grain = 4;
+    constexpr u32 jobs_per_batch = 3;
+    constexpr u32 nested_count = 16;
+
+    for (u32 round = 0; round < 20; round++) {
+        JobSystem::init(3);
+
+        // how many batches are using each thread index right now
+        std::vector<std::atomic<u32>> users(JobSystem::get_thread_count());
+        std::atomic<u32> shared_indices{0};
+        std::atomic<u32> nested_elements{0};
+        std::atomic<u32> finished_jobs{0};
+
+        JobSystem::parallel_for(count, grain, [&](u32, u32, u32 thread_index) {
+            if (users[thread_index].fetch_add(1) != 0) {
+                shared_indices++;
+            }
+
+            JobCounter counter;
+            for (u32 i = 0; i < jobs_per_batch; i++) {
+                JobSystem::run(counter, [&](u32) { finished_jobs++; });
+            }
+            JobSystem::wait(counter);
+
+            JobSystem::parallel_for(nested_count, 2, [&](u32 begin, u32 end, u32 nested_thread_index) {
+                if (nested_thread_index != thread_index) {
+                    shared_indices++;
+                }
+                nested_elements += end - begin;
+            });
+
+            users[thread_index]--;
+        });
+
+        JobSystem::shutdown();
+
+        CHECK(shared_indices == 0);
+        CHECK(finished_jobs == count / grain * jobs_per_batch);
+        CHECK(nested_elements == count / grain * nested_count);
+    }
+
+    return 0;
+}
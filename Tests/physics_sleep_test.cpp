@@ -0,0 +1,93 @@
+// A body that falls asleep is reported once more at the pose it sleeps at, then no longer. Moving the
+// static body it sleeps on wakes it up again.
+
+#include "check.h"
+
+#include "../Engine/data/components.h"
+#include "../Engine/physics/builtin_physics_backend.h"
+#include "../Engine/physics/shapes.h"
+
+#include <memory>
+
+using namespace Engine;
+
+int main() {
+    BuiltinPhysicsBackend backend;
+
+    const auto entity = static_cast<entt::entity>(0);
+    TransformComponent tn;
+    PhysicsComponent ph;
+    ph.shape = std::make_shared<Sphere>(1.0f);
+    ph.inverse_mass = 1.0f;
+    ph.linear_velocity = {0.5f * backend.sleep_velocity_threshold, 0.0f, 0.0f}; // slow enough to fall asleep
+
+    backend.add_body(entity);
+    backend.sync_body(entity, tn, ph, true);
+
+    const f32 delta_time = 1.0f / 60.0f;
+    const u32 step_count = static_cast<u32>(2.0f * backend.time_to_sleep / delta_time);
+
+    u32 reports = 0;
+    glm::vec3 previous_position{0.0f};
+    glm::vec3 position{0.0f};
+    glm::vec3 velocity{0.0f};
+    for (u32 step = 0; step < step_count; step++) {
+        backend.step(delta_time, glm::vec3{0.0f});
+        backend.read_back([&](entt::entity, const glm::vec3 &_previous_position, const glm::vec3 &_position, const glm::vec3 &_velocity) {
+            reports++;
+            previous_position = _previous_position;
+            position = _position;
+            velocity = _velocity;
+        });
+    }
+
+    // asleep long before the last step, the last report is the resting one
+    CHECK(reports > 0 && reports < step_count);
+    CHECK(previous_position == position);
+    CHECK(velocity == glm::vec3{0.0f});
+    CHECK(position.x > 0.0f);
+
+    // a sphere comes to rest on a static box, then the box is moved away from under it
+    BuiltinPhysicsBackend resting_backend;
+    const auto sphere = static_cast<entt::entity>(0);
+    const auto ground = static_cast<entt::entity>(1);
+
+    TransformComponent sphere_tn;
+    sphere_tn.translation = {0.0f, 1.0f, 0.0f};
+    PhysicsComponent sphere_ph;
+    sphere_ph.shape = std::make_shared<Sphere>(1.0f);
+    sphere_ph.inverse_mass = 1.0f;
+
+    TransformComponent ground_tn;
+    ground_tn.translation = {0.0f, -0.5f, 0.0f};
+    PhysicsComponent ground_ph;
+    ground_ph.shape = std::make_shared<Box>(glm::vec3{5.0f, 0.5f, 5.0f});
+
+    resting_backend.add_body(sphere);
+    resting_backend.sync_body(sphere, sphere_tn, sphere_ph, true);
+    resting_backend.add_body(ground);
+    resting_backend.sync_body(ground, ground_tn, ground_ph, true);
+
+    const glm::vec3 gravity{0.0f, -10.0f, 0.0f};
+    bool is_asleep = false;
+    for (u32 step = 0; step < 10 * step_count && !is_asleep; step++) {
+        resting_backend.step(delta_time, gravity);
+        is_asleep = true;
+        resting_backend.read_back([&](entt::entity, const glm::vec3 &_previous_position, const glm::vec3 &_position, const glm::vec3 &) {
+            is_asleep = is_asleep && _previous_position == _position;
+        });
+    }
+    CHECK(is_asleep);
+
+    ground_tn.translation = {0.0f, -10.0f, 0.0f};
+    resting_backend.sync_body(ground, ground_tn, ground_ph, true);
+    resting_backend.step(delta_time, gravity);
+
+    bool is_falling = false;
+    resting_backend.read_back([&](entt::entity entity, const glm::vec3 &, const glm::vec3 &, const glm::vec3 &_velocity) {
+        is_falling = is_falling || (entity == sphere && _velocity.y < 0.0f);
+    });
+    CHECK(is_falling);
+
+    return 0;
+}
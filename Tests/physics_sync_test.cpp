@@ -0,0 +1,42 @@
+// A transform written between two physics updates reloads the body, even after update_transforms
+// cleared TransformComponent::is_dirty.
+
+#include "check.h"
+
+#include "../Engine/data/components.h"
+#include "../Engine/data/entity.h"
+#include "../Engine/data/scene.h"
+#include "../Engine/physics/physics_system.h"
+#include "../Engine/physics/shapes.h"
+
+#include <memory>
+
+using namespace Engine;
+
+int main() {
+    auto scene = std::make_shared<Scene>();
+
+    Entity ball = scene->create_entity("ball");
+    auto &ph = ball.add_component<PhysicsComponent>();
+    ph.shape = std::make_shared<Sphere>(1.0f);
+    ph.inverse_mass = 1.0f;
+
+    PhysicsSystem physics{scene};
+    const f32 step = physics.fixed_time_step;
+
+    physics.update(step);
+    scene->update_transforms();
+
+    // what a script does after physics ran, update_transforms clears is_dirty before the next sync
+    ball.get_component<TransformComponent>().set_translation({0.0f, 100.0f, 0.0f});
+    scene->update_transforms();
+
+    physics.update(step);
+
+    const auto &tn = ball.get_component<TransformComponent>();
+    CHECK(tn.translation.y > 99.0f && tn.translation.y <= 100.0f);
+    // the interpolated position can still be the teleport target, the velocity is written back anyway
+    CHECK(ball.get_component<PhysicsComponent>().linear_velocity.y < 0.0f);
+
+    return 0;
+}
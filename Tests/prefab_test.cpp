@@ -0,0 +1,92 @@
+// Instantiating a prefab N times creates N copies of every node with their own UUIDs, the copies
+// share the shape of the prefab and are linked like the prefab nodes. The nodes go without a model,
+// a Model needs the device.
+
+#include "check.h"
+
+#include "../Engine/data/components.h"
+#include "../Engine/data/entity.h"
+#include "../Engine/data/prefab.h"
+#include "../Engine/data/scene.h"
+#include "../Engine/physics/shapes.h"
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+    auto shape = std::make_shared<Sphere>(1.0f);
+
+    // root (shape)
+    //   arm (shape)
+    //     hand
+    //   head
+    Prefab prefab;
+    prefab.nodes.resize(4);
+    prefab.nodes[0].tag = "root";
+    prefab.nodes[0].shape = shape;
+    prefab.nodes[1].tag = "arm";
+    prefab.nodes[1].parent = 0;
+    prefab.nodes[1].shape = shape;
+    prefab.nodes[2].tag = "hand";
+    prefab.nodes[2].parent = 1;
+    prefab.nodes[2].translation = {0.0f, -1.0f, 0.0f};
+    prefab.nodes[3].tag = "head";
+    prefab.nodes[3].parent = 0;
+
+    Scene scene;
+    Entity parent = scene.create_entity("parent");
+
+    constexpr u32 count = 16;
+    std::vector<Entity> roots = scene.instantiate(prefab, count, parent);
+    CHECK(roots.size() == count);
+    CHECK(scene.view<IDComponent>().size() == 1 + count * prefab.nodes.size());
+
+    // shared, not copied, and nodes without a model don't get a ModelComponent
+    CHECK(scene.view<ModelComponent>().size() == 0);
+    CHECK(scene.view<PhysicsComponent>().size() == 2 * count);
+    for (auto [entity, ph] : scene.view<PhysicsComponent>().each()) {
+        CHECK(ph.shape == shape);
+    }
+
+    std::unordered_set<u64> uuids;
+    for (auto [entity, id] : scene.view<IDComponent>().each()) {
+        CHECK(uuids.insert(id.ID).second);
+        CHECK(scene.find_entity(id.ID) == Entity(entity, &scene));
+    }
+
+    // every root hangs off parent
+    auto get_tag = [&](entt::entity entity) { return Entity{entity, &scene}.get_component<TagComponent>().tag; };
+    auto get_links = [&](entt::entity entity) { return Entity{entity, &scene}.get_component<RelationshipComponent>(); };
+
+    u32 parent_children = 0;
+    for (entt::entity child = get_links(parent).first_child; child != entt::null; child = get_links(child).next_sibling) {
+        parent_children++;
+    }
+    CHECK(parent_children == count);
+
+    for (Entity root : roots) {
+        const RelationshipComponent root_rc = get_links(root);
+        CHECK(get_tag(root) == "root");
+        CHECK(root_rc.parent == parent.get_handle() && root_rc.depth == 1);
+
+        // the children of a copy are in prefab order
+        const entt::entity arm = root_rc.first_child;
+        CHECK(arm != entt::null && get_tag(arm) == "arm");
+        const entt::entity head = get_links(arm).next_sibling;
+        CHECK(head != entt::null && get_tag(head) == "head");
+        CHECK(get_links(head).next_sibling == entt::null && get_links(head).prev_sibling == arm);
+
+        const entt::entity hand = get_links(arm).first_child;
+        CHECK(hand != entt::null && get_tag(hand) == "hand");
+        CHECK(Entity(hand, &scene).get_component<TransformComponent>().translation == glm::vec3(0.0f, -1.0f, 0.0f));
+        CHECK(get_links(hand).next_sibling == entt::null && get_links(hand).first_child == entt::null);
+
+        CHECK(get_links(arm).parent == root.get_handle() && get_links(head).parent == root.get_handle() && get_links(hand).parent == arm);
+        CHECK(get_links(arm).depth == 2 && get_links(head).depth == 2 && get_links(hand).depth == 3);
+    }
+
+    return 0;
+}
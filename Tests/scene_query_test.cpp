@@ -0,0 +1,54 @@
+// A child is indexed at its world pose and follows its parent without being dirty itself.
+
+#include "check.h"
+
+#include "../Engine/data/components.h"
+#include "../Engine/data/entity.h"
+#include "../Engine/data/scene.h"
+#include "../Engine/data/scene_query.h"
+#include "../Engine/physics/shapes.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace Engine;
+
+namespace {
+    Ray forward_ray(const glm::vec3 &origin) {
+        Ray ray{};
+        ray.origin = origin;
+        ray.direction = {0.0f, 0.0f, 1.0f};
+        return ray;
+    }
+}
+
+int main() {
+    Scene scene;
+
+    Entity parent = scene.create_entity("parent");
+    parent.get_component<TransformComponent>().set_translation({10.0f, 0.0f, 0.0f});
+
+    Entity child = scene.create_entity("child");
+    scene.set_parent(child, parent);
+    child.get_component<TransformComponent>().set_translation({0.0f, 5.0f, 0.0f});
+    child.add_component<PhysicsComponent>().shape = std::make_shared<Sphere>(1.0f);
+
+    scene.update_transforms();
+
+    QueryHit hit{};
+    CHECK(scene.get_query().raycast(forward_ray({10.0f, 5.0f, -10.0f}), hit));
+    CHECK(hit.entity == child.get_handle());
+    CHECK(std::abs(hit.distance - 9.0f) < 1e-3f);
+    // the local translation alone isn't where the child is
+    CHECK(!scene.get_query().raycast(forward_ray({0.0f, 5.0f, -10.0f}), hit));
+
+    // only the parent is dirty, the child is refit because its world matrix changed
+    parent.get_component<TransformComponent>().set_translation({20.0f, 0.0f, 0.0f});
+    scene.update_transforms();
+
+    CHECK(scene.get_query().raycast(forward_ray({20.0f, 5.0f, -10.0f}), hit));
+    CHECK(hit.entity == child.get_handle());
+    CHECK(!scene.get_query().raycast(forward_ray({10.0f, 5.0f, -10.0f}), hit));
+
+    return 0;
+}
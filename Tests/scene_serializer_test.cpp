@@ -0,0 +1,35 @@
+// A scene file with two entities sharing a UUID fails to load instead of throwing.
+
+#include "check.h"
+
+#include "../Engine/data/scene.h"
+#include "../Engine/data/scene_serializer.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+using namespace Engine;
+
+int main() {
+    const std::string path = "duplicate_uuid_test.scene";
+    {
+        std::ofstream file{path};
+        file << "Scene: Untitled\n"
+                "Entities:\n"
+                "  - Entity: 42\n"
+                "    TagComponent:\n"
+                "      Tag: first\n"
+                "  - Entity: 42\n"
+                "    TagComponent:\n"
+                "      Tag: second\n";
+    }
+
+    auto scene = std::make_shared<Scene>();
+    SceneSerializer serializer{scene};
+    CHECK(!serializer.deserialize(nullptr, path));
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -16,6 +16,11 @@ struct DirectionalLight {
     vec4 position;
 };
 
+struct Transform {
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+};
+
 //////////////////////////////////// FUNCTIONS //////////////////////////////////////
 
 float vignatte(vec2 uv) {
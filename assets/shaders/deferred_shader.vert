@@ -25,20 +25,24 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
 
 layout(set = 0, binding = 1) uniform sampler2D albedo;
 
+layout(std430, set = 0, binding = 5) readonly buffer Transforms {
+    Transform transforms[];
+};
+
 layout(push_constant) uniform Push {
-    mat4 modelMatrix;
-    mat4 normalMatrix;
+    uint transformIndex;
 } push;
 
 void main() {
-    vec4 positionWorld = push.modelMatrix * vec4(position, 1.0);
+    Transform transform = transforms[push.transformIndex];
+    vec4 positionWorld = transform.modelMatrix * vec4(position, 1.0);
     mat4 projectionViewMatrix = ubo.projectionMatrix * ubo.viewMatrix;
     gl_Position = projectionViewMatrix * positionWorld;
 
     fragUV = uv;
     fragPosWorld = positionWorld.xyz;
-    vec4 tangents = normalize(push.modelMatrix * tangent.xyzw);
-    vec3 N = normalize(mat3(push.modelMatrix) * normal);
+    vec4 tangents = normalize(transform.modelMatrix * tangent.xyzw);
+    vec3 N = normalize(mat3(transform.normalMatrix) * normal);
     vec3 T = normalize(tangents.xyz);
     vec3 B = cross(N, tangents.xyz) * tangents.w;
     TBN = mat3(T, B, N);
@@ -27,9 +27,17 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
     int numDirectionalLights;
 } ubo;
 
-layout(push_constant) uniform Push {
+struct Transform {
     mat4 modelMatrix;
     mat4 normalMatrix;
+};
+
+layout(std430, set = 0, binding = 5) readonly buffer Transforms {
+    Transform transforms[];
+};
+
+layout(push_constant) uniform Push {
+    uint transformIndex;
 } push;
 
 out gl_PerVertex
@@ -38,5 +46,5 @@ out gl_PerVertex
 };
 
 void main() {
-    gl_Position = ubo.directionalLights[0].mvp * push.modelMatrix * vec4(position, 1.0);
+    gl_Position = ubo.directionalLights[0].mvp * transforms[push.transformIndex].modelMatrix * vec4(position, 1.0);
 }
\ No newline at end of file
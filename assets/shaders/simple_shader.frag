@@ -45,11 +45,6 @@ layout(set = 1, binding = 5) uniform PBRParameters {
 } pbr_parameters;
 //layout(set = 2, binding = 0) uniform sampler2D shadowMap;
 
-layout(push_constant) uniform Push {
-  mat4 modelMatrix;
-  mat4 normalMatrix;
-} push;
-
 layout (location = 0) out vec4 outColor;
 
 const float PI = 3.14159265359;